@@ -136,6 +136,7 @@ sr_subscr_change_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_sess
         mem[3] = strdup(xpath);
         SR_CHECK_MEM_RET(!mem[3], err_info);
         change_sub->subs[change_sub->sub_count].xpath = mem[3];
+        sr_xpath_snodes_update(subscr->conn, xpath, &change_sub->subs[change_sub->sub_count].xpath_snodes);
     }
     change_sub->subs[change_sub->sub_count].priority = priority;
     change_sub->subs[change_sub->sub_count].opts = sub_opts;
@@ -191,6 +192,7 @@ sr_subscr_change_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock
 
             /* found our subscription, replace it with the last */
             free(change_sub->subs[j].xpath);
+            sr_xpath_snodes_free(&change_sub->subs[j].xpath_snodes);
             if (j < change_sub->sub_count - 1) {
                 memcpy(&change_sub->subs[j], &change_sub->subs[change_sub->sub_count - 1], sizeof *change_sub->subs);
             }
@@ -531,12 +533,14 @@ cleanup:
 
 sr_error_info_t *
 sr_subscr_notif_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_session_ctx_t *sess, const char *mod_name,
-        const char *xpath, const struct timespec *listen_since, const struct timespec *start_time,
+        const char *xpath, int drop, const struct timespec *listen_since, const struct timespec *start_time,
         const struct timespec *stop_time, sr_event_notif_cb notif_cb, sr_event_notif_tree_cb notif_tree_cb,
-        void *private_data, sr_lock_mode_t has_subs_lock)
+        sr_event_notif_batch_cb notif_batch_cb, uint32_t batch_size, uint32_t batch_timeout_us, void *private_data,
+        sr_lock_mode_t has_subs_lock)
 {
     sr_error_info_t *err_info = NULL;
     struct modsub_notif_s *notif_sub = NULL;
+    sr_notif_sub_shm_t *notif_shm;
     uint32_t i;
     void *mem[4] = {NULL};
     int new_sub = 0;
@@ -572,6 +576,23 @@ sr_subscr_notif_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_sessi
         if ((err_info = sr_shmsub_open_map(mod_name, "notif", -1, &notif_sub->sub_shm))) {
             goto error;
         }
+        notif_shm = (sr_notif_sub_shm_t *)notif_sub->sub_shm.addr;
+
+        /* SUB READ LOCK */
+        if ((err_info = sr_rwlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, subscr->conn->cid, __func__,
+                NULL, NULL))) {
+            sr_shm_clear(&notif_sub->sub_shm);
+            goto error;
+        }
+
+        /* start processing from the oldest stored notification, only those published after the subscription
+         * started listening are processed */
+        if (notif_shm->request_id > SR_NOTIF_SUB_SLOT_COUNT) {
+            notif_sub->request_id = notif_shm->request_id - SR_NOTIF_SUB_SLOT_COUNT;
+        }
+
+        /* SUB READ UNLOCK */
+        sr_rwunlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, subscr->conn->cid, __func__);
 
         /* make the subscription visible only after everything succeeds */
         ++subscr->notif_sub_count;
@@ -594,7 +615,9 @@ sr_subscr_notif_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_sessi
         mem[3] = strdup(xpath);
         SR_CHECK_MEM_GOTO(!mem[3], err_info, error);
         notif_sub->subs[notif_sub->sub_count].xpath = mem[3];
+        sr_xpath_snodes_update(subscr->conn, xpath, &notif_sub->subs[notif_sub->sub_count].xpath_snodes);
     }
+    notif_sub->subs[notif_sub->sub_count].drop = drop;
     notif_sub->subs[notif_sub->sub_count].listen_since = *listen_since;
     if (start_time) {
         notif_sub->subs[notif_sub->sub_count].start_time = *start_time;
@@ -604,6 +627,9 @@ sr_subscr_notif_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_sessi
     }
     notif_sub->subs[notif_sub->sub_count].cb = notif_cb;
     notif_sub->subs[notif_sub->sub_count].tree_cb = notif_tree_cb;
+    notif_sub->subs[notif_sub->sub_count].batch_cb = notif_batch_cb;
+    notif_sub->subs[notif_sub->sub_count].batch_size = batch_size;
+    notif_sub->subs[notif_sub->sub_count].batch_timeout_us = batch_timeout_us;
     notif_sub->subs[notif_sub->sub_count].private_data = private_data;
     notif_sub->subs[notif_sub->sub_count].sess = sess;
 
@@ -668,8 +694,8 @@ sr_subscr_notif_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock_
             if (ev_sess) {
                 /* send special last notification */
                 sr_time_get(&cur_time, 0);
-                if ((err_info = sr_notif_call_callback(ev_sess, sub->cb, sub->tree_cb, sub->private_data,
-                        SR_EV_NOTIF_TERMINATED, sub->sub_id, NULL, &cur_time))) {
+                if ((err_info = sr_notif_call_callback(ev_sess, sub->cb, sub->tree_cb, sub->batch_cb,
+                        sub->private_data, SR_EV_NOTIF_TERMINATED, sub->sub_id, NULL, &cur_time))) {
                     sr_errinfo_free(&err_info);
                 }
             }
@@ -684,6 +710,7 @@ sr_subscr_notif_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock_
 
             /* replace the subscription with the last */
             free(sub->xpath);
+            sr_xpath_snodes_free(&sub->xpath_snodes);
             if (j < notif_sub->sub_count - 1) {
                 memcpy(sub, &notif_sub->subs[notif_sub->sub_count - 1], sizeof *notif_sub->subs);
             }
@@ -733,7 +760,7 @@ sr_subscr_rpc_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_session
 {
     sr_error_info_t *err_info = NULL;
     struct opsub_rpc_s *rpc_sub = NULL;
-    uint32_t i;
+    uint32_t i, j;
     char *mod_name;
     void *mem[4] = {NULL};
     int new_sub = 0;
@@ -758,7 +785,9 @@ sr_subscr_rpc_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_session
 
         rpc_sub = &subscr->rpc_subs[i];
         memset(rpc_sub, 0, sizeof *rpc_sub);
-        rpc_sub->sub_shm.fd = -1;
+        for (j = 0; j < SR_RPC_SUB_SLOT_COUNT; ++j) {
+            rpc_sub->sub_shm[j].fd = -1;
+        }
 
         /* set attributes */
         mem[1] = strdup(path);
@@ -769,10 +798,17 @@ sr_subscr_rpc_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_session
         /* get module name */
         mod_name = sr_get_first_ns(xpath);
 
-        /* open specific SHM and map it */
-        err_info = sr_shmsub_open_map(mod_name, "rpc", sr_str_hash(path, 0), &rpc_sub->sub_shm);
+        /* open specific SHM of every slot and map it */
+        for (j = 0; j < SR_RPC_SUB_SLOT_COUNT; ++j) {
+            if ((err_info = sr_shmsub_open_map(mod_name, "rpc", sr_str_hash(path, j), &rpc_sub->sub_shm[j]))) {
+                break;
+            }
+        }
         free(mod_name);
         if (err_info) {
+            for (j = 0; j < SR_RPC_SUB_SLOT_COUNT; ++j) {
+                sr_shm_clear(&rpc_sub->sub_shm[j]);
+            }
             goto error;
         }
 
@@ -796,6 +832,7 @@ sr_subscr_rpc_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_session
     mem[3] = strdup(xpath);
     SR_CHECK_MEM_GOTO(!mem[3], err_info, error);
     rpc_sub->subs[rpc_sub->sub_count].xpath = mem[3];
+    sr_xpath_snodes_update(subscr->conn, xpath, &rpc_sub->subs[rpc_sub->sub_count].xpath_snodes);
     rpc_sub->subs[rpc_sub->sub_count].priority = priority;
     rpc_sub->subs[rpc_sub->sub_count].cb = rpc_cb;
     rpc_sub->subs[rpc_sub->sub_count].tree_cb = rpc_tree_cb;
@@ -815,7 +852,9 @@ error:
     }
     if (new_sub) {
         --subscr->rpc_sub_count;
-        sr_shm_clear(&rpc_sub->sub_shm);
+        for (j = 0; j < SR_RPC_SUB_SLOT_COUNT; ++j) {
+            sr_shm_clear(&rpc_sub->sub_shm[j]);
+        }
     }
     return err_info;
 }
@@ -824,7 +863,7 @@ void
 sr_subscr_rpc_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock_mode_t has_subs_lock)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i, j;
+    uint32_t i, j, k;
     struct opsub_rpc_s *rpc_sub;
 
     assert((has_subs_lock == SR_LOCK_READ_UPGR) || (has_subs_lock == SR_LOCK_WRITE));
@@ -848,6 +887,7 @@ sr_subscr_rpc_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock_mo
 
             /* found our subscription, replace it with the last */
             free(rpc_sub->subs[j].xpath);
+            sr_xpath_snodes_free(&rpc_sub->subs[j].xpath_snodes);
             if (j < rpc_sub->sub_count - 1) {
                 memcpy(&rpc_sub->subs[j], &rpc_sub->subs[rpc_sub->sub_count - 1], sizeof *rpc_sub->subs);
             }
@@ -856,7 +896,9 @@ sr_subscr_rpc_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock_mo
             if (!rpc_sub->sub_count) {
                 /* no other subscriptions for this RPC/action, replace it with the last */
                 free(rpc_sub->path);
-                sr_shm_clear(&rpc_sub->sub_shm);
+                for (k = 0; k < SR_RPC_SUB_SLOT_COUNT; ++k) {
+                    sr_shm_clear(&rpc_sub->sub_shm[k]);
+                }
                 free(rpc_sub->subs);
                 if (i < subscr->rpc_sub_count - 1) {
                     memcpy(rpc_sub, &subscr->rpc_subs[subscr->rpc_sub_count - 1], sizeof *rpc_sub);
@@ -1051,6 +1093,19 @@ sr_subscr_session_count(sr_subscription_ctx_t *subscr, sr_session_ctx_t *sess, s
         }
     }
 
+    /* APPLY LOCK */
+    pthread_mutex_lock(&subscr->apply_lock);
+
+    /* pending asynchronous apply changes requests */
+    for (i = 0; i < subscr->apply_req_count; ++i) {
+        if (subscr->apply_reqs[i].sess == sess) {
+            ++count;
+        }
+    }
+
+    /* APPLY UNLOCK */
+    pthread_mutex_unlock(&subscr->apply_lock);
+
     return count;
 }
 
@@ -1267,6 +1322,63 @@ sr_notif_sub_del(sr_subscription_ctx_t *subscr, struct modsub_notif_s *notif_sub
     return NULL;
 }
 
+/**
+ * @brief Fail and remove all the pending asynchronous apply changes requests of a session.
+ *
+ * @param[in,out] subscr Subscription structure to modify.
+ * @param[in] sess Session of the requests.
+ */
+static void
+sr_subscr_apply_req_session_del(sr_subscription_ctx_t *subscr, sr_session_ctx_t *sess)
+{
+    sr_error_info_t *err_info;
+    struct sr_apply_req_s *reqs = NULL;
+    uint32_t i, req_count = 0;
+    int rc;
+
+    /* APPLY LOCK */
+    pthread_mutex_lock(&subscr->apply_lock);
+
+    i = 0;
+    while (i < subscr->apply_req_count) {
+        if (subscr->apply_reqs[i].sess != sess) {
+            ++i;
+            continue;
+        }
+
+        /* take the request, it is only dropped without being reported if there is no memory */
+        if (!reqs) {
+            reqs = malloc(subscr->apply_req_count * sizeof *reqs);
+        }
+        if (reqs) {
+            reqs[req_count++] = subscr->apply_reqs[i];
+        }
+
+        --subscr->apply_req_count;
+        if (i < subscr->apply_req_count) {
+            memmove(&subscr->apply_reqs[i], &subscr->apply_reqs[i + 1],
+                    (subscr->apply_req_count - i) * sizeof *subscr->apply_reqs);
+        }
+    }
+    if (!subscr->apply_req_count) {
+        free(subscr->apply_reqs);
+        subscr->apply_reqs = NULL;
+    }
+
+    /* APPLY UNLOCK */
+    pthread_mutex_unlock(&subscr->apply_lock);
+
+    for (i = 0; i < req_count; ++i) {
+        err_info = NULL;
+        sr_errinfo_new(&err_info, SR_ERR_OPERATION_FAILED, "Session stopped before the changes were applied.");
+        rc = sr_api_ret(reqs[i].sess, err_info);
+
+        /* report the result */
+        reqs[i].cb(reqs[i].sess, rc, reqs[i].private_data);
+    }
+    free(reqs);
+}
+
 sr_error_info_t *
 sr_subscr_session_del(sr_subscription_ctx_t *subscr, sr_session_ctx_t *sess, sr_lock_mode_t has_subs_lock)
 {
@@ -1404,6 +1516,9 @@ sr_subscr_session_del(sr_subscription_ctx_t *subscr, sr_session_ctx_t *sess, sr_
         }
     }
 
+    /* asynchronous apply changes requests */
+    sr_subscr_apply_req_session_del(subscr, sess);
+
     /* remove ourselves from session subscriptions (needs SUBS lock to avoid removing it twice in case of reaching
      * a notification stop time) */
     if ((err_info = sr_ptr_del(&sess->ptr_lock, (void ***)&sess->subscriptions, &sess->subscription_count, subscr))) {
@@ -1419,6 +1534,48 @@ cleanup_subs_unlock:
     return err_info;
 }
 
+/**
+ * @brief Remove a subscription structure from all the sessions of its connection that still reference it.
+ *
+ * @param[in,out] subscr Subscription structure to remove, with all the subscriptions deleted.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_subscr_conn_sessions_del(sr_subscription_ctx_t *subscr)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = subscr->conn;
+    sr_session_ctx_t *sess;
+    uint32_t i, j;
+
+    /* CONN PTR LOCK */
+    if ((err_info = sr_mlock(&conn->ptr_lock, -1, __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    for (i = 0; i < conn->session_count; ++i) {
+        sess = conn->sessions[i];
+
+        /* fail any pending requests, they may not have been processed yet */
+        sr_subscr_apply_req_session_del(subscr, sess);
+
+        for (j = 0; j < sess->subscription_count; ++j) {
+            if (sess->subscriptions[j] == subscr) {
+                break;
+            }
+        }
+        if ((j < sess->subscription_count) && (err_info = sr_ptr_del(&sess->ptr_lock,
+                (void ***)&sess->subscriptions, &sess->subscription_count, subscr))) {
+            break;
+        }
+    }
+
+    /* CONN PTR UNLOCK */
+    sr_munlock(&conn->ptr_lock);
+
+    return err_info;
+}
+
 sr_error_info_t *
 sr_subscr_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock_mode_t has_subs_lock)
 {
@@ -1572,6 +1729,13 @@ subs_del:
         }
     }
 
+    if (!sub_id) {
+        /* sessions that applied changes asynchronously, with some requests still pending or not */
+        if ((err_info = sr_subscr_conn_sessions_del(subscr))) {
+            goto cleanup;
+        }
+    }
+
 finish:
     if (sub_id) {
         if (del_sub_sess) {
@@ -1643,8 +1807,9 @@ sr_notif_find_subscriber(sr_conn_ctx_t *conn, const char *mod_name, sr_mod_notif
 }
 
 sr_error_info_t *
-sr_notif_call_callback(sr_session_ctx_t *ev_sess, sr_event_notif_cb cb, sr_event_notif_tree_cb tree_cb, void *private_data,
-        const sr_ev_notif_type_t notif_type, uint32_t sub_id, const struct lyd_node *notif_op, struct timespec *notif_ts)
+sr_notif_call_callback(sr_session_ctx_t *ev_sess, sr_event_notif_cb cb, sr_event_notif_tree_cb tree_cb,
+        sr_event_notif_batch_cb batch_cb, void *private_data, const sr_ev_notif_type_t notif_type, uint32_t sub_id,
+        const struct lyd_node *notif_op, struct timespec *notif_ts)
 {
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *elem;
@@ -1652,13 +1817,20 @@ sr_notif_call_callback(sr_session_ctx_t *ev_sess, sr_event_notif_cb cb, sr_event
     char *notif_xpath = NULL;
     sr_val_t *vals = NULL;
     size_t val_count = 0;
+    sr_notif_batch_item_t item;
 
     assert(!notif_op || (notif_op->schema->nodetype == LYS_NOTIF));
-    assert((tree_cb && !cb) || (!tree_cb && cb));
+    assert((cb && !tree_cb && !batch_cb) || (!cb && tree_cb && !batch_cb) || (!cb && !tree_cb && batch_cb));
 
     if (tree_cb) {
         /* callback */
         tree_cb(ev_sess, sub_id, notif_type, notif_op, notif_ts, private_data);
+    } else if (batch_cb) {
+        /* callback with a batch of a single notification */
+        item.notif_type = notif_type;
+        item.notif = notif_op;
+        item.timestamp = *notif_ts;
+        batch_cb(ev_sess, sub_id, &item, 1, private_data);
     } else {
         if (notif_op) {
             /* prepare XPath */
@@ -1735,6 +1907,167 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Learn whether an XPath is only a union of location paths so that it selects only instances of the schema
+ * nodes it resolves to.
+ *
+ * @param[in] xpath XPath to examine.
+ * @param[out] no_pred Set if there are no predicates in the XPath.
+ * @return Whether the XPath is a location path.
+ */
+static int
+sr_xpath_is_location_path(const char *xpath, int *no_pred)
+{
+    const char *ptr;
+    char quot = 0;
+    uint32_t pred_depth = 0;
+
+    *no_pred = 1;
+    for (ptr = xpath; *ptr; ++ptr) {
+        if (quot) {
+            if (*ptr == quot) {
+                quot = 0;
+            }
+            continue;
+        }
+
+        if (*ptr == '[') {
+            ++pred_depth;
+            *no_pred = 0;
+        } else if (*ptr == ']') {
+            --pred_depth;
+        } else if (pred_depth) {
+            if ((*ptr == '\'') || (*ptr == '\"')) {
+                quot = *ptr;
+            }
+        } else if (*ptr == '-') {
+            /* only part of an identifier, not an operator */
+            if ((ptr == xpath) || !isalnum(ptr[-1]) || !isalnum(ptr[1])) {
+                return 0;
+            }
+        } else if (!isalnum(*ptr) && !strchr("_.:/*| ", *ptr)) {
+            /* functions, operators, literals */
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void
+sr_xpath_snodes_update(sr_conn_ctx_t *conn, const char *xpath, struct sr_xpath_snodes_s *xs)
+{
+    struct ly_set *set = NULL;
+    uint32_t i;
+
+    if ((xs->ly_ctx == conn->ly_ctx) && (xs->content_id == conn->content_id)) {
+        /* up-to-date */
+        return;
+    }
+
+    sr_xpath_snodes_free(xs);
+    xs->ly_ctx = conn->ly_ctx;
+    xs->content_id = conn->content_id;
+
+    if (!xpath || !sr_xpath_is_location_path(xpath, &xs->no_pred)) {
+        /* cannot be used for filtering */
+        return;
+    }
+
+    /* resolve the schema nodes */
+    if (lys_find_xpath(conn->ly_ctx, NULL, xpath, 0, &set) || !set->count) {
+        goto cleanup;
+    }
+    xs->snodes = malloc(set->count * sizeof *xs->snodes);
+    if (!xs->snodes) {
+        goto cleanup;
+    }
+    for (i = 0; i < set->count; ++i) {
+        xs->snodes[i] = set->snodes[i];
+    }
+    xs->snode_count = set->count;
+
+cleanup:
+    ly_set_free(set, NULL);
+}
+
+void
+sr_xpath_snodes_free(struct sr_xpath_snodes_s *xs)
+{
+    free(xs->snodes);
+    memset(xs, 0, sizeof *xs);
+}
+
+/**
+ * @brief Learn whether resolved XPath schema nodes can be used for filtering.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xs Resolved schema nodes.
+ * @return Whether they can be used.
+ */
+static int
+sr_xpath_snodes_usable(sr_conn_ctx_t *conn, const struct sr_xpath_snodes_s *xs)
+{
+    /* not yet resolved again after a context change, they may no longer be valid */
+    return xs->snodes && (xs->ly_ctx == conn->ly_ctx) && (xs->content_id == conn->content_id);
+}
+
+int
+sr_xpath_snodes_filter_op(sr_conn_ctx_t *conn, const struct sr_xpath_snodes_s *xs, const struct lysc_node *op_snode)
+{
+    const struct lysc_node *parent;
+    int eval = 0;
+    uint32_t i;
+
+    if (!sr_xpath_snodes_usable(conn, xs)) {
+        return -1;
+    }
+
+    for (i = 0; i < xs->snode_count; ++i) {
+        /* the operation and all its parents are in the data */
+        for (parent = op_snode; parent && (parent != xs->snodes[i]); parent = parent->parent) {}
+        if (parent) {
+            if (xs->no_pred) {
+                return 1;
+            }
+            eval = 1;
+            continue;
+        }
+
+        /* descendants of the operation may be in the data */
+        for (parent = xs->snodes[i]->parent; parent && (parent != op_snode); parent = parent->parent) {}
+        if (parent) {
+            eval = 1;
+        }
+    }
+
+    return eval ? -1 : 0;
+}
+
+int
+sr_xpath_snodes_filter_tree(sr_conn_ctx_t *conn, const struct sr_xpath_snodes_s *xs, const struct lyd_node *tree)
+{
+    const struct lyd_node *node;
+    const struct lysc_node *top;
+    uint32_t i;
+
+    if (!sr_xpath_snodes_usable(conn, xs)) {
+        return -1;
+    }
+
+    for (i = 0; i < xs->snode_count; ++i) {
+        /* the top-level data node of a selected node must be in the data */
+        for (top = xs->snodes[i]; lysc_data_parent(top); top = lysc_data_parent(top)) {}
+        LY_LIST_FOR(tree, node) {
+            if (node->schema == top) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
 sr_error_info_t *
 sr_subscr_oper_path_check(const struct ly_ctx *ly_ctx, const char *path, sr_mod_oper_get_sub_type_t *sub_type,
         int *valid)
@@ -2096,6 +2429,155 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Process-wide libyang contexts shared by connections with ::SR_CONN_CTX_SHARED.
+ *
+ * Every context is compiled only once for a context content ID and all the connections in the process
+ * using the same content ID reference it. It is destroyed once the last connection switches to a newer
+ * context or is disconnected.
+ *
+ * Sharing is limited to a single process. A compiled context is a graph of process-local pointers so it cannot
+ * be placed into SHM, every process keeps compiling its own context.
+ */
+static struct {
+    pthread_mutex_t lock;               /**< lock for accessing the shared contexts */
+    struct sr_shared_ctx_s {
+        struct ly_ctx *ly_ctx;          /**< shared libyang context */
+        uint32_t content_id;            /**< content ID of the context */
+        sr_conn_options_t ctx_opts;     /**< connection options used for creating the context */
+        uint32_t ref_count;             /**< number of connections using the context */
+    } *ctxs;                            /**< array of shared contexts */
+    uint32_t ctx_count;                 /**< shared context count */
+} shared_ctx = {.lock = PTHREAD_MUTEX_INITIALIZER, .ctxs = NULL, .ctx_count = 0};
+
+/** connection options affecting the created libyang context */
+#define SR_CONN_CTX_OPTS(opts) ((opts) & SR_CONN_CTX_SET_PRIV_PARSED)
+
+struct ly_ctx *
+sr_ly_ctx_shared_get(sr_conn_options_t opts, uint32_t content_id)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_ctx *ly_ctx = NULL;
+    uint32_t i;
+
+    /* SHARED CTX LOCK */
+    if ((err_info = sr_mlock(&shared_ctx.lock, -1, __func__, NULL, NULL))) {
+        sr_errinfo_free(&err_info);
+        return NULL;
+    }
+
+    for (i = 0; i < shared_ctx.ctx_count; ++i) {
+        if ((shared_ctx.ctxs[i].content_id == content_id) &&
+                (shared_ctx.ctxs[i].ctx_opts == SR_CONN_CTX_OPTS(opts))) {
+            ly_ctx = shared_ctx.ctxs[i].ly_ctx;
+            ++shared_ctx.ctxs[i].ref_count;
+            break;
+        }
+    }
+
+    /* SHARED CTX UNLOCK */
+    sr_munlock(&shared_ctx.lock);
+
+    return ly_ctx;
+}
+
+void
+sr_ly_ctx_shared_add(sr_conn_options_t opts, uint32_t content_id, struct ly_ctx **ly_ctx)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_shared_ctx_s *shctx;
+    void *mem;
+    uint32_t i;
+
+    /* SHARED CTX LOCK */
+    if ((err_info = sr_mlock(&shared_ctx.lock, -1, __func__, NULL, NULL))) {
+        /* the context will simply stay private */
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    for (i = 0; i < shared_ctx.ctx_count; ++i) {
+        if ((shared_ctx.ctxs[i].content_id == content_id) &&
+                (shared_ctx.ctxs[i].ctx_opts == SR_CONN_CTX_OPTS(opts))) {
+            /* another connection was faster, use its context */
+            ly_ctx_destroy(*ly_ctx);
+            *ly_ctx = shared_ctx.ctxs[i].ly_ctx;
+            ++shared_ctx.ctxs[i].ref_count;
+            goto cleanup;
+        }
+    }
+
+    /* add new shared context */
+    mem = realloc(shared_ctx.ctxs, (shared_ctx.ctx_count + 1) * sizeof *shared_ctx.ctxs);
+    if (!mem) {
+        /* the context will stay private */
+        SR_ERRINFO_MEM(&err_info);
+        sr_errinfo_free(&err_info);
+        goto cleanup;
+    }
+    shared_ctx.ctxs = mem;
+    shctx = &shared_ctx.ctxs[shared_ctx.ctx_count];
+    ++shared_ctx.ctx_count;
+
+    shctx->ly_ctx = *ly_ctx;
+    shctx->content_id = content_id;
+    shctx->ctx_opts = SR_CONN_CTX_OPTS(opts);
+    shctx->ref_count = 1;
+
+cleanup:
+    /* SHARED CTX UNLOCK */
+    sr_munlock(&shared_ctx.lock);
+}
+
+void
+sr_ly_ctx_release(struct ly_ctx *ly_ctx)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    if (!ly_ctx) {
+        return;
+    }
+
+    /* SHARED CTX LOCK */
+    if ((err_info = sr_mlock(&shared_ctx.lock, -1, __func__, NULL, NULL))) {
+        /* rather leak the context */
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    for (i = 0; i < shared_ctx.ctx_count; ++i) {
+        if (shared_ctx.ctxs[i].ly_ctx == ly_ctx) {
+            break;
+        }
+    }
+
+    if (i < shared_ctx.ctx_count) {
+        if (--shared_ctx.ctxs[i].ref_count) {
+            /* still used by other connections */
+            ly_ctx = NULL;
+        } else {
+            /* last reference, replace the context with the last one */
+            if (i < shared_ctx.ctx_count - 1) {
+                memcpy(&shared_ctx.ctxs[i], &shared_ctx.ctxs[shared_ctx.ctx_count - 1], sizeof *shared_ctx.ctxs);
+            }
+            --shared_ctx.ctx_count;
+
+            if (!shared_ctx.ctx_count) {
+                /* no other shared contexts */
+                free(shared_ctx.ctxs);
+                shared_ctx.ctxs = NULL;
+            }
+        }
+    }
+
+    /* SHARED CTX UNLOCK */
+    sr_munlock(&shared_ctx.lock);
+
+    /* private context or the last reference */
+    ly_ctx_destroy(ly_ctx);
+}
+
 sr_error_info_t *
 sr_ds_handle_init(struct sr_ds_handle_s **ds_handles, uint32_t *ds_handle_count)
 {
@@ -3073,6 +3555,24 @@ sr_path_evpipe(uint32_t evpipe_num, char **path)
     return err_info;
 }
 
+sr_error_info_t *
+sr_path_evpipe_ready(uint32_t evpipe_num, char **path)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *prefix;
+
+    err_info = sr_shm_prefix(&prefix);
+    if (err_info) {
+        return err_info;
+    }
+
+    if (asprintf(path, "%s/%s_evpipe%" PRIu32 ".ready", SR_SHM_DIR, prefix, evpipe_num) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+    }
+
+    return err_info;
+}
+
 sr_error_info_t *
 sr_path_yang_dir(char **path)
 {
@@ -3130,25 +3630,32 @@ sr_path_conn_lockfile(sr_cid_t cid, int creat, char **path)
     return err_info;
 }
 
-void
-sr_remove_evpipes(void)
-{
+/**
+ * @brief Remove all the files of crashed subscriptions with a name prefix from a directory.
+ *
+ * @param[in] dir_path Directory path.
+ * @param[in] name_prefix Name prefix of the removed files.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_remove_evpipes_dir(const char *dir_path, const char *name_prefix)
+{
     sr_error_info_t *err_info = NULL;
     DIR *dir = NULL;
     struct dirent *ent;
     char *path;
 
-    dir = opendir(sr_get_repo_path());
+    dir = opendir(dir_path);
     if (!dir) {
         SR_ERRINFO_SYSERRNO(&err_info, "opendir");
         goto cleanup;
     }
 
     while ((ent = readdir(dir))) {
-        if (!strncmp(ent->d_name, "sr_evpipe", 9)) {
+        if (!strncmp(ent->d_name, name_prefix, strlen(name_prefix))) {
             SR_LOG_WRN("Removing event pipe \"%s\" after a crashed subscription.", ent->d_name);
 
-            if (asprintf(&path, "%s/%s", sr_get_repo_path(), ent->d_name) == -1) {
+            if (asprintf(&path, "%s/%s", dir_path, ent->d_name) == -1) {
                 SR_ERRINFO_MEM(&err_info);
                 goto cleanup;
             }
@@ -3162,10 +3669,67 @@ sr_remove_evpipes(void)
     }
 
 cleanup:
-    closedir(dir);
+    if (dir) {
+        closedir(dir);
+    }
+    return err_info;
+}
+
+void
+sr_remove_evpipes(void)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *prefix;
+    char *name_prefix = NULL;
+
+    /* event pipes */
+    if ((err_info = sr_remove_evpipes_dir(sr_get_repo_path(), "sr_evpipe"))) {
+        goto cleanup;
+    }
+
+    /* their ready bitmap SHMs */
+    if ((err_info = sr_shm_prefix(&prefix))) {
+        goto cleanup;
+    }
+    if (asprintf(&name_prefix, "%s_evpipe", prefix) == -1) {
+        name_prefix = NULL;
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+    if ((err_info = sr_remove_evpipes_dir(SR_SHM_DIR, name_prefix))) {
+        goto cleanup;
+    }
+
+cleanup:
+    free(name_prefix);
     sr_errinfo_free(&err_info);
 }
 
+sr_error_info_t *
+sr_evpipe_unlink(sr_conn_ctx_t *conn, uint32_t evpipe_num)
+{
+    sr_error_info_t *err_info = NULL;
+    char *path;
+
+    /* event pipe */
+    if ((err_info = sr_path_evpipe(evpipe_num, &path))) {
+        return err_info;
+    }
+    unlink(path);
+    free(path);
+
+    /* its ready bitmap, it may be mapped in the sub SHM caches of connections */
+    if ((err_info = sr_path_evpipe_ready(evpipe_num, &path))) {
+        return err_info;
+    }
+    if (!unlink(path)) {
+        ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+    }
+    free(path);
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_get_pwd(uid_t *uid, char **user)
 {
@@ -3365,6 +3929,27 @@ sr_time_sub_ms(const struct timespec *ts1, const struct timespec *ts2)
     return (result.tv_sec * 1000) + (result.tv_nsec / 1000000);
 }
 
+uint64_t
+sr_time_sub_us(const struct timespec *ts1, const struct timespec *ts2)
+{
+    struct timespec result;
+
+    result = sr_time_sub(ts1, ts2);
+    if (result.tv_nsec == -1) {
+        return 0;
+    }
+    return (uint64_t)result.tv_sec * 1000000 + result.tv_nsec / 1000;
+}
+
+uint64_t
+sr_time_since_us(const struct timespec *ts)
+{
+    struct timespec cur_ts;
+
+    sr_time_get(&cur_ts, 0);
+    return sr_time_sub_us(&cur_ts, ts);
+}
+
 sr_error_info_t *
 sr_shm_remap(sr_shm_t *shm, size_t new_shm_size)
 {
@@ -4044,15 +4629,195 @@ sr_mutex_init(pthread_mutex_t *lock, int shared)
     return _sr_mutex_init(lock, shared, shared);
 }
 
+/** maximum number of locks held by a thread that can be tracked for lock hold times */
+#define SR_LOCK_HELD_MAX 16
+
+/**
+ * @brief Lock call site statistics of this process.
+ */
+static struct {
+    ATOMIC_T enabled;                       /**< Whether statistics are being collected. */
+    pthread_mutex_t lock;                   /**< Lock for adding new sites. */
+    sr_lock_site_t sites[SR_LOCK_SITE_MAX]; /**< Lock call sites, hashed by their function name. */
+} lock_stats = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+/**
+ * @brief Locks held by this thread, for measuring lock hold times.
+ */
+static _Thread_local struct {
+    struct {
+        const void *lock;                   /**< Held lock. */
+        sr_lock_site_t *site;               /**< Lock call site that acquired the lock. */
+        struct timespec ts;                 /**< Timestamp of acquiring the lock. */
+    } locks[SR_LOCK_HELD_MAX];
+    uint32_t count;                         /**< Number of held locks. */
+} lock_held;
+
+void
+sr_lock_stats_enable(void)
+{
+    ATOMIC_STORE_RELAXED(lock_stats.enabled, 1);
+}
+
+const sr_lock_site_t *
+sr_lock_stats_sites(void)
+{
+    return lock_stats.sites;
+}
+
+/**
+ * @brief Find lock call site statistics, add them if not yet present.
+ *
+ * @param[in] func Function name of the site.
+ * @return Lock call site, NULL if there are too many sites.
+ */
+static sr_lock_site_t *
+sr_lock_stats_site_get(const char *func)
+{
+    sr_lock_site_t *site;
+    const char *site_func;
+    uint32_t hash = 0, i;
+
+    /* sites with equal names (static functions in different files) are merged */
+    for (i = 0; func[i]; ++i) {
+        hash = hash * 31 + (uint8_t)func[i];
+    }
+
+    for (i = 0; i < SR_LOCK_SITE_MAX; ++i) {
+        site = &lock_stats.sites[(hash + i) % SR_LOCK_SITE_MAX];
+
+        site_func = ATOMIC_PTR_LOAD_RELAXED(site->func);
+        if (!site_func) {
+            /* LOCK STATS LOCK */
+            pthread_mutex_lock(&lock_stats.lock);
+
+            site_func = ATOMIC_PTR_LOAD_RELAXED(site->func);
+            if (!site_func) {
+                /* new site */
+                ATOMIC_PTR_STORE_RELAXED(site->func, (void *)func);
+                site_func = func;
+            }
+
+            /* LOCK STATS UNLOCK */
+            pthread_mutex_unlock(&lock_stats.lock);
+        }
+
+        if ((site_func == func) || !strcmp(site_func, func)) {
+            return site;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a time into a lock time histogram.
+ *
+ * @param[in] hist Histogram to update.
+ * @param[in] time_us Time to add in us.
+ */
+static void
+sr_lock_stats_hist_add(sr_lock_hist_t *hist, uint64_t time_us)
+{
+    uint32_t i;
+
+    /* bucket i holds times less than 2^i us */
+    for (i = 0; (i < SR_LOCK_HIST_BUCKETS - 1) && (time_us >= (1ULL << i)); ++i) {}
+
+    ATOMIC_INC_RELAXED(hist->count);
+    ATOMIC_ADD_RELAXED(hist->total, time_us);
+    ATOMIC_INC_RELAXED(hist->buckets[i]);
+}
+
+/**
+ * @brief Get the timestamp of starting to wait for a lock, if collecting lock statistics.
+ *
+ * @param[out] start_ts Current timestamp, zeroed if no statistics are being collected.
+ */
+static void
+sr_lock_stats_start(struct timespec *start_ts)
+{
+    if (ATOMIC_LOAD_RELAXED(lock_stats.enabled)) {
+        sr_time_get(start_ts, 0);
+    } else {
+        memset(start_ts, 0, sizeof *start_ts);
+    }
+}
+
+/**
+ * @brief Update lock call site statistics after a lock was acquired.
+ *
+ * @param[in] lock Acquired lock, NULL if its hold time should not be measured.
+ * @param[in] func Function name of the lock call site.
+ * @param[in] start_ts Timestamp of starting to wait for the lock.
+ */
+static void
+sr_lock_stats_acquired(const void *lock, const char *func, const struct timespec *start_ts)
+{
+    sr_lock_site_t *site;
+
+    if (!ATOMIC_LOAD_RELAXED(lock_stats.enabled) || !start_ts->tv_sec || !func) {
+        return;
+    }
+
+    if (!(site = sr_lock_stats_site_get(func))) {
+        return;
+    }
+
+    sr_lock_stats_hist_add(&site->wait, sr_time_since_us(start_ts));
+
+    if (!lock) {
+        return;
+    }
+
+    if (lock_held.count == SR_LOCK_HELD_MAX) {
+        /* forget the oldest lock, it may have been unlocked without us knowing */
+        memmove(&lock_held.locks[0], &lock_held.locks[1], (SR_LOCK_HELD_MAX - 1) * sizeof *lock_held.locks);
+        --lock_held.count;
+    }
+
+    /* remember the held lock */
+    lock_held.locks[lock_held.count].lock = lock;
+    lock_held.locks[lock_held.count].site = site;
+    sr_time_get(&lock_held.locks[lock_held.count].ts, 0);
+    ++lock_held.count;
+}
+
+/**
+ * @brief Update lock call site statistics before a lock is released.
+ *
+ * @param[in] lock Lock being released.
+ */
+static void
+sr_lock_stats_released(const void *lock)
+{
+    uint32_t i;
+
+    /* find the most recent acquisition of the lock by this thread */
+    for (i = lock_held.count; i && (lock_held.locks[i - 1].lock != lock); --i) {}
+    if (!i) {
+        return;
+    }
+    --i;
+
+    sr_lock_stats_hist_add(&lock_held.locks[i].site->hold, sr_time_since_us(&lock_held.locks[i].ts));
+
+    /* forget it */
+    --lock_held.count;
+    memmove(&lock_held.locks[i], &lock_held.locks[i + 1], (lock_held.count - i) * sizeof *lock_held.locks);
+}
+
 sr_error_info_t *
 sr_mlock(pthread_mutex_t *lock, int timeout_ms, const char *func, sr_lock_recover_cb cb, void *cb_data)
 {
     sr_error_info_t *err_info = NULL;
-    struct timespec abs_ts;
+    struct timespec start_ts, abs_ts;
     int ret;
 
     assert(timeout_ms);
 
+    sr_lock_stats_start(&start_ts);
+
     if (timeout_ms == -1) {
         ret = pthread_mutex_lock(lock);
     } else {
@@ -4076,6 +4841,7 @@ sr_mlock(pthread_mutex_t *lock, int timeout_ms, const char *func, sr_lock_recove
         return err_info;
     }
 
+    sr_lock_stats_acquired(lock, func, &start_ts);
     return NULL;
 }
 
@@ -4084,6 +4850,8 @@ sr_munlock(pthread_mutex_t *lock)
 {
     int ret;
 
+    sr_lock_stats_released(lock);
+
     ret = pthread_mutex_unlock(lock);
     if (ret) {
         SR_LOG_WRN("Unlocking a mutex failed (%s).", strerror(ret));
@@ -4111,6 +4879,8 @@ sr_rwlock_init(sr_rwlock_t *rwlock, int shared)
     memset(rwlock->readers, 0, sizeof rwlock->readers);
     rwlock->upgr = 0;
     rwlock->writer = 0;
+    rwlock->wr_pending = 0;
+    memset(&rwlock->stats, 0, sizeof rwlock->stats);
 
     return NULL;
 }
@@ -4241,6 +5011,88 @@ unlock:
     }
 }
 
+/**
+ * @brief Whether this thread is processing subscription events, its readers then do not wait for pending writers.
+ */
+static _Thread_local int rwlock_ev_thread;
+
+int
+sr_rwlock_ev_thread_set(int ev_thread)
+{
+    int prev = rwlock_ev_thread;
+
+    rwlock_ev_thread = ev_thread;
+    return prev;
+}
+
+/**
+ * @brief Check whether a connection holds a read lock of a rwlock.
+ * Mutex must be held!
+ *
+ * @param[in] rwlock RW lock to examine.
+ * @param[in] cid Connection ID.
+ * @return Whether @p cid is a reader of @p rwlock.
+ */
+static int
+sr_rwlock_is_reader(sr_rwlock_t *rwlock, sr_cid_t cid)
+{
+    uint32_t i;
+
+    for (i = 0; (i < SR_RWLOCK_READ_LIMIT) && rwlock->readers[i]; ++i) {
+        if (rwlock->readers[i] == cid) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Update RW lock statistics after the lock was acquired.
+ * Mutex must be held!
+ *
+ * @param[in] rwlock Acquired RW lock.
+ * @param[in] mode Acquired lock mode.
+ * @param[in] start_ts Timestamp of starting to wait for the lock.
+ */
+static void
+sr_rwlock_stats_acq(sr_rwlock_t *rwlock, sr_lock_mode_t mode, const struct timespec *start_ts)
+{
+    uint64_t wait_us;
+
+    wait_us = sr_time_since_us(start_ts);
+    if (mode == SR_LOCK_WRITE) {
+        ATOMIC_INC_RELAXED(rwlock->stats.write_acq);
+        ATOMIC_ADD_RELAXED(rwlock->stats.write_wait, wait_us);
+        if (wait_us > ATOMIC_LOAD_RELAXED(rwlock->stats.write_wait_max)) {
+            ATOMIC_STORE_RELAXED(rwlock->stats.write_wait_max, wait_us);
+        }
+    } else {
+        ATOMIC_INC_RELAXED(rwlock->stats.read_acq);
+        ATOMIC_ADD_RELAXED(rwlock->stats.read_wait, wait_us);
+    }
+}
+
+/**
+ * @brief Stop being the pending writer of a rwlock, if it was set.
+ * Mutex must be held!
+ *
+ * @param[in] rwlock RW lock.
+ * @param[in] cid Writer connection ID.
+ */
+static void
+sr_rwlock_wr_pending_clear(sr_rwlock_t *rwlock, sr_cid_t cid)
+{
+    if (rwlock->wr_pending != cid) {
+        return;
+    }
+
+    rwlock->wr_pending = 0;
+
+    /* wake up any readers waiting for the writer */
+    sr_cond_broadcast(&rwlock->cond);
+}
+
 /**
  * @brief Recover a sysrepo RW lock.
  * Mutex must be held!
@@ -4300,6 +5152,17 @@ sr_rwlock_recover(sr_rwlock_t *rwlock, const char *func, sr_lock_recover_cb cb,
             SR_LOG_WRN("Recovered a write-lock of CID %" PRIu32 " (%s).", cid, func);
         }
     }
+
+    /* pending write */
+    if (rwlock->wr_pending) {
+        if (!sr_conn_is_alive(rwlock->wr_pending)) {
+            cid = rwlock->wr_pending;
+            rwlock->wr_pending = 0;
+
+            /* nothing to recover, the writer did not get the lock */
+            SR_LOG_WRN("Recovered a pending write-lock of CID %" PRIu32 " (%s).", cid, func);
+        }
+    }
 }
 
 /**
@@ -4313,19 +5176,21 @@ sr_rwlock_recover(sr_rwlock_t *rwlock, const char *func, sr_lock_recover_cb cb,
  * @param[in] cb Optional callback called when recovering locks. When calling it, WRITE lock is always held.
  * @param[in] cb_data Arbitrary user data for @p cb.
  * @param[in] has_mutex Set if the lock mutex is already held.
+ * @param[in] writer_pref Set if new readers of other connections must wait while waiting for a WRITE lock.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
-        sr_lock_recover_cb cb, void *cb_data, int has_mutex)
+        sr_lock_recover_cb cb, void *cb_data, int has_mutex, int writer_pref)
 {
     sr_error_info_t *err_info = NULL;
-    struct timespec timeout_ts;
+    struct timespec start_ts, timeout_ts;
     int ret = 0;
 
     assert(mode && (timeout_ms >= 0) && cid);
 
-    sr_time_get(&timeout_ts, timeout_ms);
+    sr_time_get(&start_ts, 0);
+    timeout_ts = sr_time_ts_add(&start_ts, timeout_ms);
 
     if (!has_mutex) {
         /* MUTEX LOCK */
@@ -4340,6 +5205,9 @@ _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t ci
         sr_rwlock_recover(rwlock, func, cb, cb_data);
         SR_CHECK_INT_RET(ret, err_info);
     } else if (ret) {
+        if (ret == ETIMEDOUT) {
+            ATOMIC_INC_RELAXED(rwlock->stats.timeouts);
+        }
         SR_ERRINFO_LOCK(&err_info, func, ret);
         return err_info;
     }
@@ -4354,6 +5222,11 @@ _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t ci
         /* wait until there are no readers */
         ret = 0;
         while (!ret && rwlock->readers[0]) {
+            if (writer_pref && !rwlock->wr_pending) {
+                /* new readers will wait for us */
+                rwlock->wr_pending = cid;
+            }
+
             /* COND WAIT */
             ret = sr_cond_timedwait(&rwlock->cond, &rwlock->mutex, timeout_ms);
         }
@@ -4365,6 +5238,7 @@ _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t ci
                 ret = 0;
             }
         }
+        sr_rwlock_wr_pending_clear(rwlock, cid);
         if (ret) {
             goto error_cond_unlock;
         }
@@ -4374,6 +5248,9 @@ _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t ci
 
         /* set writer flag */
         rwlock->writer = cid;
+
+        sr_rwlock_stats_acq(rwlock, mode, &start_ts);
+        sr_lock_stats_acquired(rwlock, func, &start_ts);
     } else {
         /* read lock */
         if (rwlock->readers[SR_RWLOCK_READ_LIMIT - 1]) {
@@ -4381,6 +5258,28 @@ _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t ci
             sr_rwlock_recover(rwlock, func, cb, cb_data);
         }
 
+        if (rwlock->wr_pending && (rwlock->wr_pending != cid) && !sr_rwlock_is_reader(rwlock, cid) &&
+                !rwlock_ev_thread) {
+            /* writer preference, wait until the pending writer gets the lock (recursive readers must not wait and
+             * neither can event callbacks, the event originator may hold the lock the writer is waiting for) */
+            ret = 0;
+            while (!ret && rwlock->wr_pending && (rwlock->wr_pending != cid)) {
+                /* COND WAIT */
+                ret = sr_cond_timedwait(&rwlock->cond, &rwlock->mutex, timeout_ms);
+            }
+            if (ret == ETIMEDOUT) {
+                /* recover the lock, the writer may have died while waiting */
+                sr_rwlock_recover(rwlock, func, cb, cb_data);
+                if (!rwlock->wr_pending) {
+                    /* recovered */
+                    ret = 0;
+                }
+            }
+            if (ret) {
+                goto error_cond_unlock;
+            }
+        }
+
         if (mode == SR_LOCK_READ_UPGR) {
             if (rwlock->upgr) {
                 /* instead of waiting, try to recover the lock immediately */
@@ -4412,6 +5311,9 @@ _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t ci
         /* add a reader */
         sr_rwlock_reader_add(rwlock, cid);
 
+        sr_rwlock_stats_acq(rwlock, mode, &start_ts);
+        sr_lock_stats_acquired(rwlock, func, &start_ts);
+
         /* MUTEX UNLOCK */
         pthread_mutex_unlock(&rwlock->mutex);
     }
@@ -4419,6 +5321,10 @@ _sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t ci
     return NULL;
 
 error_cond_unlock:
+    if (ret == ETIMEDOUT) {
+        ATOMIC_INC_RELAXED(rwlock->stats.timeouts);
+    }
+
     if (!has_mutex) {
         /* MUTEX UNLOCK */
         pthread_mutex_unlock(&rwlock->mutex);
@@ -4432,22 +5338,42 @@ sr_error_info_t *
 sr_sub_rwlock_has_mutex(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
         sr_lock_recover_cb cb, void *cb_data)
 {
-    return _sr_rwlock(rwlock, timeout_ms, mode, cid, func, cb, cb_data, 1);
+    return _sr_rwlock(rwlock, timeout_ms, mode, cid, func, cb, cb_data, 1, 0);
 }
 
 sr_error_info_t *
 sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
         sr_lock_recover_cb cb, void *cb_data)
 {
-    return _sr_rwlock(rwlock, timeout_ms, mode, cid, func, cb, cb_data, 0);
+    return _sr_rwlock(rwlock, timeout_ms, mode, cid, func, cb, cb_data, 0, 0);
 }
 
 sr_error_info_t *
-sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
+sr_rwlock_writer_pref(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
         sr_lock_recover_cb cb, void *cb_data)
+{
+    return _sr_rwlock(rwlock, timeout_ms, mode, cid, func, cb, cb_data, 0, 1);
+}
+
+/**
+ * @brief Relock a sysrepo RW lock (upgrade or downgrade). On failure, the lock is not changed in any way.
+ *
+ * @param[in] rwlock RW lock to lock.
+ * @param[in] timeout_ms Timeout in ms for locking. Only needed for lock upgrade (if @p mode is ::SR_LOCK_WRITE).
+ * @param[in] mode Lock mode to set.
+ * @param[in] cid Lock owner connection ID.
+ * @param[in] func Name of the calling function for logging.
+ * @param[in] cb Optional callback called when recovering locks. When calling it, WRITE lock is always held.
+ * @param[in] cb_data Arbitrary user data for @p cb.
+ * @param[in] writer_pref Set if new readers of other connections must wait while waiting for the upgrade.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+_sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
+        sr_lock_recover_cb cb, void *cb_data, int writer_pref)
 {
     sr_error_info_t *err_info = NULL;
-    struct timespec timeout_ts;
+    struct timespec start_ts, timeout_ts;
     int ret;
 
     assert(mode && cid);
@@ -4457,7 +5383,8 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
         /*
          * upgrade from upgradeable read-lock to write-lock
          */
-        sr_time_get(&timeout_ts, timeout_ms);
+        sr_time_get(&start_ts, 0);
+        timeout_ts = sr_time_ts_add(&start_ts, timeout_ms);
 
         /* MUTEX LOCK */
         ret = pthread_mutex_timedlock(&rwlock->mutex, &timeout_ts);
@@ -4469,6 +5396,9 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
             sr_rwlock_recover(rwlock, func, cb, cb_data);
             SR_CHECK_INT_RET(ret, err_info);
         } else if (ret) {
+            if (ret == ETIMEDOUT) {
+                ATOMIC_INC_RELAXED(rwlock->stats.timeouts);
+            }
             SR_ERRINFO_LOCK(&err_info, func, ret);
             return err_info;
         }
@@ -4484,6 +5414,11 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
         /* wait until there are no readers except for this one */
         ret = 0;
         while (!ret && (rwlock->readers[1] || (rwlock->read_count[0] > 1))) {
+            if (writer_pref && !rwlock->wr_pending) {
+                /* new readers will wait for us */
+                rwlock->wr_pending = cid;
+            }
+
             /* COND WAIT */
             ret = sr_cond_timedwait(&rwlock->cond, &rwlock->mutex, timeout_ms);
         }
@@ -4494,7 +5429,11 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
                 ret = 0;
             }
         }
+        sr_rwlock_wr_pending_clear(rwlock, cid);
         if (ret) {
+            if (ret == ETIMEDOUT) {
+                ATOMIC_INC_RELAXED(rwlock->stats.timeouts);
+            }
             SR_ERRINFO_COND(&err_info, func, ret);
             goto cleanup_unlock;
         }
@@ -4507,6 +5446,11 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
         rwlock->upgr = 0;
         rwlock->writer = cid;
 
+        sr_rwlock_stats_acq(rwlock, mode, &start_ts);
+
+        /* hold time is measured from the original lock call site */
+        sr_lock_stats_acquired(NULL, func, &start_ts);
+
         /* simply keep the lock */
         return NULL;
     }
@@ -4538,6 +5482,20 @@ cleanup_unlock:
     return err_info;
 }
 
+sr_error_info_t *
+sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
+        sr_lock_recover_cb cb, void *cb_data)
+{
+    return _sr_rwrelock(rwlock, timeout_ms, mode, cid, func, cb, cb_data, 0);
+}
+
+sr_error_info_t *
+sr_rwrelock_writer_pref(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
+        sr_lock_recover_cb cb, void *cb_data)
+{
+    return _sr_rwrelock(rwlock, timeout_ms, mode, cid, func, cb, cb_data, 1);
+}
+
 void
 sr_rwunlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func)
 {
@@ -4548,6 +5506,8 @@ sr_rwunlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
     assert(mode && cid);
     assert((mode == SR_LOCK_WRITE) || (timeout_ms > 0));
 
+    sr_lock_stats_released(rwlock);
+
     if ((mode == SR_LOCK_READ) || (mode == SR_LOCK_READ_UPGR)) {
         sr_time_get(&timeout_ts, timeout_ms);
 
@@ -4766,6 +5726,25 @@ sr_conn_oper_cache_flush(sr_conn_ctx_t *conn)
 
     /* CONN OPER CACHE UNLOCK */
     sr_rwunlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+    /* CONN OPER EDIT CACHE WRITE LOCK */
+    if ((err_info = sr_rwlock(&conn->oper_edit_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid,
+            __func__, NULL, NULL))) {
+        /* should never happen */
+        sr_errinfo_free(&err_info);
+    }
+
+    /* free all the cached stored operational edits */
+    for (i = 0; i < conn->oper_edit_cache_count; ++i) {
+        lyd_free_siblings(conn->oper_edit_caches[i].edit);
+        free(conn->oper_edit_caches[i].cids);
+    }
+    free(conn->oper_edit_caches);
+    conn->oper_edit_caches = NULL;
+    conn->oper_edit_cache_count = 0;
+
+    /* CONN OPER EDIT CACHE UNLOCK */
+    sr_rwunlock(&conn->oper_edit_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
 }
 
 void *
@@ -6624,6 +7603,212 @@ sr_lyd_print_lyb(const struct lyd_node *data, char **str, uint32_t *len)
     return NULL;
 }
 
+sr_error_info_t *
+sr_lyd_print_lyb_idx(const struct lyd_node *data, char **str, uint32_t *len)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lyd_node *node;
+    struct ly_out *out = NULL;
+    sr_diff_idx_t *idx;
+    char *lyb = NULL, *ptr;
+    uint32_t i, count = 0, names_len = 0, lyb_len = 0, *lyb_offs = NULL;
+
+    *str = NULL;
+    *len = 0;
+
+    /* learn the number of subtrees and the length of their names */
+    LY_LIST_FOR(data, node) {
+        ++count;
+        names_len += strlen(lyd_owner_module(node)->name) + 1 + strlen(LYD_NAME(node)) + 1;
+    }
+
+    if (count) {
+        lyb_offs = malloc(count * sizeof *lyb_offs);
+        SR_CHECK_MEM_GOTO(!lyb_offs, err_info, cleanup);
+    }
+
+    /* print all the subtrees one after another */
+    ly_out_new_memory(&lyb, 0, &out);
+    i = 0;
+    LY_LIST_FOR(data, node) {
+        lyb_offs[i++] = lyb_len;
+        if (lyd_print_tree(out, node, LYD_LYB, 0)) {
+            sr_errinfo_new_ly(&err_info, LYD_CTX(node), NULL);
+            goto cleanup;
+        }
+        lyb_len += ly_out_printed(out);
+    }
+
+    /* allocate the indexed diff */
+    *len = sizeof *idx + count * sizeof *idx->entries + names_len + lyb_len;
+    *str = malloc(*len);
+    SR_CHECK_MEM_GOTO(!*str, err_info, cleanup);
+    idx = (sr_diff_idx_t *)*str;
+    idx->size = *len;
+    idx->count = count;
+
+    /* names */
+    ptr = (char *)&idx->entries[count];
+    i = 0;
+    LY_LIST_FOR(data, node) {
+        idx->entries[i].name = ptr - *str;
+        ptr += sprintf(ptr, "%s:%s", lyd_owner_module(node)->name, LYD_NAME(node)) + 1;
+        ++i;
+    }
+
+    /* LYB data */
+    for (i = 0; i < count; ++i) {
+        idx->entries[i].lyb = (ptr - *str) + lyb_offs[i];
+    }
+    if (lyb_len) {
+        memcpy(ptr, lyb, lyb_len);
+    }
+
+cleanup:
+    ly_out_free(out, NULL, 0);
+    free(lyb);
+    free(lyb_offs);
+    if (err_info) {
+        free(*str);
+        *str = NULL;
+        *len = 0;
+    }
+    return err_info;
+}
+
+/**
+ * @brief Learn the only top-level node whose subtree an XPath can select nodes from.
+ *
+ * @param[in] xpath XPath to examine.
+ * @param[out] mod_name Module name of the top-level node, NULL if it cannot be learned.
+ * @param[out] mod_len Length of @p mod_name.
+ * @param[out] name Name of the top-level node, NULL if any of @p mod_name.
+ * @param[out] name_len Length of @p name.
+ */
+static void
+sr_xpath_top_node(const char *xpath, const char **mod_name, uint32_t *mod_len, const char **name, uint32_t *name_len)
+{
+    const char *ptr;
+    char quot = 0;
+    uint32_t pred_depth = 0;
+
+    *mod_name = NULL;
+    *mod_len = 0;
+    *name = NULL;
+    *name_len = 0;
+
+    /* the first step must be an absolute prefixed node name */
+    if ((xpath[0] != '/') || (xpath[1] == '/')) {
+        return;
+    }
+    ptr = xpath + 1;
+    while (isalnum(*ptr) || (*ptr == '_') || (*ptr == '-') || (*ptr == '.')) {
+        ++ptr;
+    }
+    if ((ptr == xpath + 1) || (*ptr != ':')) {
+        return;
+    }
+    *mod_len = ptr - (xpath + 1);
+
+    ++ptr;
+    if (*ptr == '*') {
+        /* any node of the module */
+        ++ptr;
+    } else {
+        *name = ptr;
+        while (isalnum(*ptr) || (*ptr == '_') || (*ptr == '-') || (*ptr == '.')) {
+            ++ptr;
+        }
+        *name_len = ptr - *name;
+        if (!*name_len) {
+            *name = NULL;
+            return;
+        }
+    }
+    if (*ptr && (*ptr != '/') && (*ptr != '[')) {
+        *name = NULL;
+        *name_len = 0;
+        return;
+    }
+
+    /* the rest must not leave the subtree or refer to other data, any axis may */
+    for ( ; *ptr; ++ptr) {
+        if (quot) {
+            if (*ptr == quot) {
+                quot = 0;
+            }
+            continue;
+        }
+
+        if ((*ptr == '\'') || (*ptr == '\"')) {
+            quot = *ptr;
+        } else if (*ptr == '[') {
+            ++pred_depth;
+        } else if (*ptr == ']') {
+            --pred_depth;
+        } else if ((*ptr == '|') || (*ptr == '(') || ((ptr[0] == '.') && (ptr[1] == '.')) ||
+                ((ptr[0] == ':') && (ptr[1] == ':')) || (pred_depth && (*ptr == '/'))) {
+            *name = NULL;
+            *name_len = 0;
+            return;
+        }
+    }
+
+    *mod_name = xpath + 1;
+}
+
+sr_error_info_t *
+sr_lyd_parse_lyb_idx(const struct ly_ctx *ly_ctx, const char *idx_data, const char *module_name, const char *xpath,
+        uint8_t *parsed, struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL;
+    const sr_diff_idx_t *idx = (const sr_diff_idx_t *)idx_data;
+    const char *mod_name, *name, *entry_name;
+    uint32_t i, mod_len, name_len;
+    struct lyd_node *tree;
+
+    /* learn which subtrees are needed */
+    if (xpath) {
+        sr_xpath_top_node(xpath, &mod_name, &mod_len, &name, &name_len);
+    } else {
+        mod_name = module_name;
+        mod_len = module_name ? strlen(module_name) : 0;
+        name = NULL;
+        name_len = 0;
+    }
+
+    for (i = 0; i < idx->count; ++i) {
+        if (parsed[i]) {
+            continue;
+        }
+
+        entry_name = idx_data + idx->entries[i].name;
+        if (mod_name && (strncmp(entry_name, mod_name, mod_len) || (entry_name[mod_len] != ':'))) {
+            continue;
+        }
+        if (name && (strncmp(entry_name + mod_len + 1, name, name_len) || entry_name[mod_len + 1 + name_len])) {
+            continue;
+        }
+
+        /* parse the subtree */
+        if (lyd_parse_data_mem(ly_ctx, idx_data + idx->entries[i].lyb, LYD_LYB, LYD_PARSE_ONLY | LYD_PARSE_STRICT, 0,
+                &tree)) {
+            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+            return err_info;
+        }
+        parsed[i] = 1;
+
+        /* append it */
+        if (tree && lyd_insert_sibling(*data, tree, data)) {
+            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+            lyd_free_all(tree);
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
 struct lyd_node *
 sr_module_data_unlink(struct lyd_node **data, const struct lys_module *ly_mod)
 {
@@ -6678,17 +7863,195 @@ sr_module_file_data_append(const struct lys_module *ly_mod, const struct srplg_d
     return NULL;
 }
 
+/**
+ * @brief Check whether a connection is alive, remembering all the connections found alive.
+ *
+ * @param[in] cid Connection ID to check.
+ * @param[in,out] alive_cids Array of connections known to be alive.
+ * @param[in,out] alive_count Count of @p alive_cids.
+ * @param[out] alive Whether the connection is alive.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_file_oper_conn_is_alive(sr_cid_t cid, sr_cid_t **alive_cids, uint32_t *alive_count, int *alive)
+{
+    sr_error_info_t *err_info = NULL;
+    void *mem;
+    uint32_t i;
+
+    /* cached */
+    for (i = 0; i < *alive_count; ++i) {
+        if ((*alive_cids)[i] == cid) {
+            *alive = 1;
+            return NULL;
+        }
+    }
+
+    /* check the lockfile */
+    *alive = sr_conn_is_alive(cid);
+    if (!*alive) {
+        /* its edit will be removed so it will not be checked again */
+        return NULL;
+    }
+
+    /* remember it */
+    mem = realloc(*alive_cids, (*alive_count + 1) * sizeof **alive_cids);
+    SR_CHECK_MEM_RET(!mem, err_info);
+    *alive_cids = mem;
+    (*alive_cids)[*alive_count] = cid;
+    ++(*alive_count);
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_conn_oper_edit_cache_apply(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, struct lyd_node **data, int *cached,
+        int *applied)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_oper_edit_cache_s *cache = NULL;
+    uint32_t i, gen;
+
+    *cached = 0;
+    *applied = 0;
+
+    gen = ATOMIC_LOAD_RELAXED(mod->shm_mod->oper_edit_gen);
+
+    /* CONN OPER EDIT CACHE READ LOCK */
+    if ((err_info = sr_rwlock(&conn->oper_edit_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
+            __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    for (i = 0; i < conn->oper_edit_cache_count; ++i) {
+        if (conn->oper_edit_caches[i].ly_mod == mod->ly_mod) {
+            cache = &conn->oper_edit_caches[i];
+            break;
+        }
+    }
+    if (!cache || (cache->gen != gen)) {
+        /* no valid cached edit */
+        goto cleanup;
+    }
+
+    /* a dead owner connection invalidates the edit, its part must be removed */
+    for (i = 0; i < cache->cid_count; ++i) {
+        if (!sr_conn_is_alive(cache->cids[i])) {
+            goto cleanup;
+        }
+    }
+
+    /* apply the cached edit directly */
+    *cached = 1;
+    if (cache->edit) {
+        if ((err_info = sr_edit_mod_apply(cache->edit, mod->ly_mod, data, NULL, NULL))) {
+            goto cleanup;
+        }
+        *applied = 1;
+    }
+
+cleanup:
+    /* CONN OPER EDIT CACHE UNLOCK */
+    sr_rwunlock(&conn->oper_edit_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+    return err_info;
+}
+
+/**
+ * @brief Cache a copy of a stored operational edit of a module.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the edit.
+ * @param[in] gen Generation of the stored operational edit.
+ * @param[in] edit Edit to cache.
+ * @param[in] cids Connections owning any part of @p edit.
+ * @param[in] cid_count Count of @p cids.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_conn_oper_edit_cache_update(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, uint32_t gen,
+        const struct lyd_node *edit, const sr_cid_t *cids, uint32_t cid_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *dup = NULL;
+    sr_cid_t *cids_dup = NULL;
+    void *mem;
+    uint32_t i;
+
+    /* copy the edit and its owners */
+    if (edit && lyd_dup_siblings(edit, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &dup)) {
+        sr_errinfo_new_ly(&err_info, ly_mod->ctx, NULL);
+        return err_info;
+    }
+    if (cid_count) {
+        cids_dup = malloc(cid_count * sizeof *cids_dup);
+        if (!cids_dup) {
+            lyd_free_siblings(dup);
+            SR_ERRINFO_MEM(&err_info);
+            return err_info;
+        }
+        memcpy(cids_dup, cids, cid_count * sizeof *cids_dup);
+    }
+
+    /* CONN OPER EDIT CACHE WRITE LOCK */
+    if ((err_info = sr_rwlock(&conn->oper_edit_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid,
+            __func__, NULL, NULL))) {
+        lyd_free_siblings(dup);
+        free(cids_dup);
+        return err_info;
+    }
+
+    for (i = 0; i < conn->oper_edit_cache_count; ++i) {
+        if (conn->oper_edit_caches[i].ly_mod == ly_mod) {
+            break;
+        }
+    }
+    if (i == conn->oper_edit_cache_count) {
+        /* new cache entry */
+        mem = realloc(conn->oper_edit_caches, (i + 1) * sizeof *conn->oper_edit_caches);
+        if (!mem) {
+            lyd_free_siblings(dup);
+            free(cids_dup);
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+        conn->oper_edit_caches = mem;
+        conn->oper_edit_caches[i].ly_mod = ly_mod;
+        conn->oper_edit_caches[i].edit = NULL;
+        conn->oper_edit_caches[i].cids = NULL;
+        ++conn->oper_edit_cache_count;
+    }
+
+    /* replace the cached edit */
+    lyd_free_siblings(conn->oper_edit_caches[i].edit);
+    conn->oper_edit_caches[i].edit = dup;
+    free(conn->oper_edit_caches[i].cids);
+    conn->oper_edit_caches[i].cids = cids_dup;
+    conn->oper_edit_caches[i].cid_count = cid_count;
+    conn->oper_edit_caches[i].gen = gen;
+
+cleanup:
+    /* CONN OPER EDIT CACHE UNLOCK */
+    sr_rwunlock(&conn->oper_edit_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
+    return err_info;
+}
+
 sr_error_info_t *
-sr_module_file_oper_data_load(struct sr_mod_info_mod_s *mod, struct lyd_node **edit)
+sr_module_file_oper_data_load(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, struct lyd_node **edit)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *root, *elem;
     struct lyd_meta *meta;
-    sr_cid_t dead_cid = 0;
-    int rc;
+    sr_cid_t dead_cid = 0, *alive_cids = NULL;
+    uint32_t alive_count = 0, gen = 0;
+    int rc, alive;
 
     assert(!*edit);
 
+    if (conn->opts & SR_CONN_CACHE_OPER) {
+        /* read the generation before loading so that a concurrent change is never missed */
+        gen = ATOMIC_LOAD_RELAXED(mod->shm_mod->oper_edit_gen);
+    }
+
     /* load the operational data (edit) */
     if ((rc = mod->ds_plg[SR_DS_OPERATIONAL]->load_cb(mod->ly_mod, SR_DS_OPERATIONAL, NULL, 0, edit))) {
         SR_ERRINFO_DSPLUGIN(&err_info, rc, "load", mod->ds_plg[SR_DS_OPERATIONAL]->name, mod->ly_mod->name);
@@ -6700,24 +8063,39 @@ trim_retry:
         /* this connection is dead, remove its stored edit */
         SR_LOG_INF("Recovering module \"%s\" stored operational data of CID %" PRIu32 ".", mod->ly_mod->name, dead_cid);
         if ((err_info = sr_edit_oper_del(edit, dead_cid, NULL, NULL))) {
-            return err_info;
+            goto cleanup;
         }
     }
 
-    /* find edit belonging to a dead connection, if any */
+    /* find edit belonging to a dead connection, if any, each connection is checked only once */
     LY_LIST_FOR(*edit, root) {
         LYD_TREE_DFS_BEGIN(root, elem) {
             meta = lyd_find_meta(elem->meta, NULL, "sysrepo:cid");
-            if (meta && !sr_conn_is_alive(meta->value.uint32)) {
-                dead_cid = meta->value.uint32;
+            if (meta) {
+                if ((err_info = sr_module_file_oper_conn_is_alive(meta->value.uint32, &alive_cids, &alive_count,
+                        &alive))) {
+                    goto cleanup;
+                }
+                if (!alive) {
+                    dead_cid = meta->value.uint32;
 
-                /* retry the whole check until there are no dead connections */
-                goto trim_retry;
+                    /* retry the whole check until there are no dead connections */
+                    goto trim_retry;
+                }
             }
             LYD_TREE_DFS_END(root, elem);
         }
     }
 
+    if (conn->opts & SR_CONN_CACHE_OPER) {
+        /* cache the edit without the edits of dead connections with all its owners, which are all alive */
+        if ((err_info = sr_conn_oper_edit_cache_update(conn, mod->ly_mod, gen, *edit, alive_cids, alive_count))) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    free(alive_cids);
     return err_info;
 }
 
@@ -94,9 +94,6 @@ struct srplg_ntf_s;
 /** timeout for locking DS lock mutex of a module; is held only when accessing the DS lock information (ms) */
 #define SR_DS_LOCK_MUTEX_TIMEOUT 100
 
-/** timeout step when waiting for a DS lock (ms) */
-#define SR_DS_LOCK_TIMEOUT_STEP 50
-
 /** timeout for locking SHM module/RPC subscriptions; maxmum time full event processing may take (ms) */
 #define SR_SHMEXT_SUB_LOCK_TIMEOUT 15000
 
@@ -121,12 +118,18 @@ struct srplg_ntf_s;
 /** permissions of connection lock files */
 #define SR_CONN_LOCKFILE_PERM 00666
 
+/** mark in the lock file of a connection created with ::SR_CONN_ENTRY_LOCK */
+#define SR_CONN_LOCKFILE_ENTRY_LOCK " entry-lock"
+
 /** permissions of all subscription SHMs */
 #define SR_SUB_SHM_PERM 00666
 
 /** permissions of all event pipes (only owner read, anyone else write */
 #define SR_EVPIPE_PERM 00622
 
+/** maximum number of sub and sub data SHMs cached by a connection */
+#define SR_SUB_SHM_CACHE_SIZE 32
+
 /** initial length of message buffer (B) */
 #define SR_MSG_LEN_START 128
 
@@ -159,7 +162,8 @@ extern const sr_module_ds_t sr_default_module_ds;
 
 /** initializer of mod_info structure */
 #define SR_MODINFO_INIT(mi, c, d, d2) (mi).ds = (d); (mi).ds2 = (d2); (mi).diff = NULL; (mi).data = NULL; \
-        (mi).data_cached = 0; (mi).conn = (c); (mi).mods = NULL; (mi).mod_count = 0
+        (mi).data_cached = 0; (mi).conn = (c); (mi).mods = NULL; (mi).mod_count = 0; \
+        (mi).entry_locked = 0
 
 /**
  * @brief Internal information about a module to be installed.
@@ -203,6 +207,34 @@ typedef struct {
 sr_error_info_t *_sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_sub_event_t event,
         char **shm_data_ptr, sr_session_ctx_t **session);
 
+/**
+ * @brief Set originator name and data of an event session, replacing any previous ones.
+ *
+ * @param[in] sess Event session to use.
+ * @param[in,out] shm_data_ptr Pointer to SHM sub data where originator name and data are stored, is updated.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_session_set_orig_shm(sr_session_ctx_t *sess, char **shm_data_ptr);
+
+/**
+ * @brief Set the indexed change diff of an event session, replacing any previous diff. No subtrees are parsed.
+ *
+ * @param[in] sess Event session to use.
+ * @param[in] shm_data_ptr Pointer to SHM sub data where the indexed diff is stored.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_session_set_ev_diff_shm(sr_session_ctx_t *sess, const char *shm_data_ptr);
+
+/**
+ * @brief Parse the subtrees of the indexed change diff of an event session that may be needed, if not yet parsed.
+ *
+ * @param[in] sess Event session to use.
+ * @param[in] module_name Module of the subtrees to parse, used only if @p xpath is not set, all if NULL.
+ * @param[in] xpath Optional XPath selecting the subtrees to parse.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_session_ev_diff_parse(sr_session_ctx_t *sess, const char *module_name, const char *xpath);
+
 /*
  * Subscription functions
  */
@@ -295,19 +327,24 @@ void sr_subscr_oper_poll_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id,
  * @param[in] sess Subscription session.
  * @param[in] mod_name Subscription module name.
  * @param[in] xpath Subscription XPath.
+ * @param[in] drop Whether the subscription never blocks senders and may miss notifications instead.
  * @param[in] listen_since Timestamp of the subscription starting to listen.
  * @param[in] start_time Optional subscription start time.
  * @param[in] stop_time Optional subscription stop time.
  * @param[in] notif_cb Subscription value callback.
  * @param[in] notif_tree_cb Subscription tree callback.
+ * @param[in] notif_batch_cb Subscription batch callback.
+ * @param[in] batch_size Maximum number of notifications delivered to @p notif_batch_cb at once, 0 for no limit.
+ * @param[in] batch_timeout_us Maximum time to defer delivery of a notification to @p notif_batch_cb.
  * @param[in] private_data Subscription callback private data.
  * @param[in] has_subs_lock What kind of SUBS lock is held.
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_subscr_notif_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_session_ctx_t *sess,
-        const char *mod_name, const char *xpath, const struct timespec *listen_since, const struct timespec *start_time,
-        const struct timespec *stop_time, sr_event_notif_cb notif_cb, sr_event_notif_tree_cb notif_tree_cb,
-        void *private_data, sr_lock_mode_t has_subs_lock);
+        const char *mod_name, const char *xpath, int drop, const struct timespec *listen_since,
+        const struct timespec *start_time, const struct timespec *stop_time, sr_event_notif_cb notif_cb,
+        sr_event_notif_tree_cb notif_tree_cb, sr_event_notif_batch_cb notif_batch_cb, uint32_t batch_size,
+        uint32_t batch_timeout_us, void *private_data, sr_lock_mode_t has_subs_lock);
 
 /**
  * @brief Delete a notification subscription from a subscription structure.
@@ -408,12 +445,13 @@ struct opsub_rpcsub_s *sr_subscr_rpc_sub_find(const sr_subscription_ctx_t *subsc
  * @param[in] subscr Session subscription.
  * @param[in] sess Subscription session.
  * @param[in] has_subs_lock What kind of SUBS lock is held.
- * @return Number of session subscriptions.
+ * @return Number of session subscriptions and pending asynchronous apply changes requests.
  */
 int sr_subscr_session_count(sr_subscription_ctx_t *subscr, sr_session_ctx_t *sess, sr_lock_mode_t has_subs_lock);
 
 /**
  * @brief Delete all subscriptions in \p subscr of session \p sess.
+ * Any pending asynchronous apply changes requests of the session fail.
  *
  * @param[in,out] subscr Session subscription.
  * @param[in] sess Subscription session.
@@ -451,6 +489,7 @@ sr_error_info_t *sr_notif_find_subscriber(sr_conn_ctx_t *conn, const char *mod_n
  * @param[in] ev_sess Event session to provide for the callback.
  * @param[in] cb Value callback.
  * @param[in] tree_cb Tree callback.
+ * @param[in] batch_cb Batch callback, called with a single notification.
  * @param[in] private_data Callback private data.
  * @param[in] notif_type Notification type.
  * @param[in] sub_id Subscription ID.
@@ -459,8 +498,8 @@ sr_error_info_t *sr_notif_find_subscriber(sr_conn_ctx_t *conn, const char *mod_n
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_notif_call_callback(sr_session_ctx_t *ev_sess, sr_event_notif_cb cb, sr_event_notif_tree_cb tree_cb,
-        void *private_data, const sr_ev_notif_type_t notif_type, uint32_t sub_id, const struct lyd_node *notif_op,
-        struct timespec *notif_ts);
+        sr_event_notif_batch_cb batch_cb, void *private_data, const sr_ev_notif_type_t notif_type, uint32_t sub_id,
+        const struct lyd_node *notif_op, struct timespec *notif_ts);
 
 /**
  * @brief Check the XPath of a change subscription.
@@ -473,6 +512,48 @@ sr_error_info_t *sr_notif_call_callback(sr_session_ctx_t *ev_sess, sr_event_noti
  */
 sr_error_info_t *sr_subscr_change_xpath_check(const struct ly_ctx *ly_ctx, const char *xpath, int *valid);
 
+/**
+ * @brief Resolve the schema nodes a subscription XPath can select, if not yet resolved in the connection context.
+ * Must be called with SUBS WRITE lock because event processing reads the nodes concurrently.
+ *
+ * Failing to resolve them is not an error, the XPath is then always evaluated.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath Subscription XPath, NULL if none.
+ * @param[in,out] xs Resolved schema nodes to update.
+ */
+void sr_xpath_snodes_update(sr_conn_ctx_t *conn, const char *xpath, struct sr_xpath_snodes_s *xs);
+
+/**
+ * @brief Free resolved XPath schema nodes.
+ *
+ * @param[in] xs Resolved schema nodes to free.
+ */
+void sr_xpath_snodes_free(struct sr_xpath_snodes_s *xs);
+
+/**
+ * @brief Filter an operation (RPC/action or notification) using resolved XPath schema nodes.
+ *
+ * @param[in] conn Connection to use, the nodes are used only if resolved in its current context.
+ * @param[in] xs Resolved schema nodes.
+ * @param[in] op_snode Schema node of the operation.
+ * @return 0 if the operation cannot match the XPath;
+ * @return 1 if it matches the XPath;
+ * @return -1 if the XPath must be evaluated.
+ */
+int sr_xpath_snodes_filter_op(sr_conn_ctx_t *conn, const struct sr_xpath_snodes_s *xs, const struct lysc_node *op_snode);
+
+/**
+ * @brief Filter a data tree using resolved XPath schema nodes.
+ *
+ * @param[in] conn Connection to use, the nodes are used only if resolved in its current context.
+ * @param[in] xs Resolved schema nodes.
+ * @param[in] tree First top-level sibling of the data tree.
+ * @return 0 if no node of the data tree can match the XPath;
+ * @return -1 if the XPath must be evaluated.
+ */
+int sr_xpath_snodes_filter_tree(sr_conn_ctx_t *conn, const struct sr_xpath_snodes_s *xs, const struct lyd_node *tree);
+
 /**
  * @brief Check the path of an oper subscription. Optionally learn what kinds (config) of nodes are provided
  * by an operational subscription to determine its type.
@@ -550,6 +631,33 @@ sr_error_info_t *sr_ptr_del(pthread_mutex_t *ptr_lock, void ***ptrs, uint32_t *p
 sr_error_info_t *sr_ly_ctx_init(sr_conn_options_t opts, ly_ext_data_clb ext_cb, void *ext_cb_data,
         const char *ext_searchdir, struct ly_ctx **ly_ctx);
 
+/**
+ * @brief Get a process-wide shared libyang context, its reference count is increased.
+ *
+ * @param[in] opts Connection options.
+ * @param[in] content_id Required context content ID.
+ * @return Shared context, NULL if there is none.
+ */
+struct ly_ctx *sr_ly_ctx_shared_get(sr_conn_options_t opts, uint32_t content_id);
+
+/**
+ * @brief Make a new libyang context process-wide shared. If a shared context for the same content ID
+ * was added in the meantime, the context is freed and the shared one is used instead.
+ *
+ * @param[in] opts Connection options used for creating @p ly_ctx.
+ * @param[in] content_id Content ID of @p ly_ctx.
+ * @param[in,out] ly_ctx libyang context to share, may be replaced.
+ */
+void sr_ly_ctx_shared_add(sr_conn_options_t opts, uint32_t content_id, struct ly_ctx **ly_ctx);
+
+/**
+ * @brief Release a connection libyang context. Shared contexts are destroyed only once
+ * their last reference is released, private contexts immediately.
+ *
+ * @param[in] ly_ctx libyang context to release.
+ */
+void sr_ly_ctx_release(struct ly_ctx *ly_ctx);
+
 /**
  * @brief Initialize all dynamic DS handles.
  *
@@ -744,6 +852,15 @@ sr_error_info_t *sr_path_sub_data_shm(const char *mod_name, const char *suffix1,
  */
 sr_error_info_t *sr_path_evpipe(uint32_t evpipe_num, char **path);
 
+/**
+ * @brief Get the path to the ready bitmap SHM of an event pipe.
+ *
+ * @param[in] evpipe_num Event pipe number.
+ * @param[out] path Created path.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_path_evpipe_ready(uint32_t evpipe_num, char **path);
+
 /**
  * @brief Get the path to YANG module files directory.
  *
@@ -776,11 +893,20 @@ sr_error_info_t *sr_path_yang_file(const char *mod_name, const char *mod_rev, ch
 sr_error_info_t *sr_path_conn_lockfile(sr_cid_t cid, int creat, char **path);
 
 /**
- * @brief Remove any leftover event pipes after crashed subscriptions.
+ * @brief Remove any leftover event pipes and their ready bitmap SHMs after crashed subscriptions.
  * There should be none unless there was a subscription structure without subscriptions that crashed.
  */
 void sr_remove_evpipes(void);
 
+/**
+ * @brief Remove an event pipe and its ready bitmap SHM, if they exist.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] evpipe_num Event pipe number.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_evpipe_unlink(sr_conn_ctx_t *conn, uint32_t evpipe_num);
+
 /**
  * @brief Get the UID of a user or vice versa.
  *
@@ -852,6 +978,24 @@ struct timespec sr_time_sub(const struct timespec *ts1, const struct timespec *t
  */
 int sr_time_sub_ms(const struct timespec *ts1, const struct timespec *ts2);
 
+/**
+ * @brief Subtract a timespec from another in microseconds.
+ *
+ * @param[in] ts1 First timespec to be subtracted from.
+ * @param[in] ts2 Second timespec to subtract.
+ * @return Result of @p ts1 - @p ts2.
+ * @return 0 if @p ts1 < @p ts2.
+ */
+uint64_t sr_time_sub_us(const struct timespec *ts1, const struct timespec *ts2);
+
+/**
+ * @brief Get time elapsed since a timestamp.
+ *
+ * @param[in] ts Timestamp in the past.
+ * @return Elapsed time in us, 0 if @p ts is in the future.
+ */
+uint64_t sr_time_since_us(const struct timespec *ts);
+
 /**
  * @brief Remap and possibly resize a SHM. Needs WRITE lock for resizing,
  * otherwise READ lock is fine.
@@ -1024,6 +1168,18 @@ sr_error_t sr_ev_data_get(const void *ev_data, uint32_t idx, uint32_t *size, voi
  */
 sr_error_info_t *sr_mutex_init(pthread_mutex_t *lock, int shared);
 
+/**
+ * @brief Start collecting lock call site statistics in this process, there is no way to stop it.
+ */
+void sr_lock_stats_enable(void);
+
+/**
+ * @brief Get lock call site statistics of this process.
+ *
+ * @return Array of ::SR_LOCK_SITE_MAX sites, unused ones with NULL function name.
+ */
+const sr_lock_site_t *sr_lock_stats_sites(void);
+
 /**
  * @brief Lock a mutex.
  *
@@ -1109,6 +1265,37 @@ sr_error_info_t *sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t m
 sr_error_info_t *sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
         sr_lock_recover_cb cb, void *cb_data);
 
+/**
+ * @brief Set whether this thread is processing subscription events. Its readers do not wait for pending writers
+ * with writer preference because the event originator may hold the lock the writer is waiting for.
+ *
+ * @param[in] ev_thread Whether the thread is processing events.
+ * @return Previous value.
+ */
+int sr_rwlock_ev_thread_set(int ev_thread);
+
+/**
+ * @brief Lock a sysrepo RW lock with writer preference, new readers of other connections wait while
+ * a WRITE lock is being waited for. On failure, the lock is not changed in any way.
+ *
+ * Parameters are the same as for ::sr_rwlock().
+ *
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_rwlock_writer_pref(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid,
+        const char *func, sr_lock_recover_cb cb, void *cb_data);
+
+/**
+ * @brief Relock a sysrepo RW lock with writer preference, new readers of other connections wait while
+ * an upgrade is being waited for. On failure, the lock is not changed in any way.
+ *
+ * Parameters are the same as for ::sr_rwrelock().
+ *
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_rwrelock_writer_pref(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid,
+        const char *func, sr_lock_recover_cb cb, void *cb_data);
+
 /**
  * @brief Unlock a sysrepo RW lock. On failure, whatever steps are possible are still performed.
  *
@@ -1155,7 +1342,7 @@ sr_error_info_t *sr_conn_oper_cache_add(sr_conn_ctx_t *conn, uint32_t sub_id, co
 void sr_conn_oper_cache_del(sr_conn_ctx_t *conn, uint32_t sub_id);
 
 /**
- * @brief Flush all cached oper data of a connection.
+ * @brief Flush all cached oper data of a connection, both oper poll subscription data and stored operational edits.
  *
  * @param[in] conn Connection to use.
  */
@@ -1534,6 +1721,30 @@ sr_error_info_t *sr_ly_find_last_parent(struct lyd_node **parent, int nodetype);
  */
 sr_error_info_t *sr_lyd_print_lyb(const struct lyd_node *data, char **str, uint32_t *len);
 
+/**
+ * @brief Print data into an indexed diff (::sr_diff_idx_t) with the LYB data of every top-level subtree.
+ *
+ * @param[in] data Data to print.
+ * @param[out] str Allocated indexed diff.
+ * @param[out] len Length of the indexed diff.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_lyd_print_lyb_idx(const struct lyd_node *data, char **str, uint32_t *len);
+
+/**
+ * @brief Parse the subtrees of an indexed diff that may be selected by an XPath or belong to a module.
+ *
+ * @param[in] ly_ctx libyang context to use.
+ * @param[in] idx_data Indexed diff (::sr_diff_idx_t).
+ * @param[in] module_name Module of the subtrees to parse, used only if @p xpath is not set, all if NULL.
+ * @param[in] xpath Optional XPath selecting the subtrees to parse.
+ * @param[in,out] parsed Flags of the already parsed subtrees, skipped and set for the newly parsed ones.
+ * @param[in,out] data Data to append the parsed subtrees to.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_lyd_parse_lyb_idx(const struct ly_ctx *ly_ctx, const char *idx_data, const char *module_name,
+        const char *xpath, uint8_t *parsed, struct lyd_node **data);
+
 /**
  * @brief Unlink data of a specific module from a data tree.
  *
@@ -1560,11 +1771,30 @@ sr_error_info_t *sr_module_file_data_append(const struct lys_module *ly_mod, con
 /**
  * @brief Load operational data (edit) loaded from a SHM for a specific module.
  *
+ * Updates the stored operational edit cache of the connection, if enabled.
+ *
+ * @param[in] conn Connection to use.
  * @param[in] mod Mod info mod.
  * @param[out] edit Loaded edit to return.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_module_file_oper_data_load(struct sr_mod_info_mod_s *mod, struct lyd_node **edit);
+sr_error_info_t *sr_module_file_oper_data_load(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod,
+        struct lyd_node **edit);
+
+/**
+ * @brief Apply the cached stored operational edit of a module, if still valid.
+ *
+ * The cached edit is valid while the stored edit has not changed and all the connections owning it are alive.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info mod.
+ * @param[in,out] data Data tree to apply the edit on.
+ * @param[out] cached Whether a valid cached edit was found.
+ * @param[out] applied Whether the cached edit was not empty and was applied.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_conn_oper_edit_cache_apply(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod,
+        struct lyd_node **data, int *cached, int *applied);
 
 /**
  * @brief Learn CIDs and PIDs of all the live connections.
@@ -47,6 +47,43 @@ typedef enum {
 /** maximum number of system-wide concurrent connection owners of a read lock */
 #define SR_RWLOCK_READ_LIMIT 10
 
+/**
+ * @brief Sysrepo read-write lock statistics. Updated with the lock mutex held, read without it.
+ */
+typedef struct {
+    ATOMIC64_T read_acq;            /**< Number of acquired READ and READ-UPGR locks. */
+    ATOMIC64_T write_acq;           /**< Number of acquired WRITE locks, including upgrades. */
+    ATOMIC64_T read_wait;           /**< Cumulative time spent waiting for READ and READ-UPGR locks (in us). */
+    ATOMIC64_T write_wait;          /**< Cumulative time spent waiting for WRITE locks (in us). */
+    ATOMIC64_T write_wait_max;      /**< Longest time spent waiting for a WRITE lock (in us). */
+    ATOMIC_T timeouts;              /**< Number of lock attempts that timed out. */
+} sr_rwlock_stats_t;
+
+/** number of log2 buckets of lock time histograms */
+#define SR_LOCK_HIST_BUCKETS 24
+
+/** maximum number of lock call sites with statistics in a process */
+#define SR_LOCK_SITE_MAX 256
+
+/**
+ * @brief Lock time histogram.
+ */
+typedef struct {
+    ATOMIC64_T count;               /**< Number of all the recorded times. */
+    ATOMIC64_T total;               /**< Sum of all the recorded times (in us). */
+    ATOMIC64_T buckets[SR_LOCK_HIST_BUCKETS];   /**< Number of times less than 2^i us (and not less than the previous
+                                                     bucket bound), the last bucket holds all the longer times. */
+} sr_lock_hist_t;
+
+/**
+ * @brief Lock statistics of a lock call site.
+ */
+typedef struct {
+    ATOMIC_PTR_T func;              /**< Function name of the call site, NULL if the item is unused. */
+    sr_lock_hist_t wait;            /**< Times spent waiting for the lock. */
+    sr_lock_hist_t hold;            /**< Times the lock was held. */
+} sr_lock_site_t;
+
 /**
  * @brief Sysrepo read-write lock.
  */
@@ -59,6 +96,10 @@ typedef struct {
     uint8_t read_count[SR_RWLOCK_READ_LIMIT];   /**< Number of recursive read locks of the connection in readers. */
     sr_cid_t upgr;                  /**< CID of the READ-UPGR lock owner if locked, 0 otherwise. */
     sr_cid_t writer;                /**< CID of the WRITE lock owner if locked, 0 otherwise. */
+
+    sr_cid_t wr_pending;            /**< CID of a writer with writer preference waiting for readers to drain, new
+                                         readers of other connections wait until it acquires the lock. */
+    sr_rwlock_stats_t stats;        /**< Lock statistics. */
 } sr_rwlock_t;
 
 /**
@@ -137,11 +178,62 @@ struct sr_conn_ctx_s {
         char *path;                 /**< Operational poll/get subscription path. */
 
         sr_rwlock_t data_lock;      /**< Lock for accessing the data and timestamp. */
-        struct lyd_node *data;      /**< Cached data of a single operational get subscription. */
+        struct lyd_node *data;      /**< Cached data of a single operational get subscription, with
+                                         ::SR_SUBSCR_OPER_POLL_DIFF private pointers of all the nodes hold
+                                         their subtree content hashes. */
         struct timespec timestamp;  /**< Timestamp of the cached operational data. */
     } *oper_caches;                 /**< Operational get subscription data caches. */
     uint32_t oper_cache_count;      /**< Operational get subscription data cache count. */
     sr_rwlock_t oper_cache_lock;    /**< Operational get subscription data cache lock. */
+
+    struct sr_oper_edit_cache_s {
+        const struct lys_module *ly_mod;    /**< Module of the stored operational edit. */
+        uint32_t gen;               /**< Generation of the cached stored operational edit. */
+        struct lyd_node *edit;      /**< Cached stored operational edit. */
+        sr_cid_t *cids;             /**< Connections owning any part of the edit, all alive when cached. */
+        uint32_t cid_count;         /**< Count of owner connections. */
+    } *oper_edit_caches;            /**< Stored operational edit caches, used with ::SR_CONN_CACHE_OPER. */
+    uint32_t oper_edit_cache_count; /**< Stored operational edit cache count. */
+    sr_rwlock_t oper_edit_cache_lock;   /**< Stored operational edit cache lock. */
+
+    pthread_mutex_t commit_lock;    /**< Lock for the group commit queues, used with ::SR_CONN_GROUP_COMMIT. */
+    sr_cond_t commit_cond;          /**< Condition signaled when queued group commit requests change their state. */
+    struct sr_commit_group_s {
+        int active;                 /**< Whether a commit of this datastore is in progress. */
+        struct sr_commit_req_s **reqs;  /**< Commit requests waiting for the active commit to finish. */
+        uint32_t req_count;         /**< Waiting commit request count. */
+    } commit_groups[SR_DS_COUNT];   /**< Group commit queues for each datastore. */
+
+    pthread_mutex_t sub_shm_cache_lock; /**< Lock for accessing the sub SHM cache. */
+    struct sr_sub_shm_cache_s {
+        char *path;                 /**< Path of the cached sub or sub data SHM. */
+        sr_shm_t shm;               /**< Opened and mapped SHM. */
+        uint32_t gen;               /**< Main SHM sub SHM generation the SHM was opened in. */
+        int in_use;                 /**< Whether the SHM is currently used by a thread. */
+        uint32_t last_use;          /**< Value of the use counter when the SHM was last used. */
+    } *sub_shm_cache;               /**< Cache of opened sub and sub data SHMs. */
+    uint32_t sub_shm_cache_count;   /**< Sub SHM cache count. */
+    uint32_t sub_shm_cache_use;     /**< Sub SHM cache use counter, for evicting the least recently used SHMs. */
+    uint32_t sub_shm_cache_gen;     /**< Last seen main SHM sub SHM generation. */
+};
+
+/** commit request waiting to be committed */
+#define SR_COMMIT_REQ_WAIT 0
+/** commit request was committed */
+#define SR_COMMIT_REQ_DONE 1
+/** commit request is to commit its batch of requests */
+#define SR_COMMIT_REQ_LEAD 2
+
+/**
+ * @brief Group commit request of a session.
+ */
+struct sr_commit_req_s {
+    sr_session_ctx_t *session;      /**< Session with the changes to commit. */
+    uint32_t timeout_ms;            /**< Change callback timeout in milliseconds. */
+    int state;                      /**< State of the request. */
+    sr_error_info_t *err_info;      /**< Result of the commit. */
+    struct sr_commit_req_s **batch; /**< Requests to commit, set for ::SR_COMMIT_REQ_LEAD. */
+    uint32_t batch_count;           /**< Count of @p batch requests. */
 };
 
 /**
@@ -169,6 +261,11 @@ struct sr_session_ctx_s {
         char *format;               /**< Event error data format. */
         void *data;                 /**< Event error data. */
     } ev_error;                     /**< Event error for the originator. Valid only if ev is not ::SR_SUB_EV_NONE. */
+    struct {
+        sr_datastore_t ds;          /**< Datastore of the diff. */
+        char *idx;                  /**< Indexed diff (::sr_diff_idx_t) with subtrees not yet parsed into the diff. */
+        uint8_t *parsed;            /**< Flags of the indexed diff subtrees already parsed into the diff. */
+    } ev_diff;                      /**< Change event diff parsed on demand. Valid only if ev is not ::SR_SUB_EV_NONE. */
 
     pthread_mutex_t ptr_lock;       /**< Lock for accessing pointers to subscriptions. */
     sr_subscription_ctx_t **subscriptions;  /**< Array of subscriptions of this session. */
@@ -193,6 +290,41 @@ struct sr_session_ctx_s {
     } notif_buf;                    /**< Notification buffering attributes. */
 };
 
+/** number of RPC/action requests on a single path that can be in-flight concurrently, each in its own sub SHM slot */
+#define SR_RPC_SUB_SLOT_COUNT 8
+
+/**
+ * @brief Type of the subscriptions with events processed by a subscription worker thread.
+ */
+typedef enum {
+    SR_SUBSCR_JOB_CHANGE = 0,       /**< Change subscriptions of a module in a datastore. */
+    SR_SUBSCR_JOB_OPER_GET,         /**< Operational get subscriptions of a module. */
+    SR_SUBSCR_JOB_NOTIF,            /**< Notification subscriptions of a module. */
+    SR_SUBSCR_JOB_RPC               /**< RPC/action subscriptions of an operation in a single sub SHM slot. */
+} sr_subscr_job_type_t;
+
+/**
+ * @brief Worker thread processing state of a group of subscriptions, only a single worker processes the events
+ * of a group at a time so that they are processed in order.
+ */
+typedef enum {
+    SR_SUBSCR_IDLE = 0,             /**< No worker is processing the events. */
+    SR_SUBSCR_BUSY,                 /**< A worker is processing the events. */
+    SR_SUBSCR_BUSY_AGAIN            /**< A worker is processing the events and must check for new ones once finished. */
+} sr_subscr_busy_t;
+
+/**
+ * @brief Schema nodes selected by a subscription XPath, resolved once for a context so that most events can be
+ * filtered without evaluating the XPath.
+ */
+struct sr_xpath_snodes_s {
+    const struct ly_ctx *ly_ctx;    /**< Context the nodes were resolved in, NULL if not resolved. */
+    uint32_t content_id;            /**< Content ID of @p ly_ctx. */
+    const struct lysc_node **snodes;    /**< Schema nodes the XPath can select, NULL if it cannot be used for filtering. */
+    uint32_t snode_count;           /**< Schema node count. */
+    int no_pred;                    /**< Whether the XPath has no predicates and selects any instance of @p snodes. */
+};
+
 /**
  * @brief Sysrepo subscription.
  */
@@ -200,10 +332,13 @@ struct sr_subscription_ctx_s {
     sr_conn_ctx_t *conn;            /**< Connection of the subscription. */
     uint32_t evpipe_num;            /**< Event pipe number of this subscription structure. */
     int evpipe;                     /**< Event pipe opened for reading. */
+    sr_shm_t evpipe_ready;          /**< Event pipe ready bitmap SHM (::sr_evpipe_ready_t). */
     ATOMIC_T thread_running;        /**< Flag whether the thread handling this subscription is running. */
     pthread_t tid;                  /**< Thread ID of the handler thread. */
     sr_rwlock_t subs_lock;          /**< Session-shared lock for accessing the subscriptions. */
     uint32_t last_sub_id;           /**< Subscription ID of the last created subscription. */
+    const struct ly_ctx *snodes_ly_ctx; /**< Context the schema nodes of all the subscription XPaths were resolved in. */
+    uint32_t snodes_content_id;     /**< Content ID of @p snodes_ly_ctx. */
 
     struct modsub_change_s {
         char *module_name;          /**< Module of the subscriptions. */
@@ -211,6 +346,7 @@ struct sr_subscription_ctx_s {
         struct modsub_changesub_s {
             uint32_t sub_id;        /**< Unique subscription ID. */
             char *xpath;            /**< Subscription XPath. */
+            struct sr_xpath_snodes_s xpath_snodes;  /**< Resolved schema nodes of the XPath. */
             uint32_t priority;      /**< Subscription priority. */
             sr_subscr_options_t opts;   /**< Subscription options. */
             sr_module_change_cb cb; /**< Subscription callback. */
@@ -220,10 +356,13 @@ struct sr_subscription_ctx_s {
 
             uint32_t request_id;    /**< Request ID of the last processed request. */
             sr_sub_event_t event;   /**< Type of the last processed event. */
+            int64_t cb_time;        /**< Callback run time of the event being processed (in us), -1 if the callback
+                                         was not called, -2 if the event was not processed by this subscription. */
         } *subs;                    /**< Configuration change subscriptions for each XPath. */
         uint32_t sub_count;         /**< Configuration change module XPath subscription count. */
 
         sr_shm_t sub_shm;           /**< Subscription SHM. */
+        ATOMIC_T busy;              /**< Worker thread processing state of the subscriptions (::sr_subscr_busy_t). */
     } *change_subs;                 /**< Change subscriptions for each module. */
     uint32_t change_sub_count;      /**< Change module subscription count. */
 
@@ -241,6 +380,7 @@ struct sr_subscription_ctx_s {
             sr_shm_t sub_shm;       /**< Subscription SHM. */
         } *subs;                    /**< Operational subscriptions for each XPath. */
         uint32_t sub_count;         /**< Operational module XPath subscription count. */
+        ATOMIC_T busy;              /**< Worker thread processing state of the subscriptions (::sr_subscr_busy_t). */
     } *oper_get_subs;               /**< Operational get subscriptions for each module. */
     uint32_t oper_get_sub_count;    /**< Operational get module subscription count. */
 
@@ -262,20 +402,28 @@ struct sr_subscription_ctx_s {
         struct modsub_notifsub_s {
             uint32_t sub_id;        /**< Unique subscription ID. */
             char *xpath;            /**< Subscription XPath. */
+            struct sr_xpath_snodes_s xpath_snodes;  /**< Resolved schema nodes of the XPath. */
             struct timespec listen_since;   /**< Timestamp of the subscription listening for real-time notifications. */
             struct timespec start_time; /**< Subscription start time. */
             int replayed;           /**< Flag whether the subscription replay is finished. */
             struct timespec stop_time;  /**< Subscription stop time. */
             sr_event_notif_cb cb;   /**< Subscription value callback. */
             sr_event_notif_tree_cb tree_cb; /**< Subscription tree callback. */
+            sr_event_notif_batch_cb batch_cb;   /**< Subscription batch callback. */
+            uint32_t batch_size;    /**< Maximum number of notifications delivered in a batch, 0 for no limit. */
+            uint32_t batch_timeout_us;  /**< Maximum time to defer delivery of a notification for its batch to fill. */
             void *private_data;     /**< Subscription callback private data. */
             sr_session_ctx_t *sess; /**< Subscription session. */
             ATOMIC_T filtered_out;  /**< Number of notifications that were filtered out. */
+            int drop;               /**< Whether the subscription does not block senders and may miss notifications. */
+            ATOMIC_T dropped;       /**< Number of notifications missed because the subscription was lagging. */
         } *subs;                    /**< Notification subscriptions for each XPath. */
         uint32_t sub_count;         /**< Notification module XPath subscription count. */
 
         uint32_t request_id;        /**< Request ID of the last processed request. */
+        struct timespec batch_flush;    /**< Time when the deferred batched notifications must be delivered, if any. */
         sr_shm_t sub_shm;           /**< Subscription SHM. */
+        ATOMIC_T busy;              /**< Worker thread processing state of the subscriptions (::sr_subscr_busy_t). */
     } *notif_subs;                  /**< Notification subscriptions for each module. */
     uint32_t notif_sub_count;       /**< Notification module subscription count. */
 
@@ -285,20 +433,48 @@ struct sr_subscription_ctx_s {
         struct opsub_rpcsub_s {
             uint32_t sub_id;        /**< Unique subscription ID. */
             char *xpath;            /**< Subscription XPath. */
+            struct sr_xpath_snodes_s xpath_snodes;  /**< Resolved schema nodes of the XPath. */
             uint32_t priority;      /**< Subscription priority. */
             sr_rpc_cb cb;           /**< Subscription value callback. */
             sr_rpc_tree_cb tree_cb; /**< Subscription tree callback. */
             void *private_data;     /**< Subscription callback private data. */
             sr_session_ctx_t *sess; /**< Subscription session. */
 
-            uint32_t request_id;    /**< Request ID of the last processed request. */
-            sr_sub_event_t event;   /**< Type of the last processed event. */
+            struct {
+                uint32_t request_id;    /**< Request ID of the last processed request. */
+                sr_sub_event_t event;   /**< Type of the last processed event. */
+            } slots[SR_RPC_SUB_SLOT_COUNT]; /**< Last processed event in each sub SHM slot. */
         } *subs;                    /**< RPC/action subscription for each XPath. */
         uint32_t sub_count;         /**< RPC/action XPath subscription count. */
 
-        sr_shm_t sub_shm;           /**< Subscription SHM. */
+        sr_shm_t sub_shm[SR_RPC_SUB_SLOT_COUNT];    /**< Subscription SHM of each slot. */
+        ATOMIC_T slot_busy[SR_RPC_SUB_SLOT_COUNT];  /**< Whether a worker thread is processing the slot. */
     } *rpc_subs;                    /**< RPC/action subscriptions for each operation. */
     uint32_t rpc_sub_count;         /**< RPC/action operation subscription count. */
+
+    struct sr_apply_req_s {
+        sr_session_ctx_t *sess;     /**< Session with the changes to apply. */
+        uint32_t timeout_ms;        /**< Change callback timeout in milliseconds. */
+        sr_apply_changes_cb cb;     /**< Completion callback. */
+        void *private_data;         /**< Completion callback private data. */
+    } *apply_reqs;                  /**< Pending requests to apply changes asynchronously. */
+    uint32_t apply_req_count;       /**< Pending apply changes request count. */
+    pthread_mutex_t apply_lock;     /**< Lock for accessing the pending apply changes requests. */
+
+    struct sr_subscr_workers_s {
+        pthread_t *tids;            /**< Worker thread IDs. */
+        uint32_t count;             /**< Worker thread count. */
+        pthread_mutex_t lock;       /**< Lock for accessing the jobs and the stop flag. */
+        sr_cond_t cond;             /**< Condition for waiting for new jobs. */
+        struct sr_subscr_job_s {
+            sr_subscr_job_type_t type;  /**< Type of the subscriptions with an event. */
+            char *path;             /**< Module name or RPC/action path of the subscriptions with an event. */
+            sr_datastore_t ds;      /**< Datastore of the change subscriptions with an event. */
+            uint32_t slot;          /**< Sub SHM slot with the RPC/action event. */
+        } *jobs;                    /**< Jobs waiting to be processed by a worker. */
+        uint32_t job_count;         /**< Count of waiting jobs. */
+        int stop;                   /**< Flag for the workers to quit. */
+    } workers;                      /**< Worker threads processing events concurrently, if any. */
 };
 
 /**
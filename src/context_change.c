@@ -37,15 +37,50 @@
 #include "sysrepo.h"
 #include "sysrepo_types.h"
 
+/**
+ * @brief Create a new context with all the modules currently in mod SHM.
+ *
+ * @param[in] conn Connection to use.
+ * @param[out] ly_ctx Created context.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lycc_ctx_new(sr_conn_ctx_t *conn, struct ly_ctx **ly_ctx)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    char *path;
+
+    if ((err_info = sr_ly_ctx_init(conn->opts, conn->ext_cb, conn->ext_cb_data, conn->ext_searchdir, ly_ctx))) {
+        return err_info;
+    }
+    if ((err_info = sr_shmmod_ctx_load_modules(SR_CONN_MOD_SHM(conn), *ly_ctx, NULL))) {
+        if (!strcmp(err_info->err[err_info->err_count - 1].message, "Loading \"ietf-datastores\" module failed.")) {
+            if (!(tmp_err = sr_path_yang_dir(&path))) {
+                sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED,
+                        "YANG modules directory \"%s\" is different than the one used when creating the SHM state. "
+                        "Either change the SHM state files prefix, too, or clear the current SHM state.",
+                        path);
+                free(path);
+            } else {
+                sr_errinfo_merge(&err_info, tmp_err);
+            }
+        }
+        ly_ctx_destroy(*ly_ctx);
+        *ly_ctx = NULL;
+        return err_info;
+    }
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_lycc_lock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const char *func)
 {
-    sr_error_info_t *err_info = NULL, *tmp_err;
+    sr_error_info_t *err_info = NULL;
     sr_main_shm_t *main_shm = SR_CONN_MAIN_SHM(conn);
     sr_lock_mode_t remap_mode = SR_LOCK_NONE;
     struct sr_shmmod_recover_cb_s cb_data;
     struct ly_ctx *new_ctx = NULL;
-    char *path;
 
     cb_data.ly_ctx_p = &conn->ly_ctx;
     cb_data.ds = SR_DS_STARTUP;
@@ -85,27 +120,25 @@ sr_lycc_lock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const c
             goto cleanup_unlock;
         }
 
-        /* context was updated, create a new one with the current modules */
-        if ((err_info = sr_ly_ctx_init(conn->opts, conn->ext_cb, conn->ext_cb_data, conn->ext_searchdir, &new_ctx))) {
-            goto cleanup_unlock;
+        /* context was updated, try to use a context already created by another connection in this process */
+        if (conn->opts & SR_CONN_CTX_SHARED) {
+            new_ctx = sr_ly_ctx_shared_get(conn->opts, main_shm->content_id);
         }
-        if ((err_info = sr_shmmod_ctx_load_modules(SR_CONN_MOD_SHM(conn), new_ctx, NULL))) {
-            if (!strcmp(err_info->err[err_info->err_count - 1].message, "Loading \"ietf-datastores\" module failed.")) {
-                if (!(tmp_err = sr_path_yang_dir(&path))) {
-                    sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED,
-                            "YANG modules directory \"%s\" is different than the one used when creating the SHM state. "
-                            "Either change the SHM state files prefix, too, or clear the current SHM state.",
-                            path);
-                    free(path);
-                } else {
-                    sr_errinfo_merge(&err_info, tmp_err);
-                }
+
+        if (!new_ctx) {
+            /* create a new one with the current modules */
+            if ((err_info = sr_lycc_ctx_new(conn, &new_ctx))) {
+                goto cleanup_unlock;
+            }
+
+            if (conn->opts & SR_CONN_CTX_SHARED) {
+                /* share the new context */
+                sr_ly_ctx_shared_add(conn->opts, main_shm->content_id, &new_ctx);
             }
-            goto cleanup_unlock;
         }
 
         /* use the new context */
-        ly_ctx_destroy(conn->ly_ctx);
+        sr_ly_ctx_release(conn->ly_ctx);
         conn->ly_ctx = new_ctx;
         new_ctx = NULL;
         conn->content_id = main_shm->content_id;
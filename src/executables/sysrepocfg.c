@@ -18,6 +18,7 @@
 
 #include <errno.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -86,6 +87,10 @@ help_print(void)
             "  -n, --not-strict             Silently ignore any unknown data. Accepted by import, edit, rpc, notification,\n"
             "                               copy-from op.\n"
             "  -o, --opaque                 Parse invalid nodes in the edit into opaque nodes. Accepted by edit op.\n"
+            "  -s, --stream                 Parse the data one top-level subtree at a time, the data are validated and\n"
+            "                               stored once all parsed (only \"xml\" and \"lyb\"). STDIN is spooled into\n"
+            "                               a temporary file. The progress is printed with verbosity \"info\" or higher.\n"
+            "                               Accepted by import op.\n"
             "  -p, --depth <depth>          Limit the depth of returned subtrees, 0 (unlimited) by default. Accepted by\n"
             "                               export op.\n"
             "  -t, --timeout <seconds>      Set the timeout for the operation, otherwise the default one is used.\n"
@@ -221,16 +226,60 @@ enum data_type {
 };
 
 static int
-step_load_data(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT format, enum data_type data_type,
-        int not_strict, int opaq, struct lyd_node **data)
+step_spool_stdin(struct ly_in **in)
+{
+    FILE *tmp;
+    char buf[4096];
+    size_t len;
+    int fd;
+    LY_ERR lyrc;
+
+    /* copy STDIN into an unlinked temporary file so that it is mapped the same way as a file path */
+    if (!(tmp = tmpfile())) {
+        error_print(0, "Failed to open temporary file (%s)", strerror(errno));
+        return EXIT_FAILURE;
+    }
+    while ((len = fread(buf, 1, sizeof buf, stdin))) {
+        if (fwrite(buf, 1, len, tmp) < len) {
+            error_print(0, "Error writing into temporary file (%s)", strerror(errno));
+            fclose(tmp);
+            return EXIT_FAILURE;
+        }
+    }
+    if (ferror(stdin)) {
+        error_print(0, "Error reading from file (%s)", strerror(errno));
+        fclose(tmp);
+        return EXIT_FAILURE;
+    }
+    if (fflush(tmp) || ((fd = dup(fileno(tmp))) == -1)) {
+        error_print(0, "Error writing into temporary file (%s)", strerror(errno));
+        fclose(tmp);
+        return EXIT_FAILURE;
+    }
+    fclose(tmp);
+
+    lyrc = ly_in_new_fd(fd, in);
+    if (lyrc == LY_EINVAL) {
+        /* empty input */
+        close(fd);
+        ly_in_new_memory(strdup(""), in);
+    } else if (lyrc) {
+        close(fd);
+        error_print(0, "Failed to create input handler from STDIN");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int
+step_open_input(const char *file_path, int spool, LYD_FORMAT *format, struct ly_in **in)
 {
-    struct ly_in *in;
     char *ptr;
-    int parse_flags;
-    LY_ERR lyrc = 0;
+    LY_ERR lyrc;
 
     /* learn format */
-    if (format == LYD_UNKNOWN) {
+    if (*format == LYD_UNKNOWN) {
         if (!file_path) {
             error_print(0, "When reading data from STDIN, format must be specified");
             return EXIT_FAILURE;
@@ -238,11 +287,11 @@ step_load_data(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT fo
 
         ptr = strrchr(file_path, '.');
         if (ptr && !strcmp(ptr, ".xml")) {
-            format = LYD_XML;
+            *format = LYD_XML;
         } else if (ptr && !strcmp(ptr, ".json")) {
-            format = LYD_JSON;
+            *format = LYD_JSON;
         } else if (ptr && !strcmp(ptr, ".lyb")) {
-            format = LYD_LYB;
+            *format = LYD_LYB;
         } else {
             error_print(0, "Failed to detect format of \"%s\"", file_path);
             return EXIT_FAILURE;
@@ -251,22 +300,41 @@ step_load_data(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT fo
 
     /* get input */
     if (file_path) {
-        lyrc = ly_in_new_filepath(file_path, 0, &in);
+        lyrc = ly_in_new_filepath(file_path, 0, in);
         if (lyrc == LY_EINVAL) {
             /* empty file */
             ptr = strdup("");
-            ly_in_new_memory(ptr, &in);
+            ly_in_new_memory(ptr, in);
         } else if (lyrc) {
             /* error */
             error_print(0, "Failed to create input handler from file \"%s\"", file_path);
             return EXIT_FAILURE;
         }
+    } else if (spool) {
+        if (step_spool_stdin(in)) {
+            return EXIT_FAILURE;
+        }
     } else {
         /* we need to load the data into memory first */
         if (step_read_file(stdin, &ptr)) {
             return EXIT_FAILURE;
         }
-        ly_in_new_memory(ptr, &in);
+        ly_in_new_memory(ptr, in);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int
+step_load_data(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT format, enum data_type data_type,
+        int not_strict, int opaq, struct lyd_node **data)
+{
+    struct ly_in *in;
+    int parse_flags;
+    LY_ERR lyrc = 0;
+
+    if (step_open_input(file_path, 0, &format, &in)) {
+        return EXIT_FAILURE;
     }
 
     /* parse data */
@@ -297,6 +365,72 @@ step_load_data(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT fo
     return EXIT_SUCCESS;
 }
 
+/**
+ * @brief Number of parsed top-level subtrees after which the import progress is printed.
+ *
+ * All the subtrees are still kept in memory because they are stored by a single replace operation, which
+ * cannot be split into separate batches without losing its atomicity and the validation of the whole datastore.
+ */
+#define IMPORT_PROGRESS_CHUNK 1000
+
+static int
+step_load_data_stream(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT format, int not_strict,
+        struct lyd_node **data)
+{
+    struct ly_in *in;
+    struct lyd_node *subtree;
+    uint32_t count = 0;
+    int parse_flags;
+    LY_ERR lyrc;
+
+    *data = NULL;
+
+    if (format == LYD_JSON) {
+        /* JSON subtrees cannot be parsed separately */
+        return step_load_data(ly_ctx, file_path, format, DATA_CONFIG, not_strict, 0, data);
+    }
+    if (step_open_input(file_path, 1, &format, &in)) {
+        return EXIT_FAILURE;
+    }
+    if (format == LYD_JSON) {
+        /* JSON subtrees cannot be parsed separately, detected from the file extension */
+        ly_in_free(in, 1);
+        return step_load_data(ly_ctx, file_path, format, DATA_CONFIG, not_strict, 0, data);
+    }
+
+    /* parse one top-level subtree at a time, the parser keeps no state of the previous ones */
+    parse_flags = LYD_PARSE_NO_STATE | LYD_PARSE_ONLY | LYD_PARSE_SUBTREE | (not_strict ? 0 : LYD_PARSE_STRICT);
+    do {
+        subtree = NULL;
+        lyrc = lyd_parse_data(ly_ctx, NULL, in, format, parse_flags, 0, &subtree);
+        if (subtree) {
+            if (lyd_insert_sibling(*data, subtree, data)) {
+                lyd_free_all(subtree);
+                lyrc = LY_EOTHER;
+                break;
+            }
+            if (!(++count % IMPORT_PROGRESS_CHUNK) && (log_level >= SR_LL_INF)) {
+                fprintf(stderr, "sysrepocfg: parsed %" PRIu32 " subtrees\r", count);
+            }
+        }
+    } while (lyrc == LY_ENOT);
+    ly_in_free(in, 1);
+
+    if ((count >= IMPORT_PROGRESS_CHUNK) && (log_level >= SR_LL_INF)) {
+        fprintf(stderr, "sysrepocfg: parsed %" PRIu32 " subtrees\n", count);
+    }
+
+    if (lyrc) {
+        error_ly_print(ly_ctx);
+        error_print(0, "Data parsing failed");
+        lyd_free_all(*data);
+        *data = NULL;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 static int
 step_create_input_file(LYD_FORMAT format, char *tmp_file)
 {
@@ -337,7 +471,7 @@ step_create_input_file(LYD_FORMAT format, char *tmp_file)
 
 static int
 op_import(sr_session_ctx_t *sess, const char *file_path, const char *module_name, LYD_FORMAT format, int not_strict,
-        int timeout_s)
+        int stream, int timeout_s)
 {
     const struct ly_ctx *ly_ctx;
     struct lyd_node *data;
@@ -345,7 +479,12 @@ op_import(sr_session_ctx_t *sess, const char *file_path, const char *module_name
 
     ly_ctx = sr_acquire_context(sr_session_get_connection(sess));
 
-    if (step_load_data(ly_ctx, file_path, format, DATA_CONFIG, not_strict, 0, &data)) {
+    if (stream) {
+        r = step_load_data_stream(ly_ctx, file_path, format, not_strict, &data);
+    } else {
+        r = step_load_data(ly_ctx, file_path, format, DATA_CONFIG, not_strict, 0, &data);
+    }
+    if (r) {
         rc = EXIT_FAILURE;
         goto cleanup;
     }
@@ -363,13 +502,41 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Number of selected subtrees exported at once when the data can be printed in chunks.
+ */
+#define EXPORT_CHUNK_SIZE 256
+
+/**
+ * @brief Export print context.
+ */
+struct export_ctx {
+    FILE *out;
+    LYD_FORMAT format;
+    int wd_opt;
+};
+
+static int
+export_chunk_cb(sr_session_ctx_t *sess, const struct lyd_node *chunk, void *private_data)
+{
+    struct export_ctx *ctx = private_data;
+
+    (void)sess;
+
+    if (lyd_print_file(ctx->out, chunk, ctx->format, LYD_PRINT_WITHSIBLINGS | ctx->wd_opt)) {
+        return SR_ERR_LY;
+    }
+    return SR_ERR_OK;
+}
+
 static int
 op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name, const char *xpath, LYD_FORMAT format,
         uint32_t max_depth, int wd_opt, int timeout_s)
 {
-    sr_data_t *data;
+    sr_data_t *data = NULL;
     FILE *file = NULL;
-    char *str;
+    char *str = NULL;
+    struct export_ctx ctx;
     int r;
 
     if (format == LYD_UNKNOWN) {
@@ -384,19 +551,30 @@ op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name
         }
     }
 
-    /* get subtrees */
+    /* learn the xpath of the subtrees */
     if (module_name) {
         if (asprintf(&str, "/%s:*", module_name) == -1) {
-            r = SR_ERR_NO_MEMORY;
-        } else {
-            r = sr_get_data(sess, str, max_depth, timeout_s * 1000, 0, &data);
-            free(str);
+            error_print(SR_ERR_NO_MEMORY, "Getting data failed");
+            if (file) {
+                fclose(file);
+            }
+            return EXIT_FAILURE;
         }
-    } else if (xpath) {
-        r = sr_get_data(sess, xpath, max_depth, timeout_s * 1000, 0, &data);
+        xpath = str;
+    } else if (!xpath) {
+        xpath = "/*";
+    }
+
+    if (format == LYD_XML) {
+        /* XML documents can be concatenated so print the data in chunks without getting them all at once */
+        ctx.out = file ? file : stdout;
+        ctx.format = format;
+        ctx.wd_opt = wd_opt;
+        r = sr_get_data_chunks(sess, xpath, max_depth, EXPORT_CHUNK_SIZE, timeout_s * 1000, 0, export_chunk_cb, &ctx);
     } else {
-        r = sr_get_data(sess, "/*", max_depth, timeout_s * 1000, 0, &data);
+        r = sr_get_data(sess, xpath, max_depth, timeout_s * 1000, 0, &data);
     }
+    free(str);
     if (r != SR_ERR_OK) {
         error_print(r, "Getting data failed");
         if (file) {
@@ -405,9 +583,11 @@ op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name
         return EXIT_FAILURE;
     }
 
-    /* print exported data */
-    lyd_print_file(file ? file : stdout, data ? data->tree : NULL, format, LYD_PRINT_WITHSIBLINGS | wd_opt);
-    sr_release_data(data);
+    if (format != LYD_XML) {
+        /* print exported data */
+        lyd_print_file(file ? file : stdout, data ? data->tree : NULL, format, LYD_PRINT_WITHSIBLINGS | wd_opt);
+        sr_release_data(data);
+    }
 
     /* cleanup */
     if (file) {
@@ -479,7 +659,7 @@ op_edit(sr_session_ctx_t *sess, const char *file_path, const char *editor, const
     }
 
     /* use import operation to store edited data */
-    if (op_import(sess, tmp_file, module_name, format, not_strict, timeout_s)) {
+    if (op_import(sess, tmp_file, module_name, format, not_strict, 0, timeout_s)) {
         goto cleanup_unlock;
     }
 
@@ -682,7 +862,8 @@ main(int argc, char **argv)
     LYD_FORMAT format = LYD_UNKNOWN;
     const char *module_name = NULL, *editor = NULL, *file_path = NULL, *xpath = NULL, *ext_data_path = NULL, *op_str;
     char *ptr;
-    int r, rc = EXIT_FAILURE, opt, operation = 0, lock = 0, not_strict = 0, opaq = 0, timeout = 0, wd_opt = 0;
+    int r, rc = EXIT_FAILURE, opt, operation = 0, lock = 0, not_strict = 0, opaq = 0, stream = 0, timeout = 0;
+    int wd_opt = 0;
     uint32_t max_depth = 0;
     struct option options[] = {
         {"help",            no_argument,       NULL, 'h'},
@@ -700,6 +881,7 @@ main(int argc, char **argv)
         {"lock",            no_argument,       NULL, 'l'},
         {"not-strict",      no_argument,       NULL, 'n'},
         {"opaque",          no_argument,       NULL, 'o'},
+        {"stream",          no_argument,       NULL, 's'},
         {"depth",           required_argument, NULL, 'p'},
         {"timeout",         required_argument, NULL, 't'},
         {"defaults",        required_argument, NULL, 'e'},
@@ -715,7 +897,7 @@ main(int argc, char **argv)
 
     /* process options */
     opterr = 0;
-    while ((opt = getopt_long(argc, argv, "hVI::X::E::R::N::C:d:m:x:f:lnop:t:e:c:v:", options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "hVI::X::E::R::N::C:d:m:x:f:lnosp:t:e:c:v:", options, NULL)) != -1) {
         switch (opt) {
         case 'h':
             version_print();
@@ -848,6 +1030,9 @@ main(int argc, char **argv)
         case 'o':
             opaq = 1;
             break;
+        case 's':
+            stream = 1;
+            break;
         case 'p':
             max_depth = strtoul(optarg, &ptr, 10);
             if (ptr[0]) {
@@ -957,7 +1142,7 @@ main(int argc, char **argv)
     /* perform the operation */
     switch (operation) {
     case 'I':
-        rc = op_import(sess, file_path, module_name, format, not_strict, timeout);
+        rc = op_import(sess, file_path, module_name, format, not_strict, stream, timeout);
         break;
     case 'X':
         rc = op_export(sess, file_path, module_name, xpath, format, max_depth, wd_opt, timeout);
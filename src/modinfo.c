@@ -943,13 +943,19 @@ sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, const char *orig_name,
     const char *sub_xpath, **request_xpaths = NULL;
     char *parent_xpath = NULL;
     uint32_t i, j, req_xpath_count = 0;
-    int required, merged;
+    int required, merged, cached = 0, applied = 0;
     struct ly_set *set = NULL;
     struct lyd_node *edit = NULL, *oper_data;
 
-    if (!(get_oper_opts & SR_OPER_NO_STORED)) {
+    if (!(get_oper_opts & SR_OPER_NO_STORED) && (conn->opts & SR_CONN_CACHE_OPER)) {
+        /* apply the cached stored operational edit */
+        if ((err_info = sr_conn_oper_edit_cache_apply(conn, mod, data, &cached, &applied))) {
+            return err_info;
+        }
+    }
+    if (!(get_oper_opts & SR_OPER_NO_STORED) && !cached) {
         /* get stored operational edit */
-        if ((err_info = sr_module_file_oper_data_load(mod, &edit))) {
+        if ((err_info = sr_module_file_oper_data_load(conn, mod, &edit))) {
             return err_info;
         }
     }
@@ -960,7 +966,9 @@ sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, const char *orig_name,
         if (err_info) {
             return err_info;
         }
-
+        applied = 1;
+    }
+    if (applied) {
         /* add any missing NP containers in the data */
         if (lyd_new_implicit_module(data, mod->ly_mod, LYD_IMPLICIT_NO_DEFAULTS, NULL)) {
             sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
@@ -1509,6 +1517,164 @@ cleanup:
 #undef CID_STR_LEN
 }
 
+/**
+ * @brief Add lock statistics nodes to a data tree.
+ *
+ * @param[in] rwlock Lock to read the statistics from.
+ * @param[in] node_name Name of the node with the statistics to create.
+ * @param[in] ds_ident Datastore identity, if set, @p node_name is a list with this key, a container otherwise.
+ * @param[in] parent Parent node of the new node @p node_name\.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_lock_stats(sr_rwlock_t *rwlock, const char *node_name, const char *ds_ident,
+        struct lyd_node *parent)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *stats;
+    struct ly_ctx *ly_ctx;
+
+#define NUM_STR_LEN 24
+    char num_str[NUM_STR_LEN];
+
+    ly_ctx = (struct ly_ctx *)LYD_CTX(parent);
+
+    if (ds_ident) {
+        SR_CHECK_LY_RET(lyd_new_list(parent, NULL, node_name, 0, &stats, ds_ident), ly_ctx, err_info);
+    } else {
+        SR_CHECK_LY_RET(lyd_new_inner(parent, NULL, node_name, 0, &stats), ly_ctx, err_info);
+    }
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(rwlock->stats.read_acq));
+    SR_CHECK_LY_RET(lyd_new_term(stats, NULL, "read-count", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(rwlock->stats.write_acq));
+    SR_CHECK_LY_RET(lyd_new_term(stats, NULL, "write-count", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(rwlock->stats.read_wait));
+    SR_CHECK_LY_RET(lyd_new_term(stats, NULL, "read-wait-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(rwlock->stats.write_wait));
+    SR_CHECK_LY_RET(lyd_new_term(stats, NULL, "write-wait-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(rwlock->stats.write_wait_max));
+    SR_CHECK_LY_RET(lyd_new_term(stats, NULL, "max-write-wait-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu32, (uint32_t)ATOMIC_LOAD_RELAXED(rwlock->stats.timeouts));
+    SR_CHECK_LY_RET(lyd_new_term(stats, NULL, "timeouts", num_str, 0, NULL), ly_ctx, err_info);
+
+    return NULL;
+#undef NUM_STR_LEN
+}
+
+/**
+ * @brief Add change subscription event processing latency nodes to a data tree.
+ *
+ * @param[in] latency Change subscription latency statistics.
+ * @param[in] parent Parent change-sub node.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_change_sub_latency(sr_sub_latency_t *latency, struct lyd_node *parent)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *sr_latency;
+    struct ly_ctx *ly_ctx;
+
+#define NUM_STR_LEN 24
+    char num_str[NUM_STR_LEN];
+
+    ly_ctx = (struct ly_ctx *)LYD_CTX(parent);
+
+    SR_CHECK_LY_RET(lyd_new_inner(parent, NULL, "latency", 0, &sr_latency), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(latency->event_count));
+    SR_CHECK_LY_RET(lyd_new_term(sr_latency, NULL, "event-count", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(latency->queue_time));
+    SR_CHECK_LY_RET(lyd_new_term(sr_latency, NULL, "queue-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(latency->wakeup_time));
+    SR_CHECK_LY_RET(lyd_new_term(sr_latency, NULL, "wakeup-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(latency->cb_count));
+    SR_CHECK_LY_RET(lyd_new_term(sr_latency, NULL, "callback-count", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(latency->cb_time));
+    SR_CHECK_LY_RET(lyd_new_term(sr_latency, NULL, "callback-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(latency->cb_time_max));
+    SR_CHECK_LY_RET(lyd_new_term(sr_latency, NULL, "max-callback-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(latency->result_time));
+    SR_CHECK_LY_RET(lyd_new_term(sr_latency, NULL, "result-time", num_str, 0, NULL), ly_ctx, err_info);
+
+    return NULL;
+#undef NUM_STR_LEN
+}
+
+/**
+ * @brief Add notification subscription backlog nodes to a data tree.
+ *
+ * @param[in] notif_sub Ext SHM notification subscription.
+ * @param[in] notif_shm Notification sub SHM of the module, read-locked.
+ * @param[in] parent Parent notification-sub node.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_notif_sub_backlog(sr_mod_notif_sub_t *notif_sub, sr_notif_sub_shm_t *notif_shm,
+        struct lyd_node *parent)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *sr_backlog;
+    struct ly_ctx *ly_ctx;
+    struct sr_notif_sub_slot_s *slot;
+    struct timespec oldest_ts = {0};
+    uint32_t i, request_id, depth = 0;
+    uint64_t lag = 0;
+
+#define NUM_STR_LEN 24
+    char num_str[NUM_STR_LEN];
+
+    ly_ctx = (struct ly_ctx *)LYD_CTX(parent);
+
+    /* count the stored notifications not yet processed by the subscriber and find the oldest */
+    request_id = ATOMIC_LOAD_RELAXED(notif_sub->request_id);
+    for (i = 0; i < SR_NOTIF_SUB_SLOT_COUNT; ++i) {
+        slot = &notif_shm->slots[i];
+        if (!slot->request_id || ((int32_t)(slot->request_id - request_id) <= 0)) {
+            /* empty or already processed */
+            continue;
+        }
+        if (sr_time_cmp(&slot->publish_ts, &notif_sub->listen_since) < 0) {
+            /* published before the subscription started listening */
+            continue;
+        }
+
+        ++depth;
+        if (SR_TS_IS_ZERO(oldest_ts) || (sr_time_cmp(&slot->publish_ts, &oldest_ts) < 0)) {
+            oldest_ts = slot->publish_ts;
+        }
+    }
+    if (!SR_TS_IS_ZERO(oldest_ts)) {
+        lag = sr_time_since_us(&oldest_ts);
+    }
+
+    SR_CHECK_LY_RET(lyd_new_inner(parent, NULL, "backlog", 0, &sr_backlog), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu32, depth);
+    SR_CHECK_LY_RET(lyd_new_term(sr_backlog, NULL, "queue-depth", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu32, (uint32_t)ATOMIC_LOAD_RELAXED(notif_sub->dropped));
+    SR_CHECK_LY_RET(lyd_new_term(sr_backlog, NULL, "dropped", num_str, 0, NULL), ly_ctx, err_info);
+
+    snprintf(num_str, NUM_STR_LEN, "%" PRIu64, lag);
+    SR_CHECK_LY_RET(lyd_new_term(sr_backlog, NULL, "lag", num_str, 0, NULL), ly_ctx, err_info);
+
+    return NULL;
+#undef NUM_STR_LEN
+}
+
 /**
  * @brief Append a "module" data node with its subscriptions to sysrepo-monitoring data.
  *
@@ -1528,6 +1694,8 @@ sr_modinfo_module_srmon_module(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, struct ly
     sr_mod_oper_get_xpath_sub_t *xpath_sub;
     sr_mod_oper_poll_sub_t *oper_poll_subs;
     sr_mod_notif_sub_t *notif_subs;
+    sr_notif_sub_shm_t *notif_shm = NULL;
+    sr_shm_t shm_notif = SR_SHM_INITIALIZER;
     struct sr_mod_lock_s *shm_lock;
     uint32_t i, j;
 
@@ -1568,6 +1736,12 @@ sr_modinfo_module_srmon_module(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, struct ly
             return err_info;
         }
 
+        /* data-lock-stats */
+        if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_lock->data_lock, "data-lock-stats", sr_ds2ident(ds),
+                sr_mod))) {
+            return err_info;
+        }
+
         /* DS LOCK */
         if ((err_info = sr_mlock(&shm_lock->ds_lock, SR_DS_LOCK_MUTEX_TIMEOUT, __func__, NULL, NULL))) {
             return err_info;
@@ -1607,6 +1781,12 @@ ds_unlock:
         if ((err_info = sr_modinfo_module_srmon_locks_ds(&shm_mod->change_sub[ds].lock, 0, buf, sr_mod))) {
             return err_info;
         }
+
+        /* change-sub-lock-stats */
+        if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_mod->change_sub[ds].lock, "change-sub-lock-stats",
+                sr_ds2ident(ds), sr_mod))) {
+            return err_info;
+        }
     }
 #undef BUF_LEN
 
@@ -1614,16 +1794,25 @@ ds_unlock:
     if ((err_info = sr_modinfo_module_srmon_locks(&shm_mod->oper_get_lock, "oper-get-sub-lock", sr_mod))) {
         return err_info;
     }
+    if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_mod->oper_get_lock, "oper-get-sub-lock-stats", NULL, sr_mod))) {
+        return err_info;
+    }
 
     /* oper-poll-sub-lock */
     if ((err_info = sr_modinfo_module_srmon_locks(&shm_mod->oper_poll_lock, "oper-poll-sub-lock", sr_mod))) {
         return err_info;
     }
+    if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_mod->oper_poll_lock, "oper-poll-sub-lock-stats", NULL, sr_mod))) {
+        return err_info;
+    }
 
     /* notif-sub-lock */
     if ((err_info = sr_modinfo_module_srmon_locks(&shm_mod->notif_lock, "notif-sub-lock", sr_mod))) {
         return err_info;
     }
+    if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_mod->notif_lock, "notif-sub-lock-stats", NULL, sr_mod))) {
+        return err_info;
+    }
 
     /* subscriptions, make implicit */
     SR_CHECK_LY_RET(lyd_new_inner(sr_mod, NULL, "subscriptions", 0, &sr_subs), ly_ctx, err_info);
@@ -1655,6 +1844,11 @@ ds_unlock:
             /* suspended */
             sprintf(buf, "%s", ATOMIC_LOAD_RELAXED(change_subs[i].suspended) ? "true" : "false");
             SR_CHECK_LY_RET(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info);
+
+            /* latency */
+            if ((err_info = sr_modinfo_module_srmon_change_sub_latency(&change_subs[i].latency, sr_sub))) {
+                return err_info;
+            }
         }
     }
 
@@ -1694,21 +1888,53 @@ ds_unlock:
         SR_CHECK_LY_RET(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info);
     }
 
+    if (!shm_mod->notif_sub_count) {
+        return NULL;
+    }
+
+    /* open the notification sub SHM with the stored notifications, it may have just been removed */
+    if ((err_info = sr_shmsub_open_map(conn->mod_shm.addr + shm_mod->name, "notif", -1, &shm_notif))) {
+        /* backlogs not available */
+        sr_errinfo_free(&err_info);
+    } else {
+        notif_shm = (sr_notif_sub_shm_t *)shm_notif.addr;
+
+        /* SUB READ LOCK */
+        if ((err_info = sr_rwlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__, NULL,
+                NULL))) {
+            goto cleanup;
+        }
+    }
+
     notif_subs = (sr_mod_notif_sub_t *)(conn->ext_shm.addr + shm_mod->notif_subs);
     for (i = 0; i < shm_mod->notif_sub_count; ++i) {
         /* notification-sub */
-        SR_CHECK_LY_RET(lyd_new_list(sr_subs, NULL, "notification-sub", 0, &sr_sub), ly_ctx, err_info);
+        SR_CHECK_LY_GOTO(lyd_new_list(sr_subs, NULL, "notification-sub", 0, &sr_sub), ly_ctx, err_info,
+                cleanup_unlock);
 
         /* cid */
         sprintf(buf, "%" PRIu32, notif_subs[i].cid);
-        SR_CHECK_LY_RET(lyd_new_term(sr_sub, NULL, "cid", buf, 0, NULL), ly_ctx, err_info);
+        SR_CHECK_LY_GOTO(lyd_new_term(sr_sub, NULL, "cid", buf, 0, NULL), ly_ctx, err_info, cleanup_unlock);
 
         /* suspended */
         sprintf(buf, "%s", ATOMIC_LOAD_RELAXED(notif_subs[i].suspended) ? "true" : "false");
-        SR_CHECK_LY_RET(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info);
+        SR_CHECK_LY_GOTO(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info, cleanup_unlock);
+
+        /* backlog */
+        if (notif_shm && (err_info = sr_modinfo_module_srmon_notif_sub_backlog(&notif_subs[i], notif_shm, sr_sub))) {
+            goto cleanup_unlock;
+        }
     }
 
-    return NULL;
+cleanup_unlock:
+    if (notif_shm) {
+        /* SUB READ UNLOCK */
+        sr_rwunlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+    }
+
+cleanup:
+    sr_shm_clear(&shm_notif);
+    return err_info;
 }
 
 /**
@@ -1738,6 +1964,9 @@ sr_modinfo_module_srmon_rpc(sr_conn_ctx_t *conn, sr_rpc_t *shm_rpc, struct lyd_n
     if ((err_info = sr_modinfo_module_srmon_locks(&shm_rpc->lock, "sub-lock", sr_rpc))) {
         return err_info;
     }
+    if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_rpc->lock, "sub-lock-stats", NULL, sr_rpc))) {
+        return err_info;
+    }
 
     rpc_sub = (sr_mod_rpc_sub_t *)(conn->ext_shm.addr + shm_rpc->subs);
     for (i = 0; i < shm_rpc->sub_count; ++i) {
@@ -2396,14 +2625,249 @@ sr_modinfo_consolidate(struct sr_mod_info_s *mod_info, int mod_deps, sr_lock_mod
     return NULL;
 }
 
+/**
+ * @brief Collect the changes of a diff that may invalidate references to the data.
+ *
+ * @param[in] diff Diff to process.
+ * @param[in,out] mods Set of modules with any changes.
+ * @param[in,out] snodes Set of schema nodes of the removed or replaced data nodes.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_diff_changes_collect(struct lyd_node *diff, struct ly_set *mods, struct ly_set *snodes)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *root, *node;
+    enum edit_op op;
+    int own_op;
+
+    LY_LIST_FOR(diff, root) {
+        if (ly_set_add(mods, (void *)lyd_owner_module(root), 0, NULL)) {
+            SR_ERRINFO_MEM(&err_info);
+            return err_info;
+        }
+
+        LYD_TREE_DFS_BEGIN(root, node) {
+            op = sr_edit_diff_find_oper(node, 1, &own_op);
+            if (own_op && ((op == EDIT_DELETE) || (op == EDIT_REPLACE))) {
+                if (ly_set_add(snodes, (void *)node->schema, 0, NULL)) {
+                    SR_ERRINFO_MEM(&err_info);
+                    return err_info;
+                }
+            }
+            if (op == EDIT_DELETE) {
+                /* whole subtree removed */
+                LYD_TREE_DFS_continue = 1;
+            }
+            LYD_TREE_DFS_END(root, node);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Simplify a data path into node names only, without any predicates and module prefixes.
+ *
+ * @param[in] path Path to simplify.
+ * @param[out] simple_path Simplified path.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_path_simplify(const char *path, char **simple_path)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i, j, seg_start, depth;
+
+    *simple_path = malloc(strlen(path) + 1);
+    SR_CHECK_MEM_RET(!*simple_path, err_info);
+
+    depth = 0;
+    seg_start = 0;
+    for (i = 0, j = 0; path[i]; ++i) {
+        if (path[i] == '[') {
+            ++depth;
+        } else if (path[i] == ']') {
+            --depth;
+        } else if (depth) {
+            /* predicate */
+        } else if (path[i] == ':') {
+            /* remove the prefix */
+            j = seg_start;
+        } else {
+            (*simple_path)[j++] = path[i];
+            if (path[i] == '/') {
+                seg_start = j;
+            }
+        }
+    }
+    (*simple_path)[j] = '\0';
+
+    return NULL;
+}
+
+/**
+ * @brief Check whether a leafref target path can reference any of the removed or replaced nodes.
+ *
+ * @param[in] target_path Leafref target path.
+ * @param[in] snodes Set of schema nodes of the removed or replaced data nodes.
+ * @param[out] affected Whether the leafref can be affected.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_lref_is_affected(const char *target_path, const struct ly_set *snodes, int *affected)
+{
+    sr_error_info_t *err_info = NULL;
+    char *path = NULL, *snode_path = NULL, *str;
+    uint32_t i, len;
+
+    *affected = 0;
+
+    if (target_path[0] != '/') {
+        /* relative path, the target cannot be learned without the context node */
+        *affected = 1;
+        return NULL;
+    }
+
+    if ((err_info = sr_modinfo_path_simplify(target_path, &path))) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < snodes->count; ++i) {
+        str = lysc_path(snodes->snodes[i], LYSC_PATH_DATA, NULL, 0);
+        SR_CHECK_MEM_GOTO(!str, err_info, cleanup);
+        err_info = sr_modinfo_path_simplify(str, &snode_path);
+        free(str);
+        if (err_info) {
+            goto cleanup;
+        }
+
+        /* the target or one of its parents was removed */
+        len = strlen(snode_path);
+        if (!strncmp(path, snode_path, len) && ((path[len] == '\0') || (path[len] == '/'))) {
+            *affected = 1;
+        }
+        free(snode_path);
+        snode_path = NULL;
+        if (*affected) {
+            break;
+        }
+    }
+
+cleanup:
+    free(path);
+    return err_info;
+}
+
+/**
+ * @brief Check whether an inverse dependency module can be made invalid by the changes in the data.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Inverse dependency module.
+ * @param[in] mods Set of modules with any changes.
+ * @param[in] snodes Set of schema nodes of the removed or replaced data nodes.
+ * @param[out] affected Whether the module can be invalid.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_inv_dep_is_affected(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, const struct ly_set *mods,
+        const struct ly_set *snodes, int *affected)
+{
+    sr_error_info_t *err_info = NULL;
+    char *mod_shm_addr = mod_info->conn->mod_shm.addr;
+    const struct lys_module *ly_mod;
+    sr_dep_t *shm_deps;
+    off_t *shm_target_mods;
+    uint32_t i, j;
+
+    *affected = 0;
+
+    shm_deps = (sr_dep_t *)(mod_shm_addr + mod->shm_mod->deps);
+    for (i = 0; !*affected && (i < mod->shm_mod->dep_count); ++i) {
+        switch (shm_deps[i].type) {
+        case SR_DEP_LREF:
+            /* only removing or changing the target can invalidate a leafref */
+            ly_mod = ly_ctx_get_module_implemented(mod_info->conn->ly_ctx, mod_shm_addr + shm_deps[i].lref.target_module);
+            SR_CHECK_INT_RET(!ly_mod, err_info);
+            if (!ly_set_contains(mods, (void *)ly_mod, NULL)) {
+                break;
+            }
+            if ((err_info = sr_modinfo_lref_is_affected(mod_shm_addr + shm_deps[i].lref.target_path, snodes, affected))) {
+                return err_info;
+            }
+            break;
+        case SR_DEP_INSTID:
+            /* the target can be in any module, only removing any data can invalidate it */
+            if (snodes->count) {
+                *affected = 1;
+            }
+            break;
+        case SR_DEP_XPATH:
+            /* any change in the referenced modules can invalidate an XPath */
+            shm_target_mods = (off_t *)(mod_shm_addr + shm_deps[i].xpath.target_modules);
+            for (j = 0; j < shm_deps[i].xpath.target_mod_count; ++j) {
+                ly_mod = ly_ctx_get_module_implemented(mod_info->conn->ly_ctx, mod_shm_addr + shm_target_mods[j]);
+                SR_CHECK_INT_RET(!ly_mod, err_info);
+                if (ly_set_contains(mods, (void *)ly_mod, NULL)) {
+                    *affected = 1;
+                    break;
+                }
+            }
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Validate data of a single module in mod info.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Module to validate.
+ * @param[in] val_opts Validation options.
+ * @param[in,out] val_diff Diff to merge the changes made by the validation into, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_validate_mod(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, int val_opts,
+        struct lyd_node **val_diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *diff = NULL;
+
+    /* validate this module */
+    if (lyd_validate_module(&mod_info->data, mod->ly_mod, val_opts, val_diff ? &diff : NULL)) {
+        sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
+        SR_ERRINFO_VALID(&err_info);
+        goto cleanup;
+    }
+
+    if (diff) {
+        /* it may not have been modified before */
+        mod->state |= MOD_INFO_CHANGED;
+
+        /* merge the changes made by the validation into our diff */
+        if (lyd_diff_merge_all(val_diff, diff, 0)) {
+            sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    lyd_free_all(diff);
+    return err_info;
+}
+
 sr_error_info_t *
 sr_modinfo_validate(struct sr_mod_info_s *mod_info, int mod_state, int finish_diff)
 {
     sr_error_info_t *err_info = NULL;
     struct sr_mod_info_mod_s *mod;
-    struct lyd_node *diff = NULL;
+    struct lyd_node *val_diff = NULL, *mod_diff = NULL;
+    struct ly_set *mods = NULL, *snodes = NULL, *validated = NULL;
     uint32_t i;
-    int val_opts;
+    int val_opts, inv_dep_check, affected, changed;
 
     assert(!mod_info->data_cached);
     assert(SR_IS_CONVENTIONAL_DS(mod_info->ds) || !finish_diff);
@@ -2414,34 +2878,98 @@ sr_modinfo_validate(struct sr_mod_info_s *mod_info, int mod_state, int finish_di
     } else {
         val_opts = 0;
     }
+
+    /* inverse dependencies of valid data need to be validated only if the changes can affect them */
+    inv_dep_check = ((mod_info->ds == SR_DS_STARTUP) || (mod_info->ds == SR_DS_RUNNING)) &&
+            (mod_state & MOD_INFO_INV_DEP) && !(mod_state & MOD_INFO_REQ);
+
+    /* validate the changed modules first, validation may change them too */
     for (i = 0; i < mod_info->mod_count; ++i) {
         mod = &mod_info->mods[i];
-        if (mod->state & mod_state) {
-            /* validate this module */
-            if (lyd_validate_module(&mod_info->data, mod->ly_mod, val_opts, finish_diff ? &diff : NULL)) {
-                sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
-                SR_ERRINFO_VALID(&err_info);
-                goto cleanup;
+        if (!(mod->state & mod_state)) {
+            continue;
+        }
+        if (inv_dep_check && ((mod->state & MOD_INFO_TYPE_MASK) == MOD_INFO_INV_DEP)) {
+            continue;
+        }
+
+        if ((err_info = sr_modinfo_validate_mod(mod_info, mod, val_opts, finish_diff ? &mod_info->diff :
+                (inv_dep_check ? &val_diff : NULL)))) {
+            goto cleanup;
+        }
+    }
+
+    if (!inv_dep_check) {
+        goto cleanup;
+    }
+
+    /* learn all the changes */
+    if (ly_set_new(&mods) || ly_set_new(&snodes) || ly_set_new(&validated)) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+    if ((err_info = sr_modinfo_diff_changes_collect(mod_info->diff, mods, snodes))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_modinfo_diff_changes_collect(val_diff, mods, snodes))) {
+        goto cleanup;
+    }
+
+    /* validate inverse dependencies that can be affected by the changes, validation may change them so repeat
+     * the check for the rest of them until there are no new changes */
+    do {
+        changed = 0;
+        for (i = 0; i < mod_info->mod_count; ++i) {
+            mod = &mod_info->mods[i];
+            if (((mod->state & MOD_INFO_TYPE_MASK) != MOD_INFO_INV_DEP) || ly_set_contains(validated, mod, NULL)) {
+                continue;
             }
 
-            if (diff) {
-                /* it may not have been modified before */
-                mod->state |= MOD_INFO_CHANGED;
+            if ((err_info = sr_modinfo_inv_dep_is_affected(mod_info, mod, mods, snodes, &affected))) {
+                goto cleanup;
+            }
+            if (!affected) {
+                continue;
+            }
 
-                /* merge the changes made by the validation into our diff */
-                if (lyd_diff_merge_all(&mod_info->diff, diff, 0)) {
-                    sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
-                    goto cleanup;
-                }
+            if (ly_set_add(validated, mod, 1, NULL)) {
+                SR_ERRINFO_MEM(&err_info);
+                goto cleanup;
+            }
+            if ((err_info = sr_modinfo_validate_mod(mod_info, mod, val_opts, &mod_diff))) {
+                goto cleanup;
+            }
+            if (!mod_diff) {
+                continue;
+            }
 
-                lyd_free_all(diff);
-                diff = NULL;
+            /* learn the new changes */
+            if ((err_info = sr_modinfo_diff_changes_collect(mod_diff, mods, snodes))) {
+                goto cleanup;
             }
+            if (finish_diff && lyd_diff_merge_all(&mod_info->diff, mod_diff, 0)) {
+                sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
+                goto cleanup;
+            }
+            lyd_free_all(mod_diff);
+            mod_diff = NULL;
+            changed = 1;
+        }
+    } while (changed);
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (((mod->state & MOD_INFO_TYPE_MASK) == MOD_INFO_INV_DEP) && !ly_set_contains(validated, mod, NULL)) {
+            SR_LOG_DBG("Module \"%s\" data not affected by the changes, skipping validation.", mod->ly_mod->name);
         }
     }
 
 cleanup:
-    lyd_free_all(diff);
+    lyd_free_all(val_diff);
+    lyd_free_all(mod_diff);
+    ly_set_free(mods, NULL);
+    ly_set_free(snodes, NULL);
+    ly_set_free(validated, NULL);
     return err_info;
 }
 
@@ -2761,6 +3289,10 @@ sr_modinfo_get_filter(struct sr_mod_info_s *mod_info, const char *xpath, sr_sess
             switch (session->ev) {
             case SR_SUB_EV_CHANGE:
             case SR_SUB_EV_UPDATE:
+                /* the diff of the module must be parsed */
+                if ((err_info = sr_session_ev_diff_parse(session, mod->ly_mod->name, NULL))) {
+                    goto cleanup;
+                }
                 diff = session->dt[session->ds].diff;
                 if (session->ev != SR_SUB_EV_UPDATE) {
                     break;
@@ -3117,6 +3649,48 @@ cleanup:
     return err_info;
 }
 
+sr_error_info_t *
+sr_modinfo_data_reapply(struct sr_mod_info_s *mod_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_mod_s *mod;
+    uint32_t i;
+
+    assert(!mod_info->data_cached);
+
+    /* free the previous data of the changed modules */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (mod->state & MOD_INFO_CHANGED) {
+            lyd_free_siblings(sr_module_data_unlink(&mod_info->data, mod->ly_mod));
+            mod->state &= ~MOD_INFO_DATA;
+        }
+    }
+
+    /* load their current data */
+    if ((err_info = sr_modinfo_data_load(mod_info, 0, NULL, NULL, 0, 0))) {
+        return err_info;
+    }
+
+    /* apply the diff */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if ((mod->state & MOD_INFO_CHANGED) && lyd_diff_apply_module(&mod_info->data, mod_info->diff, mod->ly_mod,
+                NULL, NULL)) {
+            sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
+            return err_info;
+        }
+    }
+
+    /* the diff is final, the data must still be valid */
+    if (mod_info->ds == SR_DS_CANDIDATE) {
+        err_info = sr_modinfo_add_defaults(mod_info, 0);
+    } else {
+        err_info = sr_modinfo_validate(mod_info, MOD_INFO_CHANGED, 0);
+    }
+    return err_info;
+}
+
 sr_error_info_t *
 sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
 {
@@ -3139,6 +3713,10 @@ sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
                 SR_ERRINFO_DSPLUGIN(&err_info, rc, "store", mod->ds_plg[mod_info->ds]->name, mod->ly_mod->name);
                 goto cleanup;
             }
+            if (mod_info->ds == SR_DS_OPERATIONAL) {
+                /* invalidate all the cached stored operational edits */
+                ATOMIC_INC_RELAXED(mod->shm_mod->oper_edit_gen);
+            }
 
             /* connect them back */
             if (mod_data) {
@@ -56,8 +56,11 @@ struct sr_mod_info_s {
         uint32_t xpath_count;   /**< Count of XPaths. */
         uint32_t state;         /**< Module state (flags). */
         uint32_t request_id;    /**< Request ID of the published event. */
+        uint32_t entry_locks;   /**< Held top-level list instance stripe locks (bit mask) of the main DS. */
     } *mods;                    /**< Relevant modules. */
     uint32_t mod_count;         /**< Modules count. */
+    int entry_locked;           /**< Whether the required modules are only READ-locked with their changed top-level
+                                     list instance stripes locked. */
 };
 
 /**
@@ -307,6 +310,15 @@ sr_error_info_t *sr_modinfo_change_notify_update(struct sr_mod_info_s *mod_info,
  */
 sr_error_info_t *sr_modinfo_generate_config_change_notif(struct sr_mod_info_s *mod_info, sr_session_ctx_t *session);
 
+/**
+ * @brief Reload current data of the changed modules in mod info and apply the diff on them again, used when
+ * the modules were not locked exclusively while the diff was being prepared. The data are validated again.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_modinfo_data_reapply(struct sr_mod_info_s *mod_info);
+
 /**
  * @brief Store data (persistently) from mod info.
  *
@@ -302,7 +302,7 @@ cleanup:
 sr_error_info_t *
 sr_replay_notify(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, const char *xpath,
         const struct timespec *start_time, const struct timespec *stop_time, struct timespec *listen_since,
-        sr_event_notif_cb cb, sr_event_notif_tree_cb tree_cb, void *private_data)
+        sr_event_notif_cb cb, sr_event_notif_tree_cb tree_cb, sr_event_notif_batch_cb batch_cb, void *private_data)
 {
     sr_error_info_t *err_info = NULL;
     const struct srplg_ntf_s *ntf_plg;
@@ -362,8 +362,8 @@ sr_replay_notify(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, con
             SR_CHECK_INT_GOTO(notif_op->schema->nodetype != LYS_NOTIF, err_info, cleanup);
 
             /* call callback */
-            if ((err_info = sr_notif_call_callback(ev_sess, cb, tree_cb, private_data, SR_EV_NOTIF_REPLAY, sub_id,
-                    notif_op, &notif_ts))) {
+            if ((err_info = sr_notif_call_callback(ev_sess, cb, tree_cb, batch_cb, private_data, SR_EV_NOTIF_REPLAY,
+                    sub_id, notif_op, &notif_ts))) {
                 goto cleanup;
             }
         }
@@ -380,8 +380,8 @@ sr_replay_notify(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, con
 replay_complete:
     /* replay is completed */
     sr_time_get(&notif_ts, 0);
-    if ((err_info = sr_notif_call_callback(ev_sess, cb, tree_cb, private_data, SR_EV_NOTIF_REPLAY_COMPLETE, sub_id,
-            NULL, &notif_ts))) {
+    if ((err_info = sr_notif_call_callback(ev_sess, cb, tree_cb, batch_cb, private_data, SR_EV_NOTIF_REPLAY_COMPLETE,
+            sub_id, NULL, &notif_ts))) {
         goto cleanup;
     }
 
@@ -54,11 +54,13 @@ void *sr_notif_buf_thread(void *arg);
  * replayed with a later timestamp because it will be received as a realtime notification.
  * @param[in] callback Notification callback to call.
  * @param[in] tree_callback Notification tree callback to call.
+ * @param[in] batch_callback Notification batch callback to call.
  * @param[in] private_data Notification callback private data.
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_replay_notify(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, const char *xpath,
         const struct timespec *start_time, const struct timespec *stop_time, struct timespec *listen_since,
-        sr_event_notif_cb callback, sr_event_notif_tree_cb tree_callback, void *private_data);
+        sr_event_notif_cb callback, sr_event_notif_tree_cb tree_callback, sr_event_notif_batch_cb batch_callback,
+        void *private_data);
 
 #endif
@@ -565,6 +565,7 @@ sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t
     shm_sub->evpipe_num = evpipe_num;
     ATOMIC_STORE_RELAXED(shm_sub->suspended, 0);
     shm_sub->cid = conn->cid;
+    memset(&shm_sub->latency, 0, sizeof shm_sub->latency);
 
     SR_LOG_DBG("#SHM after (adding change sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
@@ -578,6 +579,8 @@ sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t
 
         /* create the data sub SHM */
         if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1))) {
+            /* mapped sub SHMs cached by connections are no longer valid */
+            ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
             if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1))) {
                 sr_errinfo_merge(&err_info, tmp_err);
             }
@@ -687,6 +690,9 @@ sr_shmext_change_sub_free(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore_t
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
     if (!shm_mod->change_sub[ds].sub_count) {
+        /* mapped sub SHMs cached by connections are no longer valid */
+        ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+
         /* unlink the sub SHM */
         if ((err_info = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1))) {
             goto cleanup;
@@ -761,7 +767,6 @@ sr_shmext_change_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore_t
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     sr_mod_change_sub_t *shm_sub;
-    char *path;
     uint32_t evpipe_num;
 
     assert((has_locks == SR_LOCK_WRITE) || (has_locks == SR_LOCK_READ) || (has_locks == SR_LOCK_NONE));
@@ -825,13 +830,11 @@ sr_shmext_change_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore_t
     }
 
     if (del_evpipe) {
-        /* delete the evpipe file, it could have been already deleted by removing other subscription
+        /* delete the evpipe files, they could have been already deleted by removing other subscription
          * from the same structure */
-        if ((tmp_err = sr_path_evpipe(evpipe_num, &path))) {
+        if ((tmp_err = sr_evpipe_unlink(conn, evpipe_num))) {
             sr_errinfo_merge(&err_info, tmp_err);
         }
-        unlink(path);
-        free(path);
     }
 
     return err_info;
@@ -960,6 +963,8 @@ sr_shmext_oper_get_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_
 
     /* create the data sub SHM */
     if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio)))) {
+        /* mapped sub SHMs cached by connections are no longer valid */
+        ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
         if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio)))) {
             sr_errinfo_merge(&err_info, tmp_err);
         }
@@ -995,6 +1000,9 @@ sr_shmext_oper_get_sub_free(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del
     shm_sub = &((sr_mod_oper_get_sub_t *)(conn->ext_shm.addr + shm_mod->oper_get_subs))[del_idx1];
     xpath_sub = &((sr_mod_oper_get_xpath_sub_t *)(conn->ext_shm.addr + shm_sub->xpath_subs))[del_idx2];
 
+    /* mapped sub SHMs cached by connections are no longer valid */
+    ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+
     /* unlink the sub SHM (first, so that we can use xpath) */
     if ((err_info = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, "oper",
             sr_str_hash(conn->ext_shm.addr + shm_sub->xpath, xpath_sub->priority)))) {
@@ -1095,7 +1103,6 @@ sr_shmext_oper_get_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del
     sr_error_info_t *err_info = NULL, *tmp_err;
     sr_mod_oper_get_sub_t *shm_sub;
     sr_mod_oper_get_xpath_sub_t *xpath_sub;
-    char *path;
     uint32_t evpipe_num;
 
     assert((has_locks == SR_LOCK_WRITE) || (has_locks == SR_LOCK_READ) || (has_locks == SR_LOCK_NONE));
@@ -1161,13 +1168,11 @@ sr_shmext_oper_get_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del
     }
 
     if (del_evpipe) {
-        /* delete the evpipe file, it could have been already deleted by removing other subscription
+        /* delete the evpipe files, they could have been already deleted by removing other subscription
          * from the same structure */
-        if ((tmp_err = sr_path_evpipe(evpipe_num, &path))) {
+        if ((tmp_err = sr_evpipe_unlink(conn, evpipe_num))) {
             sr_errinfo_merge(&err_info, tmp_err);
         }
-        unlink(path);
-        free(path);
     }
 
     return err_info;
@@ -1328,7 +1333,6 @@ sr_shmext_oper_poll_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t de
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     sr_mod_oper_poll_sub_t *shm_subs;
-    char *path;
     uint32_t evpipe_num;
 
     assert((has_locks == SR_LOCK_WRITE) || (has_locks == SR_LOCK_READ) || (has_locks == SR_LOCK_NONE));
@@ -1393,13 +1397,11 @@ sr_shmext_oper_poll_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t de
     }
 
     if (del_evpipe) {
-        /* delete the evpipe file, it could have been already deleted by removing other subscription
+        /* delete the evpipe files, they could have been already deleted by removing other subscription
          * from the same structure */
-        if ((tmp_err = sr_path_evpipe(evpipe_num, &path))) {
+        if ((tmp_err = sr_evpipe_unlink(conn, evpipe_num))) {
             sr_errinfo_merge(&err_info, tmp_err);
         }
-        unlink(path);
-        free(path);
     }
 
     return err_info;
@@ -1407,11 +1409,12 @@ sr_shmext_oper_poll_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t de
 
 sr_error_info_t *
 sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id, const char *xpath, uint32_t evpipe_num,
-        struct timespec *listen_since)
+        int drop, struct timespec *listen_since)
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     off_t xpath_off;
     sr_mod_notif_sub_t *shm_sub;
+    int64_t i;
 
     /* NOTIF SUB WRITE LOCK */
     if ((err_info = sr_rwlock(&shm_mod->notif_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
@@ -1446,19 +1449,36 @@ sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id,
     shm_sub->sub_id = sub_id;
     shm_sub->evpipe_num = evpipe_num;
     ATOMIC_STORE_RELAXED(shm_sub->suspended, 0);
+    shm_sub->drop = drop;
     shm_sub->cid = conn->cid;
+    shm_sub->listen_since = *listen_since;
+    ATOMIC_STORE_RELAXED(shm_sub->request_id, 0);
+    ATOMIC_STORE_RELAXED(shm_sub->dropped, 0);
 
     SR_LOG_DBG("#SHM after (adding notif sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
     if (shm_mod->notif_sub_count == 1) {
         /* create the sub SHM while still holding the locks */
-        if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, "notif", -1, sizeof(sr_sub_shm_t)))) {
+        if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, "notif", -1, sizeof(sr_notif_sub_shm_t)))) {
             goto cleanup_notifsub_ext_unlock;
         }
 
-        /* create the data sub SHM */
-        if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, "notif", -1))) {
+        /* create the data sub SHM of each slot */
+        for (i = 0; i < SR_NOTIF_SUB_SLOT_COUNT; ++i) {
+            if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, "notif", i))) {
+                break;
+            }
+        }
+        if (err_info) {
+            /* mapped sub SHMs cached by connections are no longer valid */
+            ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+            while (i) {
+                --i;
+                if ((tmp_err = sr_shmsub_data_unlink(conn->mod_shm.addr + shm_mod->name, "notif", i))) {
+                    sr_errinfo_merge(&err_info, tmp_err);
+                }
+            }
             if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, "notif", -1))) {
                 sr_errinfo_merge(&err_info, tmp_err);
             }
@@ -1490,6 +1510,7 @@ sr_shmext_notif_sub_free(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del_id
 {
     sr_error_info_t *err_info = NULL;
     sr_mod_notif_sub_t *shm_sub;
+    int64_t i;
 
     shm_sub = &((sr_mod_notif_sub_t *)(conn->ext_shm.addr + shm_mod->notif_subs))[del_idx];
 
@@ -1504,14 +1525,19 @@ sr_shmext_notif_sub_free(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del_id
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
     if (!shm_mod->notif_sub_count) {
+        /* mapped sub SHMs cached by connections are no longer valid */
+        ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+
         /* unlink the sub SHM */
         if ((err_info = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, "notif", -1))) {
             goto cleanup;
         }
 
-        /* unlink the sub data SHM */
-        if ((err_info = sr_shmsub_data_unlink(conn->mod_shm.addr + shm_mod->name, "notif", -1))) {
-            goto cleanup;
+        /* unlink the sub data SHM of each slot */
+        for (i = 0; i < SR_NOTIF_SUB_SLOT_COUNT; ++i) {
+            if ((err_info = sr_shmsub_data_unlink(conn->mod_shm.addr + shm_mod->name, "notif", i))) {
+                goto cleanup;
+            }
         }
     }
 
@@ -1571,7 +1597,6 @@ sr_shmext_notif_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del_id
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     sr_mod_notif_sub_t *shm_subs;
-    char *path;
     uint32_t evpipe_num;
 
     assert((has_locks == SR_LOCK_READ) || (has_locks == SR_LOCK_NONE));
@@ -1632,13 +1657,11 @@ sr_shmext_notif_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del_id
     }
 
     if (del_evpipe) {
-        /* delete the evpipe file, it could have been already deleted by removing other subscription
+        /* delete the evpipe files, they could have been already deleted by removing other subscription
          * from the same structure */
-        if ((tmp_err = sr_path_evpipe(evpipe_num, &path))) {
+        if ((tmp_err = sr_evpipe_unlink(conn, evpipe_num))) {
             sr_errinfo_merge(&err_info, tmp_err);
         }
-        unlink(path);
-        free(path);
     }
 
     return err_info;
@@ -1725,16 +1748,32 @@ sr_shmext_rpc_sub_add(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, u
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
     if (!path_found) {
-        /* create the sub SHM while still holding the locks */
+        /* create the sub SHM and the data sub SHM of every slot while still holding the locks */
         mod_name = sr_get_first_ns(path);
-        if ((err_info = sr_shmsub_create(mod_name, "rpc", sr_str_hash(path, 0), sizeof(sr_multi_sub_shm_t)))) {
-            goto cleanup_rpcsub_ext_unlock;
+        for (i = 0; i < SR_RPC_SUB_SLOT_COUNT; ++i) {
+            if ((err_info = sr_shmsub_create(mod_name, "rpc", sr_str_hash(path, i), sizeof(sr_multi_sub_shm_t)))) {
+                break;
+            }
+            if ((err_info = sr_shmsub_data_create(mod_name, "rpc", sr_str_hash(path, i)))) {
+                if ((tmp_err = sr_shmsub_unlink(mod_name, "rpc", sr_str_hash(path, i)))) {
+                    sr_errinfo_merge(&err_info, tmp_err);
+                }
+                break;
+            }
         }
+        if (err_info) {
+            /* mapped sub SHMs cached by connections are no longer valid */
+            ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
 
-        /* create the data sub SHM */
-        if ((err_info = sr_shmsub_data_create(mod_name, "rpc", sr_str_hash(path, 0)))) {
-            if ((tmp_err = sr_shmsub_unlink(mod_name, "rpc", sr_str_hash(path, 0)))) {
-                sr_errinfo_merge(&err_info, tmp_err);
+            /* unlink the slots created so far */
+            while (i) {
+                --i;
+                if ((tmp_err = sr_shmsub_unlink(mod_name, "rpc", sr_str_hash(path, i)))) {
+                    sr_errinfo_merge(&err_info, tmp_err);
+                }
+                if ((tmp_err = sr_shmsub_data_unlink(mod_name, "rpc", sr_str_hash(path, i)))) {
+                    sr_errinfo_merge(&err_info, tmp_err);
+                }
             }
             goto cleanup_rpcsub_ext_unlock;
         }
@@ -1795,15 +1834,20 @@ sr_shmext_rpc_sub_free(sr_conn_ctx_t *conn, off_t *subs, uint32_t *sub_count, co
     }
 
     if (i == *sub_count) {
-        /* unlink the sub SHM */
+        /* mapped sub SHMs cached by connections are no longer valid */
+        ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+
         mod_name = sr_get_first_ns(path);
-        if ((err_info = sr_shmsub_unlink(mod_name, "rpc", sr_str_hash(path, 0)))) {
-            goto cleanup;
-        }
+        for (i = 0; i < SR_RPC_SUB_SLOT_COUNT; ++i) {
+            /* unlink the sub SHM */
+            if ((err_info = sr_shmsub_unlink(mod_name, "rpc", sr_str_hash(path, i)))) {
+                goto cleanup;
+            }
 
-        /* unlink the sub data SHM */
-        if ((err_info = sr_shmsub_data_unlink(mod_name, "rpc", sr_str_hash(path, 0)))) {
-            goto cleanup;
+            /* unlink the sub data SHM */
+            if ((err_info = sr_shmsub_data_unlink(mod_name, "rpc", sr_str_hash(path, i)))) {
+                goto cleanup;
+            }
         }
     }
 
@@ -1864,7 +1908,6 @@ sr_shmext_rpc_sub_stop(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs,
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     sr_mod_rpc_sub_t *shm_sub;
-    char *evpipe_path;
     uint32_t evpipe_num;
 
     assert((has_locks == SR_LOCK_WRITE) || (has_locks == SR_LOCK_READ) || (has_locks == SR_LOCK_NONE));
@@ -1927,13 +1970,11 @@ sr_shmext_rpc_sub_stop(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs,
     }
 
     if (del_evpipe) {
-        /* delete the evpipe file, it could have been already deleted by removing other subscription
+        /* delete the evpipe files, they could have been already deleted by removing other subscription
          * from the same structure */
-        if ((tmp_err = sr_path_evpipe(evpipe_num, &evpipe_path))) {
+        if ((tmp_err = sr_evpipe_unlink(conn, evpipe_num))) {
             sr_errinfo_merge(&err_info, tmp_err);
         }
-        unlink(evpipe_path);
-        free(evpipe_path);
     }
 
     return err_info;
@@ -2375,6 +2416,57 @@ cleanup_changesub_unlock:
     return err_info;
 }
 
+sr_error_info_t *
+sr_shmext_change_sub_latency_add(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t sub_id,
+        uint32_t queue_time, uint64_t wakeup_time, int64_t cb_time, uint64_t result_time)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    sr_mod_change_sub_t *shm_subs;
+    sr_sub_latency_t *latency;
+    uint32_t i;
+
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
+    SR_CHECK_INT_RET(!shm_mod, err_info);
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        return err_info;
+    }
+
+    /* find the subscription in ext SHM */
+    shm_subs = (sr_mod_change_sub_t *)(conn->ext_shm.addr + shm_mod->change_sub[ds].subs);
+    for (i = 0; i < shm_mod->change_sub[ds].sub_count; ++i) {
+        if (shm_subs[i].sub_id == sub_id) {
+            break;
+        }
+    }
+    if (i == shm_mod->change_sub[ds].sub_count) {
+        /* the subscription may have just been removed */
+        goto cleanup_ext_unlock;
+    }
+
+    /* update the statistics, only this subscriber does it */
+    latency = &shm_subs[i].latency;
+    ATOMIC_INC_RELAXED(latency->event_count);
+    ATOMIC_ADD_RELAXED(latency->queue_time, queue_time);
+    ATOMIC_ADD_RELAXED(latency->wakeup_time, wakeup_time);
+    if (cb_time > -1) {
+        ATOMIC_INC_RELAXED(latency->cb_count);
+        ATOMIC_ADD_RELAXED(latency->cb_time, cb_time);
+        if ((uint64_t)cb_time > ATOMIC_LOAD_RELAXED(latency->cb_time_max)) {
+            ATOMIC_STORE_RELAXED(latency->cb_time_max, cb_time);
+        }
+    }
+    ATOMIC_ADD_RELAXED(latency->result_time, result_time);
+
+cleanup_ext_unlock:
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    return err_info;
+}
+
 sr_error_info_t *
 sr_shmext_oper_get_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, int set_suspended,
         int *get_suspended)
@@ -2591,6 +2683,44 @@ cleanup_notifsub_unlock:
     return err_info;
 }
 
+sr_error_info_t *
+sr_shmext_notif_sub_progress(sr_conn_ctx_t *conn, const struct modsub_notif_s *notif_subs)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    sr_mod_notif_sub_t *shm_subs;
+    uint32_t i, j;
+
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), notif_subs->module_name);
+    SR_CHECK_INT_RET(!shm_mod, err_info);
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        return err_info;
+    }
+
+    /* update all the subscriptions found in ext SHM, only this subscriber does it */
+    shm_subs = (sr_mod_notif_sub_t *)(conn->ext_shm.addr + shm_mod->notif_subs);
+    for (i = 0; i < shm_mod->notif_sub_count; ++i) {
+        for (j = 0; j < notif_subs->sub_count; ++j) {
+            if (shm_subs[i].sub_id == notif_subs->subs[j].sub_id) {
+                break;
+            }
+        }
+        if (j == notif_subs->sub_count) {
+            continue;
+        }
+
+        ATOMIC_STORE_RELAXED(shm_subs[i].request_id, notif_subs->request_id);
+        ATOMIC_STORE_RELAXED(shm_subs[i].dropped, ATOMIC_LOAD_RELAXED(notif_subs->subs[j].dropped));
+    }
+
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_shmext_rpc_sub_suspended(sr_conn_ctx_t *conn, const char *path, uint32_t sub_id, int set_suspended, int *get_suspended)
 {
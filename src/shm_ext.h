@@ -208,11 +208,12 @@ sr_error_info_t *sr_shmext_oper_poll_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm
  * @param[in] sub_id Unique sub ID.
  * @param[in] xpath Subscription XPath.
  * @param[in] evpipe_num Subscription event pipe number.
+ * @param[in] drop Whether the subscription never blocks senders and may miss notifications instead.
  * @param[out] listen_since Timestamp of the moment the subscription is listening for notifications.
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id, const char *xpath,
-        uint32_t evpipe_num, struct timespec *listen_since);
+        uint32_t evpipe_num, int drop, struct timespec *listen_since);
 
 /**
  * @brief Remove main SHM module notification subscription and unlink sub SHM if the last subscription was removed.
@@ -318,6 +319,22 @@ sr_error_info_t *sr_shmext_check_sub_all(sr_conn_ctx_t *conn, const struct ly_ct
 sr_error_info_t *sr_shmext_change_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds,
         uint32_t sub_id, int set_suspended, int *get_suspended);
 
+/**
+ * @brief Add processing latencies of an event into change subscription statistics.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name.
+ * @param[in] ds Subscription datastore.
+ * @param[in] sub_id Subscription ID.
+ * @param[in] queue_time Time the originator waited for the sub SHM lock to publish the event (in us).
+ * @param[in] wakeup_time Time between publishing the event and starting to process it (in us).
+ * @param[in] cb_time Callback run time (in us), -1 if the callback was not called.
+ * @param[in] result_time Time between the callback finishing and the event result being written (in us).
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmext_change_sub_latency_add(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds,
+        uint32_t sub_id, uint32_t queue_time, uint64_t wakeup_time, int64_t cb_time, uint64_t result_time);
+
 /**
  * @brief Get or set operational get subscription suspended state (flag).
  *
@@ -357,6 +374,16 @@ sr_error_info_t *sr_shmext_oper_poll_sub_suspended(sr_conn_ctx_t *conn, const ch
 sr_error_info_t *sr_shmext_notif_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id,
         int set_suspended, int *get_suspended);
 
+/**
+ * @brief Store the notification processing progress of module notification subscriptions in their ext SHM
+ * subscriptions, for monitoring.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] notif_subs Module notification subscriptions.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmext_notif_sub_progress(sr_conn_ctx_t *conn, const struct modsub_notif_s *notif_subs);
+
 /**
  * @brief Get or set RPC/action subscription suspended state (flag).
  *
@@ -64,6 +64,7 @@ static struct {
         struct sr_conn_list_s *_next;   /**< pointer to the next connection in the list */
         sr_cid_t cid;                   /**< CID of a connection in this process */
         int lock_fd;                    /**< locked fd of a connection in this process */
+        int entry_lock;                 /**< whether the connection was created with ::SR_CONN_ENTRY_LOCK */
     } *list_head;                       /**< process connection list head */
 
     pthread_mutex_t create_lock;        /**< lock used for synchronizing new connection creation within the process */
@@ -279,11 +280,12 @@ cleanup:
  * @brief Open and lock a new connection lockfile.
  *
  * @param[in] cid CID of the lockfile.
+ * @param[in] entry_lock Whether the connection was created with ::SR_CONN_ENTRY_LOCK.
  * @param[out] lock_fd Opened lockfile.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_shmmain_conn_new_lockfile(sr_cid_t cid, int *lock_fd)
+sr_shmmain_conn_new_lockfile(sr_cid_t cid, int entry_lock, int *lock_fd)
 {
     sr_error_info_t *err_info = NULL;
     char *new_path = NULL, *path = NULL;
@@ -302,8 +304,8 @@ sr_shmmain_conn_new_lockfile(sr_cid_t cid, int *lock_fd)
     }
 
     /* write the PID into the file for debug, the / helps identify if a
-     * file is unexpectedly reused. */
-    snprintf(buf, sizeof(buf) - 1, "/%ld\n", (long)getpid());
+     * file is unexpectedly reused, other processes also learn the entry lock flag from it */
+    snprintf(buf, sizeof(buf) - 1, "/%ld%s\n", (long)getpid(), entry_lock ? SR_CONN_LOCKFILE_ENTRY_LOCK : "");
     if (write(fd, buf, strlen(buf)) != (ssize_t)strlen(buf)) {
         SR_ERRINFO_SYSERRNO(&err_info, "write");
         goto cleanup;
@@ -344,14 +346,14 @@ cleanup:
 }
 
 sr_error_info_t *
-sr_shmmain_conn_list_add(sr_cid_t cid)
+sr_shmmain_conn_list_add(sr_cid_t cid, int entry_lock)
 {
     sr_error_info_t *err_info = NULL;
     struct sr_conn_list_s *conn_item = NULL;
     int lock_fd = -1;
 
     /* open and lock the connection lockfile */
-    if ((err_info = sr_shmmain_conn_new_lockfile(cid, &lock_fd))) {
+    if ((err_info = sr_shmmain_conn_new_lockfile(cid, entry_lock, &lock_fd))) {
         goto error;
     }
 
@@ -363,6 +365,7 @@ sr_shmmain_conn_list_add(sr_cid_t cid)
     }
     conn_item->cid = cid;
     conn_item->lock_fd = lock_fd;
+    conn_item->entry_lock = entry_lock;
 
     /* CONN LIST LOCK */
     if ((err_info = sr_mlock(&conn_proc.list_lock, SR_CONN_LIST_LOCK_TIMEOUT, __func__, NULL, NULL))) {
@@ -448,6 +451,82 @@ sr_shmmain_conn_list_del(sr_cid_t cid)
     return err_info;
 }
 
+sr_error_info_t *
+sr_shmmain_entry_lock_conn_recount(sr_main_shm_t *main_shm)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_conn_list_s *ptr;
+    sr_cid_t *cids = NULL;
+    uint32_t i, cid_count = 0, count = 0;
+    int own, fd;
+    char *path = NULL, buf[64];
+    ssize_t r;
+
+    /* learn all the alive connections, the lockfiles of dead connections are removed */
+    if ((err_info = sr_conn_info(&cids, NULL, &cid_count, NULL, NULL))) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < cid_count; ++i) {
+        /* CONN LIST LOCK */
+        if ((err_info = sr_mlock(&conn_proc.list_lock, SR_CONN_LIST_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+            goto cleanup;
+        }
+
+        /* the lockfile of a connection of this process must not be opened, closing it would release the lock */
+        own = 0;
+        for (ptr = conn_proc.list_head; ptr; ptr = ptr->_next) {
+            if (ptr->cid == cids[i]) {
+                own = 1;
+                if (ptr->entry_lock) {
+                    ++count;
+                }
+                break;
+            }
+        }
+
+        /* CONN LIST UNLOCK */
+        sr_munlock(&conn_proc.list_lock);
+
+        if (own) {
+            continue;
+        }
+
+        /* read the flag from the lockfile */
+        free(path);
+        if ((err_info = sr_path_conn_lockfile(cids[i], 0, &path))) {
+            goto cleanup;
+        }
+        fd = sr_open(path, O_RDONLY, 0);
+        if (fd == -1) {
+            if (errno == ENOENT) {
+                /* disconnected meanwhile */
+                continue;
+            }
+            SR_ERRINFO_SYSERRPATH(&err_info, "open", path);
+            goto cleanup;
+        }
+        r = read(fd, buf, sizeof buf - 1);
+        close(fd);
+        if (r == -1) {
+            SR_ERRINFO_SYSERRNO(&err_info, "read");
+            goto cleanup;
+        }
+        buf[r] = '\0';
+
+        if (strstr(buf, SR_CONN_LOCKFILE_ENTRY_LOCK)) {
+            ++count;
+        }
+    }
+
+    ATOMIC_STORE_RELAXED(main_shm->entry_lock_conn_count, count);
+
+cleanup:
+    free(cids);
+    free(path);
+    return err_info;
+}
+
 sr_error_info_t *
 sr_shmmain_open(sr_shm_t *shm, int *created)
 {
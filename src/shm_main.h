@@ -65,9 +65,10 @@ sr_error_info_t *sr_shmmain_conn_check(sr_cid_t cid, int *conn_alive, pid_t *pid
  * @brief Add a connection into the process connection list.
  *
  * @param[in] cid Connection ID of the connection to add.
+ * @param[in] entry_lock Whether the connection was created with ::SR_CONN_ENTRY_LOCK.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmmain_conn_list_add(sr_cid_t cid);
+sr_error_info_t *sr_shmmain_conn_list_add(sr_cid_t cid, int entry_lock);
 
 /**
  * @brief Remove a connection from the process connection list.
@@ -77,6 +78,15 @@ sr_error_info_t *sr_shmmain_conn_list_add(sr_cid_t cid);
  */
 sr_error_info_t *sr_shmmain_conn_list_del(sr_cid_t cid);
 
+/**
+ * @brief Count all the alive connections created with ::SR_CONN_ENTRY_LOCK and store the count in main SHM.
+ * Connections that crashed are not counted anymore. Must be called with CREATE LOCK held.
+ *
+ * @param[in] main_shm Main SHM.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmain_entry_lock_conn_recount(sr_main_shm_t *main_shm);
+
 /**
  * @brief Open (and init if needed) main SHM.
  *
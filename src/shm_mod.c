@@ -154,6 +154,7 @@ sr_shmmod_fill(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node *sr_
     char *shm_end;
     size_t feat_i, ds_plugin_i, feat_names_len, ds_plugin_names_len, old_shm_size;
     sr_datastore_t ds;
+    uint32_t i;
 
     smod = SR_SHM_MOD_IDX(shm_mod->addr, shm_mod_idx);
 
@@ -163,9 +164,17 @@ sr_shmmod_fill(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node *sr_
         if ((err_info = sr_rwlock_init(&smod->data_lock_info[ds].data_lock, 1))) {
             return err_info;
         }
+        for (i = 0; i < SR_MOD_ENTRY_LOCK_COUNT; ++i) {
+            if ((err_info = sr_mutex_init(&smod->data_lock_info[ds].entry_locks[i], 1))) {
+                return err_info;
+            }
+        }
         if ((err_info = sr_mutex_init(&smod->data_lock_info[ds].ds_lock, 1))) {
             return err_info;
         }
+        if ((err_info = sr_cond_init(&smod->data_lock_info[ds].ds_lock_cond, 1, 1))) {
+            return err_info;
+        }
     }
     if ((err_info = sr_rwlock_init(&smod->replay_lock, 1))) {
         return err_info;
@@ -271,6 +280,9 @@ sr_shmmod_fill(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node *sr_
         /* copy notif subscriptions */
         smod->notif_subs = old_smod->notif_subs;
         smod->notif_sub_count = old_smod->notif_sub_count;
+
+        /* copy stored operational edit generation */
+        ATOMIC_STORE_RELAXED(smod->oper_edit_gen, ATOMIC_LOAD_RELAXED(old_smod->oper_edit_gen));
     }
 
     return NULL;
@@ -1134,6 +1146,63 @@ sr_shmmod_recover_cb(sr_lock_mode_t mode, sr_cid_t cid, void *data)
     cb_data->ds_plg->recover_cb(ly_mod, cb_data->ds);
 }
 
+/**
+ * @brief Wait until a DS lock held by another session is released.
+ *
+ * @param[in] shm_lock Main SHM module lock.
+ * @param[in] sid Sysrepo session ID of the waiting session.
+ * @param[in,out] timeout_ms Timeout in ms for the waiting, is decreased by the time waited.
+ * @return err_info, NULL on success (even if the timeout elapsed).
+ */
+static sr_error_info_t *
+sr_shmmod_ds_lock_wait(struct sr_mod_lock_s *shm_lock, uint32_t sid, uint32_t *timeout_ms)
+{
+    sr_error_info_t *err_info = NULL;
+    struct timespec start_ts, cur_ts;
+    uint32_t waited_ms = 0;
+    int ret = 0, diff_ms;
+
+    sr_time_get(&start_ts, 0);
+
+    /* DS LOCK */
+    if ((err_info = sr_mlock(&shm_lock->ds_lock, SR_DS_LOCK_MUTEX_TIMEOUT, __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    /* wait until the DS lock is released by the other session, it is signalled by the releasing session */
+    while (!ret && shm_lock->ds_lock_sid && (shm_lock->ds_lock_sid != sid)) {
+        if (waited_ms >= *timeout_ms) {
+            ret = ETIMEDOUT;
+            break;
+        }
+
+        /* COND WAIT */
+        ret = sr_cond_timedwait(&shm_lock->ds_lock_cond, &shm_lock->ds_lock, *timeout_ms - waited_ms);
+        if (ret == EOWNERDEAD) {
+            /* the mutex is held but it must be made consistent */
+            ret = pthread_mutex_consistent(&shm_lock->ds_lock);
+        }
+
+        sr_time_get(&cur_ts, 0);
+        if ((diff_ms = sr_time_sub_ms(&cur_ts, &start_ts)) > 0) {
+            waited_ms = diff_ms;
+        }
+    }
+
+    /* DS UNLOCK */
+    sr_munlock(&shm_lock->ds_lock);
+
+    if (ret == ETIMEDOUT) {
+        /* timeout elapsed, the caller will notice the DS lock still being held */
+        *timeout_ms = 0;
+    } else if (ret) {
+        SR_ERRINFO_COND(&err_info, __func__, ret);
+    } else {
+        *timeout_ms = (waited_ms < *timeout_ms) ? (*timeout_ms - waited_ms) : 0;
+    }
+    return err_info;
+}
+
 /**
  * @brief Lock or relock a mod SHM module.
  *
@@ -1143,19 +1212,20 @@ sr_shmmod_recover_cb(sr_lock_mode_t mode, sr_cid_t cid, void *data)
  * @param[in] timeout_ms Timeout in ms.
  * @param[in] mode Lock mode of the module.
  * @param[in] ds_timeout_ms Timeout in ms for DS-lock in case it is required and locked, if 0 no waiting is performed.
- * @param[in] cid Connection ID.
+ * @param[in] conn Connection to use.
  * @param[in] sid Sysrepo session ID to store.
  * @param[in] ds_plg DS plugin.
  * @param[in] relock Whether some lock is already held or not.
  */
 static sr_error_info_t *
 sr_shmmod_lock(const struct lys_module *ly_mod, sr_datastore_t ds, struct sr_mod_lock_s *shm_lock, uint32_t timeout_ms,
-        sr_lock_mode_t mode, uint32_t ds_timeout_ms, sr_cid_t cid, uint32_t sid, const struct srplg_ds_s *ds_plg, int relock)
+        sr_lock_mode_t mode, uint32_t ds_timeout_ms, sr_conn_ctx_t *conn, uint32_t sid, const struct srplg_ds_s *ds_plg,
+        int relock)
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     struct sr_shmmod_recover_cb_s cb_data;
+    sr_cid_t cid = conn->cid;
     int ds_locked;
-    uint32_t sleep_ms;
 
     /* fill recovery callback information, context cannot be changed */
     cb_data.ly_ctx_p = (struct ly_ctx **)&ly_mod->ctx;
@@ -1165,9 +1235,17 @@ sr_shmmod_lock(const struct lys_module *ly_mod, sr_datastore_t ds, struct sr_mod
 ds_lock_retry:
     ds_locked = 0;
 
-    if (relock) {
+    if (relock && (conn->opts & SR_CONN_DATA_LOCK_WRITER_PREF)) {
+        /* RELOCK */
+        err_info = sr_rwrelock_writer_pref(&shm_lock->data_lock, timeout_ms, mode, cid, __func__, sr_shmmod_recover_cb,
+                &cb_data);
+    } else if (relock) {
         /* RELOCK */
         err_info = sr_rwrelock(&shm_lock->data_lock, timeout_ms, mode, cid, __func__, sr_shmmod_recover_cb, &cb_data);
+    } else if (conn->opts & SR_CONN_DATA_LOCK_WRITER_PREF) {
+        /* LOCK */
+        err_info = sr_rwlock_writer_pref(&shm_lock->data_lock, timeout_ms, mode, cid, __func__, sr_shmmod_recover_cb,
+                &cb_data);
     } else {
         /* LOCK */
         err_info = sr_rwlock(&shm_lock->data_lock, timeout_ms, mode, cid, __func__, sr_shmmod_recover_cb, &cb_data);
@@ -1222,12 +1300,10 @@ revert_lock:
 
     assert(ds_locked);
     if (ds_timeout_ms) {
-        /* sleep for the step/whatever is left and retry */
-        sleep_ms = (ds_timeout_ms >= SR_DS_LOCK_TIMEOUT_STEP) ? SR_DS_LOCK_TIMEOUT_STEP : ds_timeout_ms;
-        if ((err_info = sr_msleep(sleep_ms))) {
+        /* wait for the DS lock to be released and retry */
+        if ((err_info = sr_shmmod_ds_lock_wait(shm_lock, sid, &ds_timeout_ms))) {
             goto cleanup;
         }
-        ds_timeout_ms -= sleep_ms;
         goto ds_lock_retry;
     } else {
         /* timeout elapsed */
@@ -1239,6 +1315,76 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Lock top-level list instance stripes of a mod info module.
+ *
+ * @param[in] mod_info Mod info with the module.
+ * @param[in] mod Mod info module to lock.
+ * @param[in] entry_locks Mask of the stripes to lock, locked in ascending order.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmmod_entry_lock(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, uint32_t entry_locks)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_lock_s *shm_lock;
+    uint32_t i;
+
+    shm_lock = &mod->shm_mod->data_lock_info[mod_info->ds];
+    for (i = 0; i < SR_MOD_ENTRY_LOCK_COUNT; ++i) {
+        if (!(entry_locks & (1U << i)) || (mod->entry_locks & (1U << i))) {
+            continue;
+        }
+
+        /* ENTRY LOCK */
+        if ((err_info = sr_mlock(&shm_lock->entry_locks[i], SR_MOD_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+            return err_info;
+        }
+        mod->entry_locks |= 1U << i;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Unlock the top-level list instance stripes of a mod info module starting from a stripe.
+ *
+ * @param[in] mod_info Mod info with the module.
+ * @param[in] mod Mod info module to unlock.
+ * @param[in] first_lock Mask of the first stripe to unlock, all the following ones are unlocked as well.
+ */
+static void
+sr_shmmod_entry_unlock_from(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, uint32_t first_lock)
+{
+    struct sr_mod_lock_s *shm_lock;
+    uint32_t i;
+
+    shm_lock = &mod->shm_mod->data_lock_info[mod_info->ds];
+    for (i = 0; i < SR_MOD_ENTRY_LOCK_COUNT; ++i) {
+        if ((1U << i) < first_lock) {
+            continue;
+        }
+
+        if (mod->entry_locks & (1U << i)) {
+            /* ENTRY UNLOCK */
+            sr_munlock(&shm_lock->entry_locks[i]);
+            mod->entry_locks &= ~(1U << i);
+        }
+    }
+}
+
+/**
+ * @brief Unlock all the top-level list instance stripes of a mod info module.
+ *
+ * @param[in] mod_info Mod info with the module.
+ * @param[in] mod Mod info module to unlock.
+ */
+static void
+sr_shmmod_entry_unlock(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod)
+{
+    sr_shmmod_entry_unlock_from(mod_info, mod, 1);
+}
+
 /**
  * @brief Lock all modules in a mod info.
  *
@@ -1275,9 +1421,20 @@ sr_shmmod_modinfo_lock(struct sr_mod_info_s *mod_info, sr_datastore_t ds, uint32
             continue;
         }
 
+        if (((mode == SR_LOCK_READ_UPGR) || (mode == SR_LOCK_WRITE)) && (ds == mod_info->ds) &&
+                (ds != SR_DS_OPERATIONAL) && (mod->state & MOD_INFO_REQ) &&
+                ATOMIC_LOAD_RELAXED(SR_CONN_MAIN_SHM(mod_info->conn)->entry_lock_conn_count)) {
+            /* the module data may be changed, prevent any changes of its top-level list instances (an instance
+             * changed by a connection created only after this check is still applied on the current data once
+             * it is WRITE-locked) */
+            if ((err_info = sr_shmmod_entry_lock(mod_info, mod, (1U << SR_MOD_ENTRY_LOCK_COUNT) - 1))) {
+                return err_info;
+            }
+        }
+
         /* MOD LOCK */
         if ((err_info = sr_shmmod_lock(mod->ly_mod, ds, shm_lock, SR_MOD_LOCK_TIMEOUT, mode, ds_timeout_ms,
-                mod_info->conn->cid, sid, mod->ds_plg[ds], 0))) {
+                mod_info->conn, sid, mod->ds_plg[ds], 0))) {
             return err_info;
         }
 
@@ -1318,6 +1475,170 @@ sr_shmmod_modinfo_rdlock(struct sr_mod_info_s *mod_info, int upgradeable, uint32
     return NULL;
 }
 
+sr_error_info_t *
+sr_shmmod_modinfo_entry_rdlock(struct sr_mod_info_s *mod_info, const struct lyd_node *edit, uint32_t sid)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_mod_s *mod;
+    const struct lyd_node *root;
+    uint32_t i, entry_locks;
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (!(mod->state & MOD_INFO_REQ)) {
+            continue;
+        }
+
+        /* learn the stripes of all the changed top-level list instances */
+        entry_locks = 0;
+        LY_LIST_FOR(edit, root) {
+            assert(root->schema && (root->schema->nodetype == LYS_LIST));
+            if (lyd_owner_module(root) == mod->ly_mod) {
+                entry_locks |= 1U << (root->hash % SR_MOD_ENTRY_LOCK_COUNT);
+            }
+        }
+
+        /* ENTRY LOCK */
+        if ((err_info = sr_shmmod_entry_lock(mod_info, mod, entry_locks))) {
+            return err_info;
+        }
+    }
+
+    /* MODULES READ LOCK */
+    if ((err_info = sr_shmmod_modinfo_rdlock(mod_info, 0, sid, 0))) {
+        return err_info;
+    }
+
+    mod_info->entry_locked = 1;
+    return NULL;
+}
+
+/**
+ * @brief Learn the stripes of all the top-level list instances of a module changed by a diff.
+ *
+ * @param[in] diff Diff to use.
+ * @param[in] ly_mod Module of the instances.
+ * @return Bitmask of the stripes, all of them if other nodes of the module are changed.
+ */
+static uint32_t
+sr_shmmod_diff_entry_locks(const struct lyd_node *diff, const struct lys_module *ly_mod)
+{
+    const struct lyd_node *root;
+    uint32_t entry_locks = 0;
+
+    LY_LIST_FOR(diff, root) {
+        if (lyd_owner_module(root) != ly_mod) {
+            continue;
+        }
+        if ((root->schema->nodetype != LYS_LIST) || lysc_is_userordered(root->schema)) {
+            /* affects all the instances */
+            return (1U << SR_MOD_ENTRY_LOCK_COUNT) - 1;
+        }
+        entry_locks |= 1U << (root->hash % SR_MOD_ENTRY_LOCK_COUNT);
+    }
+
+    return entry_locks;
+}
+
+sr_error_info_t *
+sr_shmmod_modinfo_entry_relock(struct sr_mod_info_s *mod_info, uint32_t sid)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_mod_s *mod;
+    struct sr_mod_lock_s *shm_lock;
+    uint32_t i, entry_locks, missing;
+    int relock = 0;
+
+    assert(mod_info->entry_locked);
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if ((mod->state & MOD_INFO_REQ) &&
+                (sr_shmmod_diff_entry_locks(mod_info->diff, mod->ly_mod) & ~mod->entry_locks)) {
+            relock = 1;
+            break;
+        }
+    }
+    if (!relock) {
+        /* all the stripes are locked */
+        return NULL;
+    }
+
+    /* the stripes are always locked before the modules, so the modules must be unlocked first to avoid a dead-lock */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+
+        if (mod->state & MOD_INFO_RLOCK) {
+            /* MOD READ UNLOCK */
+            shm_lock = &mod->shm_mod->data_lock_info[mod_info->ds];
+            sr_rwunlock(&shm_lock->data_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_READ, mod_info->conn->cid, __func__);
+            mod->state &= ~MOD_INFO_RLOCK;
+        }
+        if (mod->state & MOD_INFO_RLOCK2) {
+            /* MOD READ UNLOCK */
+            shm_lock = &mod->shm_mod->data_lock_info[mod_info->ds2];
+            sr_rwunlock(&shm_lock->data_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_READ, mod_info->conn->cid, __func__);
+            mod->state &= ~MOD_INFO_RLOCK2;
+        }
+    }
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (!(mod->state & MOD_INFO_REQ)) {
+            continue;
+        }
+
+        entry_locks = sr_shmmod_diff_entry_locks(mod_info->diff, mod->ly_mod);
+        missing = entry_locks & ~mod->entry_locks;
+        if (!missing) {
+            continue;
+        }
+
+        /* the stripes are always locked in ascending order, so unlock the ones following the first missing one,
+         * any changes of their instances made meanwhile are handled when the diff is applied on the current data */
+        sr_shmmod_entry_unlock_from(mod_info, mod, missing & -missing);
+
+        /* ENTRY LOCK */
+        if ((err_info = sr_shmmod_entry_lock(mod_info, mod, entry_locks | mod->entry_locks))) {
+            return err_info;
+        }
+    }
+
+    /* MODULES READ LOCK */
+    return sr_shmmod_modinfo_rdlock(mod_info, 0, sid, 0);
+}
+
+sr_error_info_t *
+sr_shmmod_modinfo_entry_wrlock(struct sr_mod_info_s *mod_info, uint32_t sid)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+    struct sr_mod_info_mod_s *mod;
+    struct sr_mod_lock_s *shm_lock;
+
+    assert(mod_info->entry_locked);
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        shm_lock = &mod->shm_mod->data_lock_info[mod_info->ds];
+
+        if ((mod->state & (MOD_INFO_RLOCK | MOD_INFO_REQ)) == (MOD_INFO_RLOCK | MOD_INFO_REQ)) {
+            /* MOD READ UNLOCK, other changes of the module may be waiting for the WRITE lock as well */
+            sr_rwunlock(&shm_lock->data_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_READ, mod_info->conn->cid, __func__);
+            mod->state &= ~MOD_INFO_RLOCK;
+
+            /* MOD WRITE LOCK */
+            if ((err_info = sr_shmmod_lock(mod->ly_mod, mod_info->ds, shm_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE,
+                    0, mod_info->conn, sid, mod->ds_plg[mod_info->ds], 0))) {
+                return err_info;
+            }
+            mod->state |= MOD_INFO_WLOCK;
+        }
+    }
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_shmmod_modinfo_wrlock(struct sr_mod_info_s *mod_info, uint32_t sid, uint32_t ds_timeout_ms)
 {
@@ -1357,7 +1678,7 @@ sr_shmmod_modinfo_rdlock_upgrade(struct sr_mod_info_s *mod_info, uint32_t sid, u
         if ((mod->state & (MOD_INFO_RLOCK_UPGR | MOD_INFO_REQ)) == (MOD_INFO_RLOCK_UPGR | MOD_INFO_REQ)) {
             /* MOD WRITE UPGRADE */
             if ((err_info = sr_shmmod_lock(mod->ly_mod, mod_info->ds, shm_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE,
-                    ds_timeout_ms, mod_info->conn->cid, sid, mod->ds_plg[mod_info->ds], 1))) {
+                    ds_timeout_ms, mod_info->conn, sid, mod->ds_plg[mod_info->ds], 1))) {
                 return err_info;
             }
 
@@ -1370,6 +1691,48 @@ sr_shmmod_modinfo_rdlock_upgrade(struct sr_mod_info_s *mod_info, uint32_t sid, u
     return NULL;
 }
 
+sr_error_info_t *
+sr_shmmod_modinfo_ds_lock_check(struct sr_mod_info_s *mod_info, uint32_t sid)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i, ds_lock_sid;
+    struct sr_mod_info_mod_s *mod;
+    struct sr_mod_lock_s *shm_lock;
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        shm_lock = &mod->shm_mod->data_lock_info[mod_info->ds];
+
+        /* only the modules that will be upgraded, their DS lock cannot change while they are read-upgr-locked,
+         * entry-locked modules are checked again when relocked for writing */
+        if (mod_info->entry_locked) {
+            if ((mod->state & (MOD_INFO_RLOCK | MOD_INFO_REQ)) != (MOD_INFO_RLOCK | MOD_INFO_REQ)) {
+                continue;
+            }
+        } else if ((mod->state & (MOD_INFO_RLOCK_UPGR | MOD_INFO_REQ)) != (MOD_INFO_RLOCK_UPGR | MOD_INFO_REQ)) {
+            continue;
+        }
+
+        /* DS LOCK */
+        if ((err_info = sr_mlock(&shm_lock->ds_lock, SR_DS_LOCK_MUTEX_TIMEOUT, __func__, NULL, NULL))) {
+            return err_info;
+        }
+
+        ds_lock_sid = shm_lock->ds_lock_sid;
+
+        /* DS UNLOCK */
+        sr_munlock(&shm_lock->ds_lock);
+
+        if (ds_lock_sid && (ds_lock_sid != sid)) {
+            sr_errinfo_new(&err_info, SR_ERR_LOCKED, "Module \"%s\" is DS-locked by session %" PRIu32 ".",
+                    mod->ly_mod->name, ds_lock_sid);
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_shmmod_modinfo_wrlock_downgrade(struct sr_mod_info_s *mod_info, uint32_t sid)
 {
@@ -1386,7 +1749,7 @@ sr_shmmod_modinfo_wrlock_downgrade(struct sr_mod_info_s *mod_info, uint32_t sid)
         if (mod->state & MOD_INFO_WLOCK) {
             /* MOD READ DOWNGRADE */
             if ((err_info = sr_shmmod_lock(mod->ly_mod, mod_info->ds, shm_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_READ_UPGR,
-                    0, mod_info->conn->cid, sid, mod->ds_plg[mod_info->ds], 1))) {
+                    0, mod_info->conn, sid, mod->ds_plg[mod_info->ds], 1))) {
                 return err_info;
             }
 
@@ -1435,9 +1798,15 @@ sr_shmmod_modinfo_unlock(struct sr_mod_info_s *mod_info)
             sr_rwunlock(&shm_lock->data_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_READ, mod_info->conn->cid, __func__);
         }
 
+        if (mod->entry_locks) {
+            /* ENTRY UNLOCK */
+            sr_shmmod_entry_unlock(mod_info, mod);
+        }
+
         /* clear all flags */
         mod->state &= ~(MOD_INFO_RLOCK | MOD_INFO_RLOCK_UPGR | MOD_INFO_WLOCK | MOD_INFO_RLOCK2);
     }
+    mod_info->entry_locked = 0;
 }
 
 void
@@ -1472,6 +1841,9 @@ sr_shmmod_release_locks(sr_conn_ctx_t *conn, uint32_t sid)
                 /* clear DS lock information */
                 shm_lock->ds_lock_sid = 0;
                 memset(&shm_lock->ds_lock_ts, 0, sizeof shm_lock->ds_lock_ts);
+
+                /* wake up any waiters */
+                sr_cond_broadcast(&shm_lock->ds_lock_cond);
             }
 
             /* DS UNLOCK */
@@ -1485,8 +1857,8 @@ sr_shmmod_release_locks(sr_conn_ctx_t *conn, uint32_t sid)
                 }
 
                 /* MOD WRITE LOCK */
-                if ((err_info = sr_shmmod_lock(ly_mod, ds, shm_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE, 0, conn->cid,
-                        sid, ds_plg, 0))) {
+                if ((err_info = sr_shmmod_lock(ly_mod, ds, shm_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE, 0, conn, sid,
+                        ds_plg, 0))) {
                     sr_errinfo_free(&err_info);
                 } else {
                     /* reset candidate */
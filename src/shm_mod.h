@@ -189,6 +189,16 @@ sr_error_info_t *sr_shmmod_modinfo_wrlock(struct sr_mod_info_s *mod_info, uint32
  */
 sr_error_info_t *sr_shmmod_modinfo_rdlock_upgrade(struct sr_mod_info_s *mod_info, uint32_t sid, uint32_t ds_timeout_ms);
 
+/**
+ * @brief Check that the modules in mod info READ-locked to be upgraded or entry-locked are not DS-locked
+ * by another session.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] sid Sysrepo session ID that must be allowed to modify the modules.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_modinfo_ds_lock_check(struct sr_mod_info_s *mod_info, uint32_t sid);
+
 /**
  * @brief Downgrade WRITE lock on modules in mod info to READ lock.
  * Works only for upgraded READ lock.
@@ -199,6 +209,40 @@ sr_error_info_t *sr_shmmod_modinfo_rdlock_upgrade(struct sr_mod_info_s *mod_info
  */
 sr_error_info_t *sr_shmmod_modinfo_wrlock_downgrade(struct sr_mod_info_s *mod_info, uint32_t sid);
 
+/**
+ * @brief READ lock all modules in mod info and exclusively lock only the stripes of top-level list instances
+ * changed by an edit in the required modules. Changes of different instances of the same modules can then be
+ * prepared concurrently.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] edit Edit with only top-level list instances.
+ * @param[in] sid Sysrepo session ID.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_modinfo_entry_rdlock(struct sr_mod_info_s *mod_info, const struct lyd_node *edit,
+        uint32_t sid);
+
+/**
+ * @brief Lock the stripes of all the top-level list instances changed by the diff in mod info, which may have been
+ * modified by the "update" event since ::sr_shmmod_modinfo_entry_rdlock(). If any stripes are missing, the modules
+ * are READ-unlocked while locking them and their data may be changed meanwhile.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] sid Sysrepo session ID.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_modinfo_entry_relock(struct sr_mod_info_s *mod_info, uint32_t sid);
+
+/**
+ * @brief Relock required modules of mod info locked by ::sr_shmmod_modinfo_entry_rdlock() from READ to WRITE.
+ * The module data may have been changed by other changes meanwhile.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] sid Sysrepo session ID.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_modinfo_entry_wrlock(struct sr_mod_info_s *mod_info, uint32_t sid);
+
 /**
  * @brief Unlock mod info.
  *
@@ -156,6 +156,220 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Remove a SHM from the sub SHM cache of a connection and unmap it.
+ *
+ * @param[in] conn Connection with the cache.
+ * @param[in] idx Index of the cached SHM.
+ */
+static void
+sr_shmsub_cache_del(sr_conn_ctx_t *conn, uint32_t idx)
+{
+    free(conn->sub_shm_cache[idx].path);
+    sr_shm_clear(&conn->sub_shm_cache[idx].shm);
+
+    --conn->sub_shm_cache_count;
+    if (idx < conn->sub_shm_cache_count) {
+        conn->sub_shm_cache[idx] = conn->sub_shm_cache[conn->sub_shm_cache_count];
+    } else if (!conn->sub_shm_cache_count) {
+        free(conn->sub_shm_cache);
+        conn->sub_shm_cache = NULL;
+    }
+}
+
+/**
+ * @brief Open and map a sub or sub data SHM using the sub SHM cache of a connection. The SHM is used exclusively
+ * until released by ::sr_shmsub_cache_release().
+ *
+ * @param[in] conn Connection with the cache.
+ * @param[in] path Path of the SHM.
+ * @param[in] map Whether to map the SHM, otherwise only open it.
+ * @param[out] shm Opened SHM.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_cache_open(sr_conn_ctx_t *conn, const char *path, int map, sr_shm_t *shm)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_sub_shm_cache_s *entry;
+    uint32_t gen, i, lru;
+    void *mem;
+
+    assert(shm->fd == -1);
+
+    /* SUB SHM CACHE LOCK */
+    pthread_mutex_lock(&conn->sub_shm_cache_lock);
+
+    gen = ATOMIC_LOAD_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+    if (gen != conn->sub_shm_cache_gen) {
+        /* some sub SHMs were unlinked, drop all the unused ones mapped before */
+        i = 0;
+        while (i < conn->sub_shm_cache_count) {
+            if (!conn->sub_shm_cache[i].in_use && (conn->sub_shm_cache[i].gen != gen)) {
+                sr_shmsub_cache_del(conn, i);
+                continue;
+            }
+            ++i;
+        }
+        conn->sub_shm_cache_gen = gen;
+    }
+
+    /* try to find it */
+    for (i = 0; i < conn->sub_shm_cache_count; ++i) {
+        entry = &conn->sub_shm_cache[i];
+        if (!entry->in_use && (entry->gen == gen) && !strcmp(entry->path, path)) {
+            entry->in_use = 1;
+            entry->last_use = ++conn->sub_shm_cache_use;
+            *shm = entry->shm;
+            goto cleanup;
+        }
+    }
+
+    /* open it */
+    shm->fd = sr_open(path, O_RDWR, SR_SUB_SHM_PERM);
+    if (shm->fd == -1) {
+        SR_ERRINFO_SYSERRPATH(&err_info, "open", path);
+        goto cleanup;
+    }
+    if (map && (err_info = sr_shm_remap(shm, 0))) {
+        sr_shm_clear(shm);
+        goto cleanup;
+    }
+
+    if (conn->sub_shm_cache_count == SR_SUB_SHM_CACHE_SIZE) {
+        /* evict the least recently used SHM, if possible */
+        lru = conn->sub_shm_cache_count;
+        for (i = 0; i < conn->sub_shm_cache_count; ++i) {
+            if (!conn->sub_shm_cache[i].in_use && ((lru == conn->sub_shm_cache_count) ||
+                    (conn->sub_shm_cache[i].last_use < conn->sub_shm_cache[lru].last_use))) {
+                lru = i;
+            }
+        }
+        if (lru == conn->sub_shm_cache_count) {
+            /* all in use, do not cache it */
+            goto cleanup;
+        }
+        sr_shmsub_cache_del(conn, lru);
+    }
+
+    /* cache it, on failure it is simply not cached */
+    mem = realloc(conn->sub_shm_cache, (conn->sub_shm_cache_count + 1) * sizeof *conn->sub_shm_cache);
+    if (!mem) {
+        goto cleanup;
+    }
+    conn->sub_shm_cache = mem;
+    entry = &conn->sub_shm_cache[conn->sub_shm_cache_count];
+    entry->path = strdup(path);
+    if (!entry->path) {
+        goto cleanup;
+    }
+    entry->shm = *shm;
+    entry->gen = gen;
+    entry->in_use = 1;
+    entry->last_use = ++conn->sub_shm_cache_use;
+    ++conn->sub_shm_cache_count;
+
+cleanup:
+    /* SUB SHM CACHE UNLOCK */
+    pthread_mutex_unlock(&conn->sub_shm_cache_lock);
+    return err_info;
+}
+
+void
+sr_shmsub_cache_release(sr_conn_ctx_t *conn, sr_shm_t *shm)
+{
+    struct sr_sub_shm_cache_s *entry;
+    uint32_t gen, i, j;
+
+    if (shm->fd == -1) {
+        sr_shm_clear(shm);
+        return;
+    }
+
+    /* SUB SHM CACHE LOCK */
+    pthread_mutex_lock(&conn->sub_shm_cache_lock);
+
+    gen = ATOMIC_LOAD_RELAXED(SR_CONN_MAIN_SHM(conn)->sub_shm_gen);
+    for (i = 0; i < conn->sub_shm_cache_count; ++i) {
+        entry = &conn->sub_shm_cache[i];
+        if (!entry->in_use || (entry->shm.fd != shm->fd)) {
+            continue;
+        }
+
+        /* it may have been remapped */
+        entry->shm = *shm;
+        entry->in_use = 0;
+        shm->fd = -1;
+        shm->addr = NULL;
+        shm->size = 0;
+
+        if (!entry->shm.addr || (entry->gen != gen)) {
+            /* no longer valid */
+            sr_shmsub_cache_del(conn, i);
+            break;
+        }
+
+        for (j = 0; j < conn->sub_shm_cache_count; ++j) {
+            if ((j != i) && !conn->sub_shm_cache[j].in_use && !strcmp(conn->sub_shm_cache[j].path, entry->path)) {
+                /* it was opened while in use, keep only one */
+                sr_shmsub_cache_del(conn, i);
+                break;
+            }
+        }
+        break;
+    }
+
+    /* SUB SHM CACHE UNLOCK */
+    pthread_mutex_unlock(&conn->sub_shm_cache_lock);
+
+    /* not cached */
+    sr_shm_clear(shm);
+}
+
+void
+sr_shmsub_cache_flush(sr_conn_ctx_t *conn)
+{
+    while (conn->sub_shm_cache_count) {
+        assert(!conn->sub_shm_cache[0].in_use);
+        sr_shmsub_cache_del(conn, 0);
+    }
+}
+
+/**
+ * @brief Open and map a subscription SHM using the sub SHM cache of a connection.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] name Subscription name (module name).
+ * @param[in] suffix1 First suffix.
+ * @param[in] suffix2 Second suffix, none if set to -1.
+ * @param[in,out] shm Mapped SHM, to be released by ::sr_shmsub_cache_release().
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_cache_open_map(sr_conn_ctx_t *conn, const char *name, const char *suffix1, int64_t suffix2, sr_shm_t *shm)
+{
+    sr_error_info_t *err_info = NULL;
+    char *path = NULL;
+
+    assert(name && suffix1);
+
+    /* already opened */
+    if (shm->fd > -1) {
+        return NULL;
+    }
+
+    /* get the path */
+    if ((err_info = sr_path_sub_shm(name, suffix1, suffix2, &path))) {
+        return err_info;
+    }
+
+    /* open and map it */
+    err_info = sr_shmsub_cache_open(conn, path, 1, shm);
+
+    free(path);
+    return err_info;
+}
+
 sr_error_info_t *
 sr_shmsub_data_create(const char *name, const char *suffix1, int64_t suffix2)
 {
@@ -184,23 +398,25 @@ cleanup:
 }
 
 /**
- * @brief Open and map or only remap a subscription data SHM.
+ * @brief Open and map or only remap a subscription data SHM. If opened, the sub SHM cache of the connection is used.
  *
+ * @param[in] conn Connection to use, needed only if @p shm is not opened.
  * @param[in] name Subscription name (module name).
  * @param[in] suffix1 First suffix.
  * @param[in] suffix2 Second suffix, none if set to -1.
- * @param[in,out] shm Mapped SHM.
+ * @param[in,out] shm Mapped SHM, to be released by ::sr_shmsub_cache_release().
  * @param[in] new_shm_size Resize SHM to this size, if 0 read the size of the SHM file.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_shmsub_data_open_remap(const char *name, const char *suffix1, int64_t suffix2, sr_shm_t *shm, size_t new_shm_size)
+sr_shmsub_data_open_remap(sr_conn_ctx_t *conn, const char *name, const char *suffix1, int64_t suffix2, sr_shm_t *shm,
+        size_t new_shm_size)
 {
     sr_error_info_t *err_info = NULL;
     char *path = NULL;
 
     if (shm->fd == -1) {
-        assert(name && suffix1);
+        assert(conn && name && suffix1);
 
         /* get the path */
         if ((err_info = sr_path_sub_data_shm(name, suffix1, suffix2, &path))) {
@@ -208,23 +424,18 @@ sr_shmsub_data_open_remap(const char *name, const char *suffix1, int64_t suffix2
         }
 
         /* open shared memory */
-        shm->fd = sr_open(path, O_RDWR, SR_SUB_SHM_PERM);
-        if (shm->fd == -1) {
-            SR_ERRINFO_SYSERRPATH(&err_info, "open", path);
+        if ((err_info = sr_shmsub_cache_open(conn, path, 0, shm))) {
             goto cleanup;
         }
     }
 
-    /* map it */
+    /* map it, remapped only if the size differs, on error it is unmapped and removed from the cache on release */
     if ((err_info = sr_shm_remap(shm, new_shm_size))) {
         goto cleanup;
     }
 
 cleanup:
     free(path);
-    if (err_info) {
-        sr_shm_clear(shm);
-    }
     return err_info;
 }
 
@@ -289,9 +500,12 @@ static sr_error_info_t *
 sr_shmsub_notify_new_wrlock(sr_sub_shm_t *sub_shm, const char *shm_name, sr_sub_event_t lock_event, sr_cid_t cid)
 {
     sr_error_info_t *err_info = NULL;
+    struct timespec lock_ts;
     uint32_t request_id;
     int ret;
 
+    sr_time_get(&lock_ts, 0);
+
     /* WRITE LOCK */
     if ((err_info = sr_rwlock(&sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_WRITE, cid, __func__, NULL, NULL))) {
         return err_info;
@@ -349,10 +563,29 @@ sr_shmsub_notify_new_wrlock(sr_sub_shm_t *sub_shm, const char *shm_name, sr_sub_
     }
 
 event_handled:
-    /* we have write lock and the expected event */
+    /* we have write lock and the expected event, remember when we started waiting for it */
+    sub_shm->lock_ts = lock_ts;
     return NULL;
 }
 
+/**
+ * @brief Store the timestamps of publishing a new event into subscription SHM.
+ *
+ * @param[in] sub_shm Subscription SHM, may be multi subscription SHM.
+ */
+static void
+sr_shmsub_notify_publish_ts(sr_sub_shm_t *sub_shm)
+{
+    sr_time_get(&sub_shm->publish_ts, 0);
+    if (sub_shm->lock_ts.tv_sec) {
+        /* time spent waiting for the lock, only for the first event written under it */
+        sub_shm->queue_time = sr_time_sub_us(&sub_shm->publish_ts, &sub_shm->lock_ts);
+        memset(&sub_shm->lock_ts, 0, sizeof sub_shm->lock_ts);
+    } else {
+        sub_shm->queue_time = 0;
+    }
+}
+
 /**
  * @brief Having WRITE lock, wait for subscribers to handle a generated event.
  *
@@ -443,7 +676,7 @@ event_handled:
     sub_shm->lock.writer = cid;
 
     /* remap sub data SHM */
-    if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, -1, shm_data_sub, 0))) {
+    if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, NULL, -1, shm_data_sub, 0))) {
         return err_info;
     }
 
@@ -600,7 +833,7 @@ sr_shmsub_notify_all_wait_wr(struct sr_shmsub_oper_get_sub_s *notify_subs, uint3
 
     for (i = 0; i < notify_count; ++i) {
         /* remap sub data SHM */
-        if ((err_temp = sr_shmsub_data_open_remap(NULL, NULL, -1, &notify_subs[i].shm_data_sub, 0))) {
+        if ((err_temp = sr_shmsub_data_open_remap(NULL, NULL, NULL, -1, &notify_subs[i].shm_data_sub, 0))) {
             sr_errinfo_merge(&err_info, err_temp);
             goto cleanup;
         }
@@ -743,7 +976,7 @@ sr_shmsub_notify_write_event(sr_sub_shm_t *sub_shm, sr_cid_t orig_cid, uint32_t
 
     /* remap if needed */
     if (xpath || data_len) {
-        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, -1, shm_data_sub, orig_size +
+        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, NULL, -1, shm_data_sub, orig_size +
                 (xpath ? sr_strshmlen(xpath) : 0) + data_len))) {
             return err_info;
         }
@@ -769,6 +1002,7 @@ sr_shmsub_notify_write_event(sr_sub_shm_t *sub_shm, sr_cid_t orig_cid, uint32_t
     }
 
     if (event) {
+        sr_shmsub_notify_publish_ts(sub_shm);
         SR_LOG_INF("Published event \"%s\" \"%s\" with ID %" PRIu32 ".", sr_ev2str(event), event_desc, request_id);
     }
     return NULL;
@@ -823,7 +1057,7 @@ sr_shmsub_multi_notify_write_event(sr_multi_sub_shm_t *multi_sub_shm, sr_cid_t o
 
     /* remap if needed */
     if (notif_ts || data_len) {
-        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, -1, shm_data_sub, orig_size +
+        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, NULL, -1, shm_data_sub, orig_size +
                 (notif_ts ? sizeof *notif_ts : 0) + data_len))) {
             return err_info;
         }
@@ -850,6 +1084,7 @@ sr_shmsub_multi_notify_write_event(sr_multi_sub_shm_t *multi_sub_shm, sr_cid_t o
     }
 
     if (event) {
+        sr_shmsub_notify_publish_ts((sr_sub_shm_t *)multi_sub_shm);
         SR_LOG_INF("Published event \"%s\" \"%s\" with ID %" PRIu32 " priority %" PRIu32 " for %" PRIu32 " subscribers.",
                 sr_ev2str(event), event_desc, request_id, priority, subscriber_count);
     }
@@ -1056,7 +1291,8 @@ sr_shmsub_notify_evpipe(uint32_t evpipe_num)
     do {
         ret = write(fd, buf, 1);
     } while (!ret);
-    if (ret == -1) {
+    if ((ret == -1) && (errno != EAGAIN)) {
+        /* full pipe is fine, the subscriber has not yet read the previous bytes */
         SR_ERRINFO_SYSERRNO(&err_info, "write");
         goto cleanup;
     }
@@ -1071,6 +1307,138 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Get the bit of a subscription group in an event pipe ready bitmap.
+ *
+ * @param[in] name Module name or RPC/action path of the subscriptions.
+ * @param[in] type Type of the subscriptions, their sub SHM suffix.
+ * @return Bit index.
+ */
+static uint32_t
+sr_shmsub_ready_bit(const char *name, const char *type)
+{
+    return sr_str_hash(name, sr_str_hash(type, 0)) % (SR_EVPIPE_READY_WORD_COUNT * 32);
+}
+
+/**
+ * @brief Write into a subscriber event pipe to notify it there is a new event and mark the subscription group
+ * with the event in the ready bitmap of the event pipe.
+ *
+ * @param[in] conn Connection to use, its sub SHM cache keeps the ready bitmap mapped.
+ * @param[in] evpipe_num Subscriber event pipe number.
+ * @param[in] name Module name or RPC/action path of the subscriptions.
+ * @param[in] type Type of the subscriptions, their sub SHM suffix.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_notify_evpipe_ready(sr_conn_ctx_t *conn, uint32_t evpipe_num, const char *name, const char *type)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    sr_shm_t shm = SR_SHM_INITIALIZER;
+    sr_evpipe_ready_t *ready;
+    char *path = NULL;
+    uint32_t bit, mask;
+    uint_fast32_t exp, des;
+    int result;
+
+    /* get path to the ready bitmap */
+    if ((err_info = sr_path_evpipe_ready(evpipe_num, &path))) {
+        goto cleanup;
+    }
+
+    /* open and map it, if it does not exist the subscriber processes all its subscriptions on every event */
+    if ((tmp_err = sr_shmsub_cache_open(conn, path, 1, &shm))) {
+        sr_errinfo_free(&tmp_err);
+    } else if (shm.size >= sizeof *ready) {
+        ready = (sr_evpipe_ready_t *)shm.addr;
+        bit = sr_shmsub_ready_bit(name, type);
+        mask = (uint32_t)1 << (bit % 32);
+
+        /* set the bit */
+        exp = ATOMIC_LOAD_RELAXED(ready->words[bit / 32]);
+        while (!(exp & mask)) {
+            des = exp | mask;
+            ATOMIC_COMPARE_EXCHANGE_RELAXED(ready->words[bit / 32], exp, des, result);
+            if (result) {
+                break;
+            }
+        }
+    }
+
+    /* write into the pipe only after the bit is set */
+    if ((err_info = sr_shmsub_notify_evpipe(evpipe_num))) {
+        goto cleanup;
+    }
+
+cleanup:
+    sr_shmsub_cache_release(conn, &shm);
+    free(path);
+    return err_info;
+}
+
+int
+sr_shmsub_listen_ready_claim(sr_subscription_ctx_t *subscr, uint32_t *claimed)
+{
+    sr_evpipe_ready_t *ready = (sr_evpipe_ready_t *)subscr->evpipe_ready.addr;
+    uint_fast32_t exp, des = 0;
+    uint32_t i;
+    int result, any = 0;
+
+    for (i = 0; i < SR_EVPIPE_READY_WORD_COUNT; ++i) {
+        /* clear the word and remember the bits that were set */
+        exp = ATOMIC_LOAD_RELAXED(ready->words[i]);
+        while (exp) {
+            ATOMIC_COMPARE_EXCHANGE_RELAXED(ready->words[i], exp, des, result);
+            if (result) {
+                break;
+            }
+        }
+
+        claimed[i] = exp;
+        if (exp) {
+            any = 1;
+        }
+    }
+
+    return any;
+}
+
+void
+sr_shmsub_listen_ready_unclaim(sr_subscription_ctx_t *subscr, const uint32_t *claimed)
+{
+    sr_evpipe_ready_t *ready = (sr_evpipe_ready_t *)subscr->evpipe_ready.addr;
+    uint_fast32_t exp, des;
+    uint32_t i;
+    int result;
+
+    for (i = 0; i < SR_EVPIPE_READY_WORD_COUNT; ++i) {
+        if (!claimed[i]) {
+            continue;
+        }
+
+        /* set the bits back */
+        exp = ATOMIC_LOAD_RELAXED(ready->words[i]);
+        do {
+            des = exp | claimed[i];
+            ATOMIC_COMPARE_EXCHANGE_RELAXED(ready->words[i], exp, des, result);
+        } while (!result);
+    }
+}
+
+int
+sr_shmsub_listen_ready_is_set(const uint32_t *claimed, const char *name, const char *type)
+{
+    uint32_t bit;
+
+    if (!claimed) {
+        /* no bitmap, everything needs to be processed */
+        return 1;
+    }
+
+    bit = sr_shmsub_ready_bit(name, type);
+    return (claimed[bit / 32] >> (bit % 32)) & 1;
+}
+
 /**
  * @brief Write into change subscribers event pipe to notify them there is a new event.
  *
@@ -1107,7 +1475,8 @@ sr_shmsub_change_notify_evpipe(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mo
 
         /* valid subscription */
         if (shm_sub[i].priority == priority) {
-            if ((err_info = sr_shmsub_notify_evpipe(shm_sub[i].evpipe_num))) {
+            if ((err_info = sr_shmsub_notify_evpipe_ready(conn, shm_sub[i].evpipe_num, mod->ly_mod->name,
+                    sr_ds2str(ds)))) {
                 goto cleanup;
             }
         }
@@ -1194,15 +1563,13 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, const char *orig_
         }
 
         /* prepare diff to write into SHM */
-        if (!diff_lyb && lyd_print_mem(&diff_lyb, mod_info->diff, LYD_LYB, LYD_PRINT_SHRINK | LYD_PRINT_WITHSIBLINGS)) {
-            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
-            SR_ERRINFO_INT(&err_info);
+        if (!diff_lyb && (err_info = sr_lyd_print_lyb_idx(mod_info->diff, &diff_lyb, &diff_lyb_len))) {
             goto cleanup;
         }
-        diff_lyb_len = lyd_lyb_data_length(diff_lyb);
 
         /* open sub SHM and map it */
-        if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_sub))) {
+        if ((err_info = sr_shmsub_cache_open_map(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_sub))) {
             goto cleanup;
         }
         multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
@@ -1213,7 +1580,8 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, const char *orig_
         }
 
         /* open sub data SHM */
-        if ((err_info = sr_shmsub_data_open_remap(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_data_sub, 0))) {
+        if ((err_info = sr_shmsub_data_open_remap(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_data_sub, 0))) {
             goto cleanup_wrunlock;
         }
 
@@ -1290,8 +1658,8 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, const char *orig_
         /* SUB WRITE UNLOCK */
         sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
 
-        sr_shm_clear(&shm_sub);
-        sr_shm_clear(&shm_data_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     }
 
     /* success */
@@ -1304,8 +1672,8 @@ cleanup_wrunlock:
 cleanup:
     free(aux);
     free(diff_lyb);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     if (err_info || *cb_err_info) {
         lyd_free_all(*update_edit);
         *update_edit = NULL;
@@ -1327,7 +1695,8 @@ sr_shmsub_change_notify_clear(struct sr_mod_info_s *mod_info)
 
     while ((mod = sr_modinfo_next_mod(mod, mod_info, mod_info->diff, &aux))) {
         /* open sub SHM and map it */
-        if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_sub))) {
+        if ((err_info = sr_shmsub_cache_open_map(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_sub))) {
             goto cleanup;
         }
         multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
@@ -1355,7 +1724,7 @@ sr_shmsub_change_notify_clear(struct sr_mod_info_s *mod_info)
         sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
 
         /* this module event succeeded, let us check the next one */
-        sr_shm_clear(&shm_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_sub);
     }
 
     /* we have not found the failed sub SHM */
@@ -1368,7 +1737,7 @@ cleanup_wrunlock:
 
 cleanup:
     free(aux);
-    sr_shm_clear(&shm_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_sub);
     return err_info;
 }
 
@@ -1417,12 +1786,13 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
         }
 
         /* prepare the diff to write into subscription SHM */
-        if (!diff_lyb && (err_info = sr_lyd_print_lyb(mod_info->diff, &diff_lyb, &diff_lyb_len))) {
+        if (!diff_lyb && (err_info = sr_lyd_print_lyb_idx(mod_info->diff, &diff_lyb, &diff_lyb_len))) {
             goto cleanup;
         }
 
         /* open sub SHM and map it */
-        if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_sub))) {
+        if ((err_info = sr_shmsub_cache_open_map(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_sub))) {
             goto cleanup;
         }
         multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
@@ -1433,7 +1803,8 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
         }
 
         /* open sub data SHM */
-        if ((err_info = sr_shmsub_data_open_remap(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_data_sub, 0))) {
+        if ((err_info = sr_shmsub_data_open_remap(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_data_sub, 0))) {
             goto cleanup_wrunlock;
         }
 
@@ -1485,8 +1856,8 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
         sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
 
         /* next module */
-        sr_shm_clear(&shm_sub);
-        sr_shm_clear(&shm_data_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     }
 
     /* success */
@@ -1499,26 +1870,33 @@ cleanup_wrunlock:
 cleanup:
     free(aux);
     free(diff_lyb);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     return err_info;
 }
 
 sr_error_info_t *
 sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *orig_name, const void *orig_data,
-        uint32_t timeout_ms)
+        uint32_t timeout_ms, int unlock_mods)
 {
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
     sr_multi_sub_shm_t *multi_sub_shm;
     struct sr_mod_info_mod_s *mod = NULL;
-    uint32_t cur_priority, subscriber_count, diff_lyb_len, *aux = NULL;
+    uint32_t i, cur_priority, subscriber_count, diff_lyb_len, *aux = NULL, ev_mod_count = 0;
     char *diff_lyb = NULL;
-    sr_shm_t shm_sub = SR_SHM_INITIALIZER, shm_data_sub = SR_SHM_INITIALIZER;
+    sr_shm_t shm_data_sub = SR_SHM_INITIALIZER;
+    struct {
+        struct sr_mod_info_mod_s *mod;
+        sr_shm_t shm_sub;
+        int locked;
+    } *ev_mods = NULL;
+    void *mem;
     int opts;
     sr_cid_t cid;
 
     cid = mod_info->conn->cid;
 
+    /* learn all the modules with subscribers interested in the event */
     while ((mod = sr_modinfo_next_mod(mod, mod_info, mod_info->diff, &aux))) {
         /* first check that there actually are some value changes (and not only dflt changes) */
         if (!sr_shmsub_change_notify_diff_has_changes(mod, mod_info->diff)) {
@@ -1530,7 +1908,44 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
             continue;
         }
 
+        mem = realloc(ev_mods, (ev_mod_count + 1) * sizeof *ev_mods);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+        ev_mods = mem;
+        ev_mods[ev_mod_count].mod = mod;
+        ev_mods[ev_mod_count].shm_sub = (sr_shm_t)SR_SHM_INITIALIZER;
+        ev_mods[ev_mod_count].locked = 0;
+        ++ev_mod_count;
+    }
+
+    if (unlock_mods) {
+        /* reserve the subscriptions for the event while the modules are still locked, in the order of the changes */
+        for (i = 0; i < ev_mod_count; ++i) {
+            /* open sub SHM and map it */
+            if ((err_info = sr_shmsub_cache_open_map(mod_info->conn, ev_mods[i].mod->ly_mod->name,
+                    sr_ds2str(mod_info->ds), -1, &ev_mods[i].shm_sub))) {
+                goto cleanup;
+            }
+
+            /* SUB WRITE LOCK */
+            if ((err_info = sr_shmsub_notify_new_wrlock((sr_sub_shm_t *)ev_mods[i].shm_sub.addr,
+                    ev_mods[i].mod->ly_mod->name, 0, cid))) {
+                goto cleanup;
+            }
+            ev_mods[i].locked = 1;
+        }
+
+        /* MODULES UNLOCK */
+        sr_shmmod_modinfo_unlock(mod_info);
+    }
+
+    for (i = 0; i < ev_mod_count; ++i) {
+        mod = ev_mods[i].mod;
+
         /* correctly start the loop, with fake last priority 1 higher than the actual highest */
+        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_DONE, &cur_priority)) {
+            /* the subscription(s) was recovered just now */
+            goto next_mod;
+        }
         if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_DONE,
                 cur_priority + 1, &cur_priority, &subscriber_count, &opts))) {
             goto cleanup;
@@ -1538,28 +1953,34 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
 
         if (!subscriber_count) {
             /* the subscription(s) was recovered just now so there are not any */
-            continue;
+            goto next_mod;
         }
 
         /* prepare the diff to write into subscription SHM */
-        if (!diff_lyb && (err_info = sr_lyd_print_lyb(mod_info->diff, &diff_lyb, &diff_lyb_len))) {
+        if (!diff_lyb && (err_info = sr_lyd_print_lyb_idx(mod_info->diff, &diff_lyb, &diff_lyb_len))) {
             goto cleanup;
         }
 
-        /* open sub SHM and map it */
-        if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_sub))) {
-            goto cleanup;
-        }
-        multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
+        if (!ev_mods[i].locked) {
+            /* open sub SHM and map it */
+            if ((err_info = sr_shmsub_cache_open_map(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                    &ev_mods[i].shm_sub))) {
+                goto cleanup;
+            }
 
-        /* SUB WRITE LOCK */
-        if ((err_info = sr_shmsub_notify_new_wrlock((sr_sub_shm_t *)multi_sub_shm, mod->ly_mod->name, 0, cid))) {
-            goto cleanup;
+            /* SUB WRITE LOCK */
+            if ((err_info = sr_shmsub_notify_new_wrlock((sr_sub_shm_t *)ev_mods[i].shm_sub.addr, mod->ly_mod->name, 0,
+                    cid))) {
+                goto cleanup;
+            }
+            ev_mods[i].locked = 1;
         }
+        multi_sub_shm = (sr_multi_sub_shm_t *)ev_mods[i].shm_sub.addr;
 
         /* open sub data SHM */
-        if ((err_info = sr_shmsub_data_open_remap(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_data_sub, 0))) {
-            goto cleanup_wrunlock;
+        if ((err_info = sr_shmsub_data_open_remap(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_data_sub, 0))) {
+            goto cleanup;
         }
 
         do {
@@ -1570,23 +1991,23 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
             if ((err_info = sr_shmsub_multi_notify_write_event(multi_sub_shm, cid, mod->request_id, cur_priority,
                     SR_SUB_EV_DONE, orig_name, orig_data, subscriber_count, &shm_data_sub, NULL, diff_lyb, diff_lyb_len,
                     mod->ly_mod->name))) {
-                goto cleanup_wrunlock;
+                goto cleanup;
             }
 
             /* notify the subscribers using event pipe */
             if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_DONE,
                     cur_priority))) {
-                goto cleanup_wrunlock;
+                goto cleanup;
             }
 
             /* wait until the event is processed */
             if ((err_info = sr_shmsub_notify_wait_wr((sr_sub_shm_t *)multi_sub_shm, SR_SUB_EV_NONE, 1, timeout_ms, cid,
                     &shm_data_sub, &cb_err_info))) {
                 if (err_info->err[0].err_code == SR_ERR_TIME_OUT) {
-                    goto cleanup;
-                } else {
-                    goto cleanup_wrunlock;
+                    /* the lock was released */
+                    ev_mods[i].locked = 0;
                 }
+                goto cleanup;
             }
 
             /* we do not care about an error */
@@ -1595,29 +2016,33 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
             /* find out what is the next priority and how many subscribers have it */
             if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_DONE,
                     cur_priority, &cur_priority, &subscriber_count, &opts))) {
-                goto cleanup_wrunlock;
+                goto cleanup;
             }
         } while (subscriber_count);
 
-        /* SUB WRITE UNLOCK */
-        sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
+next_mod:
+        if (ev_mods[i].locked) {
+            /* SUB WRITE UNLOCK */
+            sr_rwunlock(&((sr_sub_shm_t *)ev_mods[i].shm_sub.addr)->lock, 0, SR_LOCK_WRITE, cid, __func__);
+            ev_mods[i].locked = 0;
+        }
 
-        sr_shm_clear(&shm_sub);
-        sr_shm_clear(&shm_data_sub);
+        sr_shmsub_cache_release(mod_info->conn, &ev_mods[i].shm_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     }
 
-    /* success */
-    goto cleanup;
-
-cleanup_wrunlock:
-    /* SUB WRITE UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
-
 cleanup:
+    for (i = 0; i < ev_mod_count; ++i) {
+        if (ev_mods[i].locked) {
+            /* SUB WRITE UNLOCK */
+            sr_rwunlock(&((sr_sub_shm_t *)ev_mods[i].shm_sub.addr)->lock, 0, SR_LOCK_WRITE, cid, __func__);
+        }
+        sr_shmsub_cache_release(mod_info->conn, &ev_mods[i].shm_sub);
+    }
+    free(ev_mods);
     free(aux);
     free(diff_lyb);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     return err_info;
 }
 
@@ -1644,7 +2069,8 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
         }
 
         /* open sub SHM and map it */
-        if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_sub))) {
+        if ((err_info = sr_shmsub_cache_open_map(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_sub))) {
             goto cleanup;
         }
         multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
@@ -1656,7 +2082,8 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
         }
 
         /* open sub data SHM */
-        if ((err_info = sr_shmsub_data_open_remap(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_data_sub, 0))) {
+        if ((err_info = sr_shmsub_data_open_remap(mod_info->conn, mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                &shm_data_sub, 0))) {
             goto cleanup_wrunlock;
         }
 
@@ -1686,8 +2113,8 @@ clear_shm:
             sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
 
             /* not the right subscription SHM, try next */
-            sr_shm_clear(&shm_sub);
-            sr_shm_clear(&shm_data_sub);
+            sr_shmsub_cache_release(mod_info->conn, &shm_sub);
+            sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
             continue;
         }
 
@@ -1712,7 +2139,7 @@ clear_shm:
                 goto cleanup_wrunlock;
             }
 
-            if ((err_info = sr_lyd_print_lyb(abort_diff, &diff_lyb, &diff_lyb_len))) {
+            if ((err_info = sr_lyd_print_lyb_idx(abort_diff, &diff_lyb, &diff_lyb_len))) {
                 lyd_free_all(abort_diff);
                 goto cleanup_wrunlock;
             }
@@ -1769,8 +2196,8 @@ clear_shm:
         /* SUB WRITE UNLOCK */
         sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
 
-        sr_shm_clear(&shm_sub);
-        sr_shm_clear(&shm_data_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_sub);
+        sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     }
 
     /* unreachable unless the failed subscription was not found */
@@ -1784,8 +2211,8 @@ cleanup_wrunlock:
 cleanup:
     free(aux);
     free(diff_lyb);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_sub);
+    sr_shmsub_cache_release(mod_info->conn, &shm_data_sub);
     return err_info;
 }
 
@@ -1800,7 +2227,7 @@ cleanup:
  * @param[in] orig_data Event originator data.
  * @param[in] xpath_sub Particular subscription to perform action on.
  * @param[in] timeout_ms Operational callback timeout in milliseconds.
- * @param[in] cid Connection ID.
+ * @param[in] conn Connection to use.
  * @param[out] data Data provided by the subscriber.
  * @param[out] cb_err_info Callback error information generated by a subscriber, if any.
  * @return err_info, NULL on success.
@@ -1808,7 +2235,7 @@ cleanup:
 static sr_error_info_t *
 sr_shmsub_oper_get_notify_single(const struct lys_module *ly_mod, const char *xpath, const char *request_xpath,
         const struct lyd_node *parent, const char *orig_name, const void *orig_data, sr_mod_oper_get_xpath_sub_t *xpath_sub,
-        uint32_t timeout_ms, sr_cid_t cid, struct lyd_node **data, sr_error_info_t **cb_err_info)
+        uint32_t timeout_ms, sr_conn_ctx_t *conn, struct lyd_node **data, sr_error_info_t **cb_err_info)
 {
     sr_error_info_t *err_info = NULL;
     char *parent_lyb = NULL;
@@ -1828,35 +2255,38 @@ sr_shmsub_oper_get_notify_single(const struct lys_module *ly_mod, const char *xp
     parent_lyb_len = lyd_lyb_data_length(parent_lyb);
 
     /* open sub SHM and map it */
-    if ((err_info = sr_shmsub_open_map(ly_mod->name, "oper", sr_str_hash(xpath, xpath_sub->priority), &shm_sub))) {
+    if ((err_info = sr_shmsub_cache_open_map(conn, ly_mod->name, "oper", sr_str_hash(xpath, xpath_sub->priority),
+            &shm_sub))) {
         goto cleanup;
     }
     sub_shm = (sr_sub_shm_t *)shm_sub.addr;
 
     /* SUB WRITE LOCK */
-    if ((err_info = sr_shmsub_notify_new_wrlock(sub_shm, ly_mod->name, 0, cid))) {
+    if ((err_info = sr_shmsub_notify_new_wrlock(sub_shm, ly_mod->name, 0, conn->cid))) {
         goto cleanup;
     }
 
     /* open sub data SHM */
-    if ((err_info = sr_shmsub_data_open_remap(ly_mod->name, "oper", sr_str_hash(xpath, xpath_sub->priority), &shm_data_sub, 0))) {
+    if ((err_info = sr_shmsub_data_open_remap(conn, ly_mod->name, "oper", sr_str_hash(xpath, xpath_sub->priority),
+            &shm_data_sub, 0))) {
         goto cleanup_wrunlock;
     }
 
     /* write the request for state data */
     request_id = sub_shm->request_id + 1;
-    if ((err_info = sr_shmsub_notify_write_event(sub_shm, cid, request_id, SR_SUB_EV_OPER, orig_name, orig_data,
+    if ((err_info = sr_shmsub_notify_write_event(sub_shm, conn->cid, request_id, SR_SUB_EV_OPER, orig_name, orig_data,
             &shm_data_sub, request_xpath, parent_lyb, parent_lyb_len, xpath))) {
         goto cleanup_wrunlock;
     }
 
     /* notify using event pipe */
-    if ((err_info = sr_shmsub_notify_evpipe(xpath_sub->evpipe_num))) {
+    if ((err_info = sr_shmsub_notify_evpipe_ready(conn, xpath_sub->evpipe_num, ly_mod->name, "oper"))) {
         goto cleanup_wrunlock;
     }
 
     /* wait until the event is processed */
-    if ((err_info = sr_shmsub_notify_wait_wr(sub_shm, SR_SUB_EV_ERROR, 1, timeout_ms, cid, &shm_data_sub, cb_err_info))) {
+    if ((err_info = sr_shmsub_notify_wait_wr(sub_shm, SR_SUB_EV_ERROR, 1, timeout_ms, conn->cid, &shm_data_sub,
+            cb_err_info))) {
         if (err_info->err[0].err_code == SR_ERR_TIME_OUT) {
             goto cleanup;
         } else {
@@ -1887,11 +2317,11 @@ sr_shmsub_oper_get_notify_single(const struct lys_module *ly_mod, const char *xp
 
 cleanup_wrunlock:
     /* SUB WRITE UNLOCK */
-    sr_rwunlock(&sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
+    sr_rwunlock(&sub_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
 
 cleanup:
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(conn, &shm_sub);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
     free(parent_lyb);
     return err_info;
 }
@@ -1937,7 +2367,7 @@ sr_shmsub_oper_get_notify_many(struct sr_mod_info_mod_s *mod, const char *xpath,
 
     for (i = 0; i < notify_count; ++i) {
         /* open sub SHM and map it */
-        if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, "oper",
+        if ((err_info = sr_shmsub_cache_open_map(conn, mod->ly_mod->name, "oper",
                 sr_str_hash(xpath, notify_subs[i].xpath_sub->priority), &notify_subs[i].shm_sub))) {
             goto cleanup;
         }
@@ -1950,7 +2380,7 @@ sr_shmsub_oper_get_notify_many(struct sr_mod_info_mod_s *mod, const char *xpath,
         notify_subs[i].locked = 1;
 
         /* open sub data SHM */
-        if ((err_info = sr_shmsub_data_open_remap(mod->ly_mod->name, "oper",
+        if ((err_info = sr_shmsub_data_open_remap(conn, mod->ly_mod->name, "oper",
                 sr_str_hash(xpath, notify_subs[i].xpath_sub->priority), &notify_subs[i].shm_data_sub, 0))) {
             goto cleanup;
         }
@@ -1964,7 +2394,8 @@ sr_shmsub_oper_get_notify_many(struct sr_mod_info_mod_s *mod, const char *xpath,
         }
 
         /* notify using event pipe */
-        if ((err_info = sr_shmsub_notify_evpipe(notify_subs[i].xpath_sub->evpipe_num))) {
+        if ((err_info = sr_shmsub_notify_evpipe_ready(conn, notify_subs[i].xpath_sub->evpipe_num, mod->ly_mod->name,
+                "oper"))) {
             goto cleanup;
         }
     }
@@ -2018,8 +2449,8 @@ cleanup:
     }
 
     for (i = 0; i < notify_count; ++i) {
-        sr_shm_clear(&notify_subs[i].shm_sub);
-        sr_shm_clear(&notify_subs[i].shm_data_sub);
+        sr_shmsub_cache_release(conn, &notify_subs[i].shm_sub);
+        sr_shmsub_cache_release(conn, &notify_subs[i].shm_data_sub);
     }
     free(parent_lyb);
     return err_info;
@@ -2073,7 +2504,7 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
 
     if (notify_count == 1) {
         err_info = sr_shmsub_oper_get_notify_single(mod->ly_mod, xpath, request_xpath, parent, orig_name, orig_data,
-                notify_subs[0].xpath_sub, timeout_ms, conn->cid, data, cb_err_info);
+                notify_subs[0].xpath_sub, timeout_ms, conn, data, cb_err_info);
     } else if (notify_count > 1) {
         err_info = sr_shmsub_oper_get_notify_many(mod, xpath, request_xpath, parent, orig_name, orig_data, timeout_ms,
                 conn, notify_subs, notify_count, data, cb_err_info);
@@ -2088,19 +2519,40 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
  *
  * @param[in] input Operation input data tree.
  * @param[in] xpath Full subscription XPath.
+ * @param[in] xs Optional resolved schema nodes of @p xpath to filter with first.
+ * @param[in] conn Connection to use, needed only with @p xs.
  * @return 0 if not, non-zero is it is.
  */
 static int
-sr_shmsub_rpc_listen_filter_is_valid(const struct lyd_node *input, const char *xpath)
+sr_shmsub_rpc_listen_filter_is_valid(const struct lyd_node *input, const char *xpath,
+        const struct sr_xpath_snodes_s *xs, sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
+    struct lyd_node *input_op;
     struct ly_set *set;
 
-    if (lyd_find_xpath(input, xpath, &set)) {
-        SR_ERRINFO_INT(&err_info);
-        sr_errinfo_free(&err_info);
-        return 0;
-    } else if (set->count) {
+    if (xs) {
+        /* quickly filter based on the operation schema node */
+        input_op = (struct lyd_node *)input;
+        if ((err_info = sr_ly_find_last_parent(&input_op, LYS_RPC | LYS_ACTION))) {
+            sr_errinfo_free(&err_info);
+        } else if (input_op && (input_op->schema->nodetype & (LYS_RPC | LYS_ACTION))) {
+            switch (sr_xpath_snodes_filter_op(conn, xs, input_op->schema)) {
+            case 0:
+                return 0;
+            case 1:
+                return 1;
+            default:
+                break;
+            }
+        }
+    }
+
+    if (lyd_find_xpath(input, xpath, &set)) {
+        SR_ERRINFO_INT(&err_info);
+        sr_errinfo_free(&err_info);
+        return 0;
+    } else if (set->count) {
         /* valid subscription */
         ly_set_free(set, NULL);
         return 1;
@@ -2158,7 +2610,7 @@ sr_shmsub_rpc_notify_has_subscription(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock
         }
 
         /* valid subscription */
-        if (sr_shmsub_rpc_listen_filter_is_valid(input, conn->ext_shm.addr + shm_subs[i].xpath)) {
+        if (sr_shmsub_rpc_listen_filter_is_valid(input, conn->ext_shm.addr + shm_subs[i].xpath, NULL, NULL)) {
             has_sub = 1;
             if (shm_subs[i].priority > *max_priority_p) {
                 *max_priority_p = shm_subs[i].priority;
@@ -2226,7 +2678,7 @@ sr_shmsub_rpc_notify_next_subscription(sr_conn_ctx_t *conn, sr_rwlock_t *sub_loc
         }
 
         /* valid subscription */
-        if (sr_shmsub_rpc_listen_filter_is_valid(input, conn->ext_shm.addr + shm_subs[i].xpath) &&
+        if (sr_shmsub_rpc_listen_filter_is_valid(input, conn->ext_shm.addr + shm_subs[i].xpath, NULL, NULL) &&
                 (last_priority > shm_subs[i].priority)) {
             /* a subscription that was not notified yet */
             if (*sub_count_p) {
@@ -2271,6 +2723,45 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Open and map the sub SHM of an RPC/action slot to publish a new request in, prefer an idle slot.
+ *
+ * @param[in] conn Connection of the originator.
+ * @param[in] mod_name Module name of the RPC/action.
+ * @param[in] path RPC/action path.
+ * @param[out] slot Selected slot.
+ * @param[out] shm_sub Mapped sub SHM of @p slot.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_rpc_notify_open_slot(sr_conn_ctx_t *conn, const char *mod_name, const char *path, uint32_t *slot,
+        sr_shm_t *shm_sub)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_multi_sub_shm_t *multi_sub_shm;
+    uint32_t i, first;
+
+    /* spread the originators among the slots so that they do not all try the same one first */
+    first = conn->cid % SR_RPC_SUB_SLOT_COUNT;
+    for (i = 0; i < SR_RPC_SUB_SLOT_COUNT; ++i) {
+        *slot = (first + i) % SR_RPC_SUB_SLOT_COUNT;
+        if ((err_info = sr_shmsub_cache_open_map(conn, mod_name, "rpc", sr_str_hash(path, *slot), shm_sub))) {
+            return err_info;
+        }
+        multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub->addr;
+
+        /* only a hint without a lock, the slot is properly waited for when locking it */
+        if (!multi_sub_shm->event && !multi_sub_shm->lock.writer) {
+            return NULL;
+        }
+        sr_shmsub_cache_release(conn, shm_sub);
+    }
+
+    /* all the slots are busy, queue on the first one */
+    *slot = first;
+    return sr_shmsub_cache_open_map(conn, mod_name, "rpc", sr_str_hash(path, *slot), shm_sub);
+}
+
 sr_error_info_t *
 sr_shmsub_rpc_notify(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, uint32_t *sub_count, const char *path,
         const struct lyd_node *input, const char *orig_name, const void *orig_data, uint32_t timeout_ms,
@@ -2278,7 +2769,7 @@ sr_shmsub_rpc_notify(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, ui
 {
     sr_error_info_t *err_info = NULL;
     char *input_lyb = NULL;
-    uint32_t i, input_lyb_len, cur_priority, subscriber_count, *evpipes = NULL;
+    uint32_t i, input_lyb_len, cur_priority, subscriber_count, *evpipes = NULL, slot;
     int opts;
     struct ly_in *in = NULL;
     sr_multi_sub_shm_t *multi_sub_shm;
@@ -2312,8 +2803,15 @@ sr_shmsub_rpc_notify(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, ui
     }
     input_lyb_len = lyd_lyb_data_length(input_lyb);
 
-    /* open sub SHM and map it */
-    if ((err_info = sr_shmsub_open_map(lyd_owner_module(input)->name, "rpc", sr_str_hash(path, 0), &shm_sub))) {
+    /* open sub SHM of a slot and map it */
+    if (*request_id) {
+        slot = *request_id % SR_RPC_SUB_SLOT_COUNT;
+        err_info = sr_shmsub_cache_open_map(conn, lyd_owner_module(input)->name, "rpc", sr_str_hash(path, slot),
+                &shm_sub);
+    } else {
+        err_info = sr_shmsub_rpc_notify_open_slot(conn, lyd_owner_module(input)->name, path, &slot, &shm_sub);
+    }
+    if (err_info) {
         goto cleanup;
     }
     multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
@@ -2324,14 +2822,20 @@ sr_shmsub_rpc_notify(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, ui
     }
 
     /* open sub data SHM */
-    if ((err_info = sr_shmsub_data_open_remap(lyd_owner_module(input)->name, "rpc", sr_str_hash(path, 0), &shm_data_sub, 0))) {
+    if ((err_info = sr_shmsub_data_open_remap(conn, lyd_owner_module(input)->name, "rpc", sr_str_hash(path, slot),
+            &shm_data_sub, 0))) {
         goto cleanup_wrunlock;
     }
 
     do {
         /* write the event */
         if (!*request_id) {
-            *request_id = ++multi_sub_shm->request_id;
+            /* keep the request ID congruent with the slot so that the slot can be learned from it */
+            *request_id = multi_sub_shm->request_id + SR_RPC_SUB_SLOT_COUNT;
+            if ((*request_id < SR_RPC_SUB_SLOT_COUNT) || (*request_id % SR_RPC_SUB_SLOT_COUNT != slot)) {
+                /* first request in the slot or an overflow */
+                *request_id = slot + SR_RPC_SUB_SLOT_COUNT;
+            }
         }
         if ((err_info = sr_shmsub_multi_notify_write_event(multi_sub_shm, conn->cid, *request_id, cur_priority,
                 SR_SUB_EV_RPC, orig_name, orig_data, subscriber_count, &shm_data_sub, NULL, input_lyb, input_lyb_len,
@@ -2341,7 +2845,7 @@ sr_shmsub_rpc_notify(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, ui
 
         /* notify using event pipe */
         for (i = 0; i < subscriber_count; ++i) {
-            if ((err_info = sr_shmsub_notify_evpipe(evpipes[i]))) {
+            if ((err_info = sr_shmsub_notify_evpipe_ready(conn, evpipes[i], path, "rpc"))) {
                 goto cleanup_wrunlock;
             }
         }
@@ -2398,8 +2902,8 @@ cleanup:
     ly_in_free(in, 0);
     free(input_lyb);
     free(evpipes);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(conn, &shm_sub);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
     if (err_info) {
         lyd_free_all(*output);
         *output = NULL;
@@ -2413,15 +2917,19 @@ sr_shmsub_rpc_notify_abort(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *su
 {
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
     char *input_lyb = NULL;
-    uint32_t i, input_lyb_len, cur_priority, err_priority, subscriber_count, err_subscriber_count, *evpipes = NULL;
+    uint32_t i, input_lyb_len, cur_priority, err_priority, subscriber_count, err_subscriber_count, *evpipes = NULL, slot;
     sr_multi_sub_shm_t *multi_sub_shm;
     sr_shm_t shm_sub = SR_SHM_INITIALIZER, shm_data_sub = SR_SHM_INITIALIZER;
     int first_iter;
 
     assert(request_id);
 
+    /* the request was published in this slot */
+    slot = request_id % SR_RPC_SUB_SLOT_COUNT;
+
     /* open sub SHM and map it */
-    if ((err_info = sr_shmsub_open_map(lyd_owner_module(input)->name, "rpc", sr_str_hash(path, 0), &shm_sub))) {
+    if ((err_info = sr_shmsub_cache_open_map(conn, lyd_owner_module(input)->name, "rpc", sr_str_hash(path, slot),
+            &shm_sub))) {
         goto cleanup;
     }
     multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
@@ -2432,7 +2940,8 @@ sr_shmsub_rpc_notify_abort(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *su
     }
 
     /* open sub data SHM */
-    if ((err_info = sr_shmsub_data_open_remap(lyd_owner_module(input)->name, "rpc", sr_str_hash(path, 0), &shm_data_sub, 0))) {
+    if ((err_info = sr_shmsub_data_open_remap(conn, lyd_owner_module(input)->name, "rpc", sr_str_hash(path, slot),
+            &shm_data_sub, 0))) {
         goto cleanup_wrunlock;
     }
 
@@ -2493,7 +3002,7 @@ clear_shm:
 
         /* notify using event pipe */
         for (i = 0; i < subscriber_count; ++i) {
-            if ((err_info = sr_shmsub_notify_evpipe(evpipes[i]))) {
+            if ((err_info = sr_shmsub_notify_evpipe_ready(conn, evpipes[i], path, "rpc"))) {
                 goto cleanup_wrunlock;
             }
         }
@@ -2528,22 +3037,157 @@ cleanup_wrunlock:
 cleanup:
     free(input_lyb);
     free(evpipes);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(conn, &shm_sub);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
     return err_info;
 }
 
+/**
+ * @brief Having WRITE lock, wait until the notification in a slot is processed by the subscribers.
+ *
+ * !! On error, the WRITE lock was released!
+ *
+ * @param[in] notif_shm Notification subscription SHM.
+ * @param[in] request_id Request ID of the notification in the slot.
+ * @param[in] blocking Whether to wait only for the blocking subscribers or for all the subscribers.
+ * @param[in] timeout_ms Timeout in milliseconds.
+ * @param[in] cid Connection ID.
+ * @param[out] processed Whether the notification was processed, it may not be only on a timeout.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_notif_wait_slot(sr_notif_sub_shm_t *notif_shm, uint32_t request_id, int blocking, uint32_t timeout_ms,
+        sr_cid_t cid, int *processed)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_notif_sub_slot_s *slot;
+    int ret;
+
+    slot = &notif_shm->slots[request_id % SR_NOTIF_SUB_SLOT_COUNT];
+
+    assert(notif_shm->lock.writer == cid);
+    /* FAKE WRITE UNLOCK */
+    notif_shm->lock.writer = 0;
+
+    /* wait until the notification was processed and there are no readers (just like write lock) */
+    ret = 0;
+    while (!ret && (notif_shm->lock.readers[0] || ((slot->request_id == request_id) &&
+            (blocking ? slot->block_count : slot->subscriber_count)))) {
+        /* COND WAIT */
+        ret = sr_cond_timedwait(&notif_shm->lock.cond, &notif_shm->lock.mutex, timeout_ms);
+    }
+    /* we are holding the mutex but no lock flags are set */
+
+    if (ret && ((ret != ETIMEDOUT) || notif_shm->lock.readers[0])) {
+        if (ret == ETIMEDOUT) {
+            /* WRITE LOCK, wait for the readers */
+            err_info = sr_sub_rwlock_has_mutex(&notif_shm->lock, timeout_ms, SR_LOCK_WRITE, cid, __func__, NULL, NULL);
+        } else {
+            SR_ERRINFO_COND(&err_info, __func__, ret);
+        }
+
+        if (err_info) {
+            /* MUTEX UNLOCK */
+            sr_munlock(&notif_shm->lock.mutex);
+            return err_info;
+        }
+    } else {
+        /* FAKE WRITE LOCK */
+        notif_shm->lock.writer = cid;
+    }
+
+    if ((slot->request_id == request_id) && (blocking ? slot->block_count : slot->subscriber_count)) {
+        *processed = 0;
+    } else {
+        *processed = 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Write a notification into a notification subscription SHM slot and its sub data SHM.
+ *
+ * @param[in] notif_shm Notification subscription SHM.
+ * @param[in] orig_cid Notification originator CID.
+ * @param[in] request_id Request ID of the notification.
+ * @param[in] orig_name Originator name.
+ * @param[in] orig_data Originator data.
+ * @param[in] subscriber_count Subscriber count.
+ * @param[in] block_count Blocking subscriber count.
+ * @param[in] shm_data_sub Opened sub data SHM of the slot.
+ * @param[in] notif_ts Notification timestamp.
+ * @param[in] notif_lyb Notification in LYB.
+ * @param[in] notif_lyb_len Length of @p notif_lyb.
+ * @param[in] mod_name Module name of the notification.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_notif_write_slot(sr_notif_sub_shm_t *notif_shm, sr_cid_t orig_cid, uint32_t request_id, const char *orig_name,
+        const void *orig_data, uint32_t subscriber_count, uint32_t block_count, sr_shm_t *shm_data_sub,
+        const struct timespec *notif_ts, const char *notif_lyb, uint32_t notif_lyb_len, const char *mod_name)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_notif_sub_slot_s *slot;
+    char *shm_data_ptr;
+    const uint32_t empty_data[] = {0};
+    uint32_t orig_size;
+
+    if (!orig_name) {
+        orig_name = "";
+    }
+    if (!orig_data) {
+        orig_data = empty_data;
+    }
+    orig_size = sr_strshmlen(orig_name) + SR_SHM_SIZE(sr_ev_data_size(orig_data));
+
+    /* remap if needed */
+    if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, NULL, -1, shm_data_sub,
+            orig_size + sizeof *notif_ts + notif_lyb_len))) {
+        return err_info;
+    }
+    shm_data_ptr = shm_data_sub->addr;
+
+    /* write originator name and data */
+    strcpy(shm_data_ptr, orig_name);
+    shm_data_ptr += sr_strshmlen(orig_name);
+    memcpy(shm_data_ptr, orig_data, sr_ev_data_size(orig_data));
+    shm_data_ptr += SR_SHM_SIZE(sr_ev_data_size(orig_data));
+
+    /* write notification timestamp */
+    memcpy(shm_data_ptr, notif_ts, sizeof *notif_ts);
+    shm_data_ptr += sizeof *notif_ts;
+
+    /* write the notification */
+    memcpy(shm_data_ptr, notif_lyb, notif_lyb_len);
+
+    /* fill the slot */
+    slot = &notif_shm->slots[request_id % SR_NOTIF_SUB_SLOT_COUNT];
+    slot->request_id = request_id;
+    slot->orig_cid = orig_cid;
+    sr_time_get(&slot->publish_ts, 0);
+    slot->subscriber_count = subscriber_count;
+    slot->block_count = block_count;
+    notif_shm->request_id = request_id;
+
+    SR_LOG_INF("Published event \"notif\" \"%s\" with ID %" PRIu32 " for %" PRIu32 " subscribers.", mod_name, request_id,
+            subscriber_count);
+    return NULL;
+}
+
 sr_error_info_t *
 sr_shmsub_notif_notify(sr_conn_ctx_t *conn, const struct lyd_node *notif, struct timespec notif_ts, const char *orig_name,
         const void *orig_data, uint32_t timeout_ms, int wait)
 {
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    sr_error_info_t *err_info = NULL;
     const struct lys_module *ly_mod;
+    sr_mod_t *shm_mod;
     sr_mod_notif_sub_t *notif_subs;
     char *notif_lyb = NULL;
-    uint32_t notif_sub_count, notif_lyb_len, request_id, i;
+    uint32_t notif_sub_count, block_count, notif_lyb_len, request_id, i;
+    int processed;
     sr_cid_t sub_cid;
-    sr_multi_sub_shm_t *multi_sub_shm;
+    sr_notif_sub_shm_t *notif_shm;
+    struct sr_notif_sub_slot_s *slot;
     sr_shm_t shm_sub = SR_SHM_INITIALIZER, shm_data_sub = SR_SHM_INITIALIZER;
 
     assert(!notif->parent);
@@ -2566,76 +3210,91 @@ sr_shmsub_notif_notify(sr_conn_ctx_t *conn, const struct lyd_node *notif, struct
         goto cleanup_ext_unlock;
     }
 
+    /* count the subscribers that must process the notification before it can be overwritten */
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), ly_mod->name);
+    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup_ext_unlock);
+    block_count = 0;
+    for (i = 0; i < shm_mod->notif_sub_count; ++i) {
+        if (!ATOMIC_LOAD_RELAXED(notif_subs[i].suspended) && !notif_subs[i].drop) {
+            ++block_count;
+        }
+    }
+
     /* print the notification into LYB */
     if ((err_info = sr_lyd_print_lyb(notif, &notif_lyb, &notif_lyb_len))) {
         goto cleanup_ext_unlock;
     }
 
     /* open sub SHM and map it */
-    if ((err_info = sr_shmsub_open_map(ly_mod->name, "notif", -1, &shm_sub))) {
+    if ((err_info = sr_shmsub_cache_open_map(conn, ly_mod->name, "notif", -1, &shm_sub))) {
         goto cleanup_ext_unlock;
     }
-    multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
+    notif_shm = (sr_notif_sub_shm_t *)shm_sub.addr;
 
     /* SUB WRITE LOCK */
-    if ((err_info = sr_shmsub_notify_new_wrlock((sr_sub_shm_t *)multi_sub_shm, ly_mod->name, 0, conn->cid))) {
+    if ((err_info = sr_rwlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__, NULL, NULL))) {
         goto cleanup_ext_unlock;
     }
 
-    /* open sub data SHM */
-    if ((err_info = sr_shmsub_data_open_remap(ly_mod->name, "notif", -1, &shm_data_sub, 0))) {
+    /* the slot of the new notification may still hold an older one not processed by all the blocking subscribers */
+    request_id = notif_shm->request_id + 1;
+    slot = &notif_shm->slots[request_id % SR_NOTIF_SUB_SLOT_COUNT];
+    if (slot->request_id && slot->block_count) {
+        if ((err_info = sr_shmsub_notif_wait_slot(notif_shm, slot->request_id, 1, SR_SUBSHM_LOCK_TIMEOUT, conn->cid,
+                &processed))) {
+            goto cleanup_ext_unlock;
+        }
+        if (!processed) {
+            /* the subscribers will learn they have missed it */
+            SR_LOG_WRN("Notification \"%s\" with ID %" PRIu32 " was not processed by all the subscribers in time.",
+                    ly_mod->name, slot->request_id);
+        }
+    }
+
+    /* open sub data SHM of the slot */
+    if ((err_info = sr_shmsub_data_open_remap(conn, ly_mod->name, "notif", request_id % SR_NOTIF_SUB_SLOT_COUNT,
+            &shm_data_sub,
+            0))) {
         goto cleanup_ext_sub_unlock;
     }
 
     /* write the notification, use first subscriber CID - works better than the originator */
-    request_id = multi_sub_shm->request_id + 1;
-    if ((err_info = sr_shmsub_multi_notify_write_event(multi_sub_shm, sub_cid, request_id, 0, SR_SUB_EV_NOTIF,
-            orig_name, orig_data, notif_sub_count, &shm_data_sub, &notif_ts, notif_lyb, notif_lyb_len, ly_mod->name))) {
+    if ((err_info = sr_shmsub_notif_write_slot(notif_shm, sub_cid, request_id, orig_name, orig_data, notif_sub_count,
+            block_count, &shm_data_sub, &notif_ts, notif_lyb, notif_lyb_len, ly_mod->name))) {
         goto cleanup_ext_sub_unlock;
     }
 
     /* notify all subscribers using event pipe */
-    for (i = 0; i < notif_sub_count; ) {
+    for (i = 0; i < shm_mod->notif_sub_count; ++i) {
         if (ATOMIC_LOAD_RELAXED(notif_subs[i].suspended)) {
             /* skip suspended subscribers */
             continue;
         }
 
-        if ((err_info = sr_shmsub_notify_evpipe(notif_subs[i].evpipe_num))) {
+        if ((err_info = sr_shmsub_notify_evpipe_ready(conn, notif_subs[i].evpipe_num, ly_mod->name, "notif"))) {
             goto cleanup_ext_sub_unlock;
         }
-
-        ++i;
     }
 
     /* EXT READ UNLOCK */
     sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
 
     if (wait) {
-        /* wait until the event is processed */
-        if ((err_info = sr_shmsub_notify_wait_wr((sr_sub_shm_t *)multi_sub_shm, SR_SUB_EV_NONE, 1, timeout_ms, conn->cid,
-                &shm_data_sub, &cb_err_info))) {
-            if (err_info->err[0].err_code == SR_ERR_TIME_OUT) {
-                goto cleanup;
-            } else {
-                goto cleanup_sub_unlock;
-            }
+        /* wait until the notification is processed, we do not care about a timeout */
+        if ((err_info = sr_shmsub_notif_wait_slot(notif_shm, request_id, 0, timeout_ms, conn->cid, &processed))) {
+            goto cleanup;
         }
-
-        /* we do not care about an error */
-        sr_errinfo_free(&cb_err_info);
     }
 
-cleanup_sub_unlock:
     /* SUB WRITE UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
+    sr_rwunlock(&notif_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
 
     /* success */
     goto cleanup;
 
 cleanup_ext_sub_unlock:
     /* SUB WRITE UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
+    sr_rwunlock(&notif_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
 
 cleanup_ext_unlock:
     /* EXT READ UNLOCK */
@@ -2643,8 +3302,8 @@ cleanup_ext_unlock:
 
 cleanup:
     free(notif_lyb);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(conn, &shm_sub);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
     return err_info;
 }
 
@@ -2695,10 +3354,11 @@ sr_shmsub_change_listen_is_new_event(sr_multi_sub_shm_t *multi_sub_shm, struct m
  *
  * @param[in] sub Change subscription.
  * @param[in] diff Full diff for the module.
+ * @param[in] conn Connection to use.
  * @return 0 if not, non-zero if there is.
  */
 static int
-sr_shmsub_change_listen_filter_is_valid(struct modsub_changesub_s *sub, const struct lyd_node *diff)
+sr_shmsub_change_listen_filter_is_valid(struct modsub_changesub_s *sub, const struct lyd_node *diff, sr_conn_ctx_t *conn)
 {
     struct ly_set *set;
     const struct lyd_node *elem;
@@ -2711,6 +3371,11 @@ sr_shmsub_change_listen_filter_is_valid(struct modsub_changesub_s *sub, const st
         return 1;
     }
 
+    /* quickly filter out a diff without any subtrees the XPath can select nodes from */
+    if (!sr_xpath_snodes_filter_tree(conn, &sub->xpath_snodes, diff)) {
+        return 0;
+    }
+
     lyrc = lyd_find_xpath(diff, sub->xpath, &set);
     assert(!lyrc);
     (void)lyrc;
@@ -2789,7 +3454,7 @@ sr_shmsub_multi_listen_write_event(sr_multi_sub_shm_t *multi_sub_shm, uint32_t v
 
     if (data && data_len) {
         /* remap if needed */
-        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, -1, shm_data_sub, data_len))) {
+        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, NULL, -1, shm_data_sub, data_len))) {
             return err_info;
         }
 
@@ -2926,8 +3591,11 @@ sr_shmsub_change_listen_relock(sr_multi_sub_shm_t *multi_sub_shm, sr_lock_mode_t
         /* self-generate abort event in case the change was applied successfully */
         if ((sub_info->event == SR_SUB_EV_CHANGE) && (err_code == SR_ERR_OK) &&
                 sr_shmsub_change_listen_event_is_valid(SR_SUB_EV_ABORT, sub->opts)) {
-            /* update session */
+            /* update session, the whole diff is reversed */
             ev_sess->ev = SR_SUB_EV_ABORT;
+            if ((*err_info = sr_session_ev_diff_parse(ev_sess, NULL, NULL))) {
+                return 1;
+            }
             if (lyd_diff_reverse_all(ev_sess->dt[ev_sess->ds].diff, &abort_diff)) {
                 sr_errinfo_new_ly(err_info, ev_sess->conn->ly_ctx, NULL);
                 SR_ERRINFO_INT(err_info);
@@ -2989,10 +3657,9 @@ sr_error_info_t *
 sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_subs, sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i, data_len = 0, valid_subscr_count;
+    uint32_t i, j, data_len = 0, valid_subscr_count;
     char *data = NULL, *shm_data_ptr;
     int ret = SR_ERR_OK;
-    struct lyd_node *diff;
     sr_data_t *edit_data;
     sr_error_t err_code = SR_ERR_OK;
     struct modsub_changesub_s *change_sub;
@@ -3000,6 +3667,10 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
     sr_shm_t shm_data_sub = SR_SHM_INITIALIZER;
     sr_session_ctx_t *ev_sess = NULL;
     struct info_sub_s sub_info;
+    struct timespec listen_ts, cb_ts = {0};
+    uint64_t wakeup_time = 0, result_time = 0;
+    uint32_t queue_time = 0;
+    int finished = 0;
 
     multi_sub_shm = (sr_multi_sub_shm_t *)change_subs->sub_shm.addr;
 
@@ -3008,6 +3679,7 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
             NULL, NULL))) {
         goto cleanup;
     }
+    sr_time_get(&listen_ts, 0);
 
     for (i = 0; i < change_subs->sub_count; ++i) {
         if (sr_shmsub_change_listen_is_new_event(multi_sub_shm, &change_subs->subs[i])) {
@@ -3020,7 +3692,8 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
     }
 
     /* open sub data SHM */
-    if ((err_info = sr_shmsub_data_open_remap(change_subs->module_name, sr_ds2str(change_subs->ds), -1, &shm_data_sub, 0))) {
+    if ((err_info = sr_shmsub_data_open_remap(conn, change_subs->module_name, sr_ds2str(change_subs->ds), -1,
+            &shm_data_sub, 0))) {
         goto cleanup_rdunlock;
     }
     shm_data_ptr = shm_data_sub.addr;
@@ -3030,20 +3703,32 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
     sub_info.request_id = multi_sub_shm->request_id;
     sub_info.priority = multi_sub_shm->priority;
 
+    /* remember event latencies */
+    queue_time = multi_sub_shm->queue_time;
+    wakeup_time = sr_time_sub_us(&listen_ts, &multi_sub_shm->publish_ts);
+    for (j = 0; j < change_subs->sub_count; ++j) {
+        change_subs->subs[j].cb_time = -2;
+    }
+
     /* parse originator name and data (while creating the event session) */
     if ((err_info = _sr_session_start(conn, change_subs->ds, multi_sub_shm->event, &shm_data_ptr, &ev_sess))) {
         goto cleanup_rdunlock;
     }
 
-    /* parse event diff */
-    if (lyd_parse_data_mem(conn->ly_ctx, shm_data_ptr, LYD_LYB, LYD_PARSE_ONLY | LYD_PARSE_STRICT, 0, &diff)) {
-        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
-        SR_ERRINFO_INT(&err_info);
+    /* assign the indexed event diff to session */
+    if ((err_info = sr_session_set_ev_diff_shm(ev_sess, shm_data_ptr))) {
         goto cleanup_rdunlock;
     }
 
-    /* assign to session */
-    ev_sess->dt[ev_sess->ds].diff = diff;
+    /* parse only the diff subtrees the subscriptions with the event are interested in */
+    for (j = i; j < change_subs->sub_count; ++j) {
+        if (!sr_shmsub_change_listen_is_new_event(multi_sub_shm, &change_subs->subs[j])) {
+            continue;
+        }
+        if ((err_info = sr_session_ev_diff_parse(ev_sess, change_subs->module_name, change_subs->subs[j].xpath))) {
+            goto cleanup_rdunlock;
+        }
+    }
 
     /* process event */
     SR_LOG_INF("Processing \"%s\" \"%s\" event with ID %" PRIu32 " priority %" PRIu32 " (remaining %" PRIu32 " subscribers).",
@@ -3065,12 +3750,16 @@ process_event:
         sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ_UPGR, conn->cid, __func__);
 
         /* call callback if there are some changes */
-        if (sr_shmsub_change_listen_filter_is_valid(change_sub, diff)) {
+        if (sr_shmsub_change_listen_filter_is_valid(change_sub, ev_sess->dt[ev_sess->ds].diff, conn)) {
+            sr_time_get(&cb_ts, 0);
             ret = change_sub->cb(ev_sess, change_sub->sub_id, change_subs->module_name, change_sub->xpath,
                     sr_ev2api(sub_info.event), sub_info.request_id, change_sub->private_data);
+            change_sub->cb_time = sr_time_since_us(&cb_ts);
+            sr_time_get(&cb_ts, 0);
         } else {
             /* filtered out */
             ATOMIC_INC_RELAXED(change_sub->filtered_out);
+            change_sub->cb_time = -1;
         }
 
         /* SUB READ UPGR LOCK */
@@ -3082,6 +3771,7 @@ process_event:
         if ((sub_info.event == SR_SUB_EV_UPDATE) || (sub_info.event == SR_SUB_EV_CHANGE)) {
             if (ret == SR_ERR_CALLBACK_SHELVE) {
                 /* this subscription did not process the event yet, skip it */
+                change_sub->cb_time = -2;
                 SR_LOG_INF("Shelved processing of \"%s\" event with ID %" PRIu32 " priority %" PRIu32 ".",
                         sr_ev2str(sub_info.event), sub_info.request_id, sub_info.priority);
                 continue;
@@ -3155,11 +3845,30 @@ process_event:
             data_len, err_code ? "Failed" : "Successful"))) {
         goto cleanup_wrunlock;
     }
+    result_time = sr_time_since_us(&cb_ts);
+    finished = 1;
 
 cleanup_wrunlock:
     /* SUB WRITE UNLOCK */
     sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
 
+    if (finished) {
+        /* update latency statistics of all the subscriptions that processed the event */
+        for (i = 0; i < change_subs->sub_count; ++i) {
+            change_sub = &change_subs->subs[i];
+            if (change_sub->cb_time == -2) {
+                continue;
+            }
+
+            if ((err_info = sr_shmext_change_sub_latency_add(conn, change_subs->module_name, change_subs->ds,
+                    change_sub->sub_id, queue_time, wakeup_time, change_sub->cb_time,
+                    (change_sub->cb_time > -1) ? result_time : 0))) {
+                /* not critical */
+                sr_errinfo_free(&err_info);
+            }
+        }
+    }
+
     goto cleanup;
 
 cleanup_rdunlock:
@@ -3169,7 +3878,7 @@ cleanup_rdunlock:
 cleanup:
     free(data);
     sr_session_stop(ev_sess);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
     return err_info;
 }
 
@@ -3213,7 +3922,7 @@ sr_shmsub_listen_write_event(sr_sub_shm_t *sub_shm, sr_error_t err_code, sr_shm_
 
     if (data && data_len) {
         /* remap if needed */
-        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, -1, shm_data_sub, data_len))) {
+        if ((err_info = sr_shmsub_data_open_remap(NULL, NULL, NULL, -1, shm_data_sub, data_len))) {
             return err_info;
         }
 
@@ -3298,7 +4007,8 @@ sr_shmsub_oper_get_listen_process_module_events(struct modsub_operget_s *oper_ge
         request_id = sub_shm->request_id;
 
         /* open sub data SHM */
-        if ((err_info = sr_shmsub_data_open_remap(oper_get_subs->module_name, "oper", sr_str_hash(oper_get_sub->path,
+        if ((err_info = sr_shmsub_data_open_remap(conn, oper_get_subs->module_name, "oper",
+                sr_str_hash(oper_get_sub->path,
                 oper_get_sub->priority), &shm_data_sub, 0))) {
             goto error_rdunlock;
         }
@@ -3400,7 +4110,7 @@ next_iter:
         data = NULL;
         lyd_free_all(parent);
         parent = NULL;
-        sr_shm_clear(&shm_data_sub);
+        sr_shmsub_cache_release(conn, &shm_data_sub);
     }
 
     /* success */
@@ -3420,7 +4130,7 @@ error:
     free(data);
     lyd_free_all(parent);
     free(request_xpath);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
     return err_info;
 }
 
@@ -3519,86 +4229,380 @@ sr_shmsub_oper_poll_listen_is_cache_valid(const struct sr_oper_poll_cache_s *cac
     return 1;
 }
 
-sr_error_info_t *
-sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_poll_subs, sr_conn_ctx_t *conn,
-        struct timespec *wake_up_in)
+/**
+ * @brief Add data into a 64-bit FNV-1a hash.
+ *
+ * @param[in] hash Hash to add to.
+ * @param[in] data Data to add.
+ * @param[in] len Length of @p data.
+ * @return Updated hash.
+ */
+static uint64_t
+sr_shmsub_oper_poll_hash_add(uint64_t hash, const void *data, size_t len)
 {
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    uint32_t i, j;
-    sr_data_t *data = NULL;
-    const struct lys_module *ly_mod;
-    struct sr_mod_info_s mod_info = {0};
-    sr_lock_mode_t change_sub_lock = SR_LOCK_NONE;
-    struct sr_oper_poll_cache_s *cache;
-    struct modsub_operpollsub_s *oper_poll_sub;
-    struct timespec invalid_in;
-    int found;
-    sr_session_ctx_t *ev_sess = NULL;
-    sr_get_options_t get_opts;
+    const uint8_t *ptr = data;
+    size_t i;
 
-    /* find LY module */
-    ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, oper_poll_subs->module_name);
-    SR_CHECK_INT_GOTO(!ly_mod, err_info, cleanup);
+    for (i = 0; i < len; ++i) {
+        hash ^= ptr[i];
+        hash *= 0x100000001b3ULL;
+    }
 
-    /* init mod info */
-    SR_MODINFO_INIT(mod_info, conn, SR_DS_OPERATIONAL, SR_DS_OPERATIONAL);
-    if ((err_info = sr_modinfo_add(ly_mod, NULL, 0, 0, &mod_info))) {
-        goto cleanup;
+    return hash;
+}
+
+/**
+ * @brief Compute content hashes of a subtree and all its descendants, store them in their private pointers.
+ *
+ * The content hash covers everything compared by a diff: schema node, value, default flag, and the children
+ * in their order. Subtrees with anydata or opaque nodes get hash 0 which is never equal to any other.
+ *
+ * Subtrees with equal hashes are considered equal without comparing them, so an unchanged subtree costs only its
+ * hashing. The providers generate the data, not an adversary, and the chance of 2 different subtrees having
+ * the same 64-bit hash is negligible compared to the cost of comparing every unchanged subtree.
+ *
+ * @param[in] node Subtree to hash.
+ * @return Content hash of @p node, 0 if unknown.
+ */
+static uint64_t
+sr_shmsub_oper_poll_hash_r(struct lyd_node *node)
+{
+    struct lyd_node *child;
+    uint64_t hash = 0xcbf29ce484222325ULL, child_hash;
+    const char *val;
+    int unknown = 0, dflt;
+
+    if (!node->schema || (node->schema->nodetype & LYS_ANYDATA)) {
+        /* content not hashed, it is always compared */
+        unknown = 1;
+    } else {
+        hash = sr_shmsub_oper_poll_hash_add(hash, &node->schema, sizeof node->schema);
+        dflt = (node->flags & LYD_DEFAULT) ? 1 : 0;
+        hash = sr_shmsub_oper_poll_hash_add(hash, &dflt, sizeof dflt);
+        if (node->schema->nodetype & LYD_NODE_TERM) {
+            val = lyd_get_value(node);
+            hash = sr_shmsub_oper_poll_hash_add(hash, val, strlen(val) + 1);
+        }
     }
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_NONE, SR_MI_DATA_NO | SR_MI_PERM_NO, 0, NULL, NULL,
-            0, 0, 0))) {
-        goto cleanup;
+
+    LY_LIST_FOR(lyd_child(node), child) {
+        child_hash = sr_shmsub_oper_poll_hash_r(child);
+        if (!child_hash) {
+            unknown = 1;
+        }
+        hash = sr_shmsub_oper_poll_hash_add(hash, &child_hash, sizeof child_hash);
     }
 
-    /* CHANGE SUB READ LOCK */
-    if ((err_info = sr_modinfo_changesub_rdlock(&mod_info))) {
+    if (unknown) {
+        hash = 0;
+    } else if (!hash) {
+        hash = 1;
+    }
+    node->priv = (void *)(uintptr_t)hash;
+    return hash;
+}
+
+/**
+ * @brief Merge a diff of oper poll data subtrees into the whole diff.
+ *
+ * @param[in] first First subtree, NULL if created.
+ * @param[in] second Second subtree, NULL if deleted.
+ * @param[in,out] diff Diff to merge into.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_oper_poll_diff_tree(const struct lyd_node *first, const struct lyd_node *second, struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct ly_ctx *ly_ctx = first ? LYD_CTX(first) : LYD_CTX(second);
+    struct lyd_node *tree_diff = NULL;
+
+    if (lyd_diff_tree(first, second, LYD_DIFF_DEFAULTS, &tree_diff)) {
+        sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+        goto cleanup;
+    }
+    if (!tree_diff) {
         goto cleanup;
     }
-    change_sub_lock = SR_LOCK_READ;
 
-    /* CONN OPER CACHE READ LOCK */
-    if ((err_info = sr_rwlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
-            __func__, NULL, NULL))) {
+    if (!*diff) {
+        *diff = tree_diff;
+        tree_diff = NULL;
+    } else if (lyd_diff_merge_all(diff, tree_diff, 0)) {
+        sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
         goto cleanup;
     }
 
-    for (i = 0; i < oper_poll_subs->sub_count; ++i) {
-        oper_poll_sub = &oper_poll_subs->subs[i];
+cleanup:
+    lyd_free_siblings(tree_diff);
+    return err_info;
+}
 
-        /* find the oper cache entry */
-        cache = NULL;
-        for (j = 0; j < conn->oper_cache_count; ++j) {
-            if (conn->oper_caches[j].sub_id == oper_poll_sub->sub_id) {
-                cache = &conn->oper_caches[j];
-                break;
-            }
-        }
-        assert(cache);
+/**
+ * @brief Learn how to match the instances of 2 oper poll data sibling sets.
+ *
+ * Instances that are matched based on their order (user-ordered and duplicate-instance lists and leaf-lists) can be
+ * matched only if both the sets consist of the same instances in the same order.
+ *
+ * @param[in] first First siblings.
+ * @param[in] second Second siblings.
+ * @return 0 if the instances are matched by their identity;
+ * @return 1 if they are matched by their position;
+ * @return -1 if they cannot be matched and the sets must be diffed whole.
+ */
+static int
+sr_shmsub_oper_poll_diff_siblings_match(const struct lyd_node *first, const struct lyd_node *second)
+{
+    const struct lyd_node *node1, *node2;
+    int ordered = 0;
 
-        /* CACHE DATA WRITE LOCK */
-        if ((err_info = sr_rwlock(&cache->data_lock, SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid,
-                __func__, NULL, NULL))) {
-            goto cleanup_unlock;
+    LY_LIST_FOR(first, node1) {
+        if (!node1->schema) {
+            return -1;
+        } else if (lysc_is_userordered(node1->schema) || lysc_is_dup_inst_list(node1->schema)) {
+            ordered = 1;
         }
-
-        /* 1) check that there is an oper get subscription */
-        if ((err_info = sr_shmsub_oper_poll_listen_find_get_sub(conn, oper_poll_subs->module_name, oper_poll_sub->path,
-                &found))) {
-            goto finish_iter;
+    }
+    LY_LIST_FOR(second, node2) {
+        if (!node2->schema) {
+            return -1;
+        } else if (lysc_is_userordered(node2->schema) || lysc_is_dup_inst_list(node2->schema)) {
+            ordered = 1;
         }
-        if (!found) {
-            /* free any previously cached data and timestamp */
-            lyd_free_siblings(cache->data);
-            cache->data = NULL;
-            memset(&cache->timestamp, 0, sizeof cache->timestamp);
+    }
+    if (!ordered) {
+        return 0;
+    }
 
-            SR_LOG_INF("No operational get subscription \"%s\" to cache.", oper_poll_sub->path);
-            goto finish_iter;
+    /* the same instances in the same order */
+    for (node1 = first, node2 = second; node1 && node2; node1 = node1->next, node2 = node2->next) {
+        if (node1->schema != node2->schema) {
+            return -1;
+        }
+        if ((node1->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) && lyd_compare_single(node1, node2, 0)) {
+            return -1;
         }
+    }
 
-        /* 2) check cache validity */
-        if (sr_shmsub_oper_poll_listen_is_cache_valid(cache, oper_poll_sub->valid_ms, &invalid_in)) {
-            /* update when to wake up */
+    return (node1 || node2) ? -1 : 1;
+}
+
+static sr_error_info_t *sr_shmsub_oper_poll_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second,
+        int by_position, struct lyd_node **diff);
+
+/**
+ * @brief Generate diff of 2 instances of the same oper poll data node with content hashes, skipping all the equal
+ * subtrees.
+ *
+ * @param[in] first First instance.
+ * @param[in] second Second instance.
+ * @param[in,out] diff Diff to merge into.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_oper_poll_diff_node_r(const struct lyd_node *first, const struct lyd_node *second, struct lyd_node **diff)
+{
+    int match;
+
+    if (first->priv && (first->priv == second->priv)) {
+        /* equal subtrees, no diff generated */
+        return NULL;
+    }
+
+    if (!(first->schema->nodetype & LYD_NODE_INNER)) {
+        /* changed term node */
+        return sr_shmsub_oper_poll_diff_tree(first, second, diff);
+    }
+
+    match = sr_shmsub_oper_poll_diff_siblings_match(lyd_child(first), lyd_child(second));
+    if (match == -1) {
+        /* diff the whole subtrees */
+        return sr_shmsub_oper_poll_diff_tree(first, second, diff);
+    }
+
+    /* diff only the children that differ */
+    return sr_shmsub_oper_poll_diff_siblings_r(lyd_child(first), lyd_child(second), match, diff);
+}
+
+/**
+ * @brief Generate diff of 2 oper poll data sibling sets with content hashes, skipping all the equal subtrees.
+ *
+ * @param[in] first First siblings.
+ * @param[in] second Second siblings.
+ * @param[in] by_position Whether the instances are matched by their position or identity,
+ * see ::sr_shmsub_oper_poll_diff_siblings_match().
+ * @param[in,out] diff Diff to merge into.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_oper_poll_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second, int by_position,
+        struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lyd_node *node, *node2;
+    struct lyd_node *match;
+
+    if (by_position) {
+        /* the same instances, just compare them */
+        for (node = first, node2 = second; node; node = node->next, node2 = node2->next) {
+            if ((err_info = sr_shmsub_oper_poll_diff_node_r(node, node2, diff))) {
+                return err_info;
+            }
+        }
+        return NULL;
+    }
+
+    /* changed and created nodes */
+    LY_LIST_FOR(second, node) {
+        match = NULL;
+        if (first) {
+            lyd_find_sibling_first(first, node, &match);
+        }
+
+        if (match) {
+            err_info = sr_shmsub_oper_poll_diff_node_r(match, node, diff);
+        } else {
+            err_info = sr_shmsub_oper_poll_diff_tree(NULL, node, diff);
+        }
+        if (err_info) {
+            return err_info;
+        }
+    }
+
+    /* deleted nodes */
+    LY_LIST_FOR(first, node) {
+        if (second && !lyd_find_sibling_first(second, node, NULL)) {
+            continue;
+        }
+
+        if ((err_info = sr_shmsub_oper_poll_diff_tree(node, NULL, diff))) {
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Generate diff of cached oper poll data and new data, using and computing their content hashes.
+ *
+ * @param[in] cache_data Cached data with content hashes.
+ * @param[in] data New data, their content hashes are computed.
+ * @param[out] diff Generated diff, NULL if there are no changes.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_oper_poll_diff(const struct lyd_node *cache_data, struct lyd_node *data, struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+    int match;
+
+    *diff = NULL;
+
+    /* compute content hashes of the new data */
+    LY_LIST_FOR(data, node) {
+        sr_shmsub_oper_poll_hash_r(node);
+    }
+
+    match = (cache_data && data) ? sr_shmsub_oper_poll_diff_siblings_match(cache_data, data) : -1;
+    if (match == -1) {
+        /* full diff */
+        if (lyd_diff_siblings(cache_data, data, LYD_DIFF_DEFAULTS, diff)) {
+            sr_errinfo_new_ly(&err_info, cache_data ? LYD_CTX(cache_data) : LYD_CTX(data), NULL);
+        }
+    } else {
+        /* diff only the subtrees with different content hashes */
+        err_info = sr_shmsub_oper_poll_diff_siblings_r(cache_data, data, match, diff);
+    }
+
+    if (err_info) {
+        lyd_free_siblings(*diff);
+        *diff = NULL;
+    }
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_poll_subs, sr_conn_ctx_t *conn,
+        struct timespec *wake_up_in)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    uint32_t i, j;
+    sr_data_t *data = NULL;
+    const struct lys_module *ly_mod;
+    struct sr_mod_info_s mod_info = {0};
+    sr_lock_mode_t change_sub_lock = SR_LOCK_NONE;
+    struct sr_oper_poll_cache_s *cache;
+    struct modsub_operpollsub_s *oper_poll_sub;
+    struct timespec invalid_in;
+    int found;
+    sr_session_ctx_t *ev_sess = NULL;
+    sr_get_options_t get_opts;
+
+    /* find LY module */
+    ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, oper_poll_subs->module_name);
+    SR_CHECK_INT_GOTO(!ly_mod, err_info, cleanup);
+
+    /* init mod info */
+    SR_MODINFO_INIT(mod_info, conn, SR_DS_OPERATIONAL, SR_DS_OPERATIONAL);
+    if ((err_info = sr_modinfo_add(ly_mod, NULL, 0, 0, &mod_info))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_NONE, SR_MI_DATA_NO | SR_MI_PERM_NO, 0, NULL, NULL,
+            0, 0, 0))) {
+        goto cleanup;
+    }
+
+    /* CHANGE SUB READ LOCK */
+    if ((err_info = sr_modinfo_changesub_rdlock(&mod_info))) {
+        goto cleanup;
+    }
+    change_sub_lock = SR_LOCK_READ;
+
+    /* CONN OPER CACHE READ LOCK */
+    if ((err_info = sr_rwlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
+            __func__, NULL, NULL))) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < oper_poll_subs->sub_count; ++i) {
+        oper_poll_sub = &oper_poll_subs->subs[i];
+
+        /* find the oper cache entry */
+        cache = NULL;
+        for (j = 0; j < conn->oper_cache_count; ++j) {
+            if (conn->oper_caches[j].sub_id == oper_poll_sub->sub_id) {
+                cache = &conn->oper_caches[j];
+                break;
+            }
+        }
+        assert(cache);
+
+        /* CACHE DATA WRITE LOCK */
+        if ((err_info = sr_rwlock(&cache->data_lock, SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid,
+                __func__, NULL, NULL))) {
+            goto cleanup_unlock;
+        }
+
+        /* 1) check that there is an oper get subscription */
+        if ((err_info = sr_shmsub_oper_poll_listen_find_get_sub(conn, oper_poll_subs->module_name, oper_poll_sub->path,
+                &found))) {
+            goto finish_iter;
+        }
+        if (!found) {
+            /* free any previously cached data and timestamp */
+            lyd_free_siblings(cache->data);
+            cache->data = NULL;
+            memset(&cache->timestamp, 0, sizeof cache->timestamp);
+
+            SR_LOG_INF("No operational get subscription \"%s\" to cache.", oper_poll_sub->path);
+            goto finish_iter;
+        }
+
+        /* 2) check cache validity */
+        if (sr_shmsub_oper_poll_listen_is_cache_valid(cache, oper_poll_sub->valid_ms, &invalid_in)) {
+            /* update when to wake up */
             if (wake_up_in && (!wake_up_in->tv_sec || (sr_time_cmp(&invalid_in, wake_up_in) < 0))) {
                 *wake_up_in = invalid_in;
             }
@@ -3625,8 +4629,7 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
         if (oper_poll_sub->opts & SR_SUBSCR_OPER_POLL_DIFF) {
             /* prepare mod info */
             mod_info.data = cache->data;
-            if (lyd_diff_siblings(cache->data, data->tree, LYD_DIFF_DEFAULTS, &mod_info.diff)) {
-                sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+            if ((err_info = sr_shmsub_oper_poll_diff(cache->data, data->tree, &mod_info.diff))) {
                 goto finish_iter;
             }
 
@@ -3680,7 +4683,7 @@ finish_iter:
             sr_errinfo_free(&cb_err_info);
 
             /* publish "done" event */
-            if ((err_info = sr_shmsub_change_notify_change_done(&mod_info, NULL, NULL, SR_CHANGE_CB_TIMEOUT))) {
+            if ((err_info = sr_shmsub_change_notify_change_done(&mod_info, NULL, NULL, SR_CHANGE_CB_TIMEOUT, 0))) {
                 goto cleanup_unlock;
             }
 
@@ -3885,11 +4888,12 @@ cleanup:
  *
  * @param[in] multi_sub_shm SHM to read from.
  * @param[in] sub Current subscription.
+ * @param[in] slot Slot of @p multi_sub_shm.
  * @return 0 if not.
  * @return non-zero if this is a new event for the subscription.
  */
 static int
-sr_shmsub_rpc_listen_is_new_event(sr_multi_sub_shm_t *multi_sub_shm, struct opsub_rpcsub_s *sub)
+sr_shmsub_rpc_listen_is_new_event(sr_multi_sub_shm_t *multi_sub_shm, struct opsub_rpcsub_s *sub, uint32_t slot)
 {
     /* not a listener event */
     if (!SR_IS_LISTEN_EVENT(multi_sub_shm->event)) {
@@ -3897,11 +4901,11 @@ sr_shmsub_rpc_listen_is_new_event(sr_multi_sub_shm_t *multi_sub_shm, struct opsu
     }
 
     /* new event and request ID */
-    if ((multi_sub_shm->request_id == sub->request_id) && (multi_sub_shm->event == sub->event)) {
+    if ((multi_sub_shm->request_id == sub->slots[slot].request_id) && (multi_sub_shm->event == sub->slots[slot].event)) {
         return 0;
     }
-    if ((multi_sub_shm->event == SR_SUB_EV_ABORT) && ((sub->event != SR_SUB_EV_RPC) ||
-            (sub->request_id != multi_sub_shm->request_id))) {
+    if ((multi_sub_shm->event == SR_SUB_EV_ABORT) && ((sub->slots[slot].event != SR_SUB_EV_RPC) ||
+            (sub->slots[slot].request_id != multi_sub_shm->request_id))) {
         /* process "abort" only on subscriptions that have successfully processed "RPC" */
         return 0;
     }
@@ -3978,8 +4982,16 @@ sr_shmsub_rpc_listen_relock(sr_multi_sub_shm_t *multi_sub_shm, sr_lock_mode_t mo
     return 0;
 }
 
-sr_error_info_t *
-sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ctx_t *conn)
+/**
+ * @brief Process a new event in an RPC/action sub SHM slot, if any.
+ *
+ * @param[in] rpc_subs RPC/action subscriptions.
+ * @param[in] slot Sub SHM slot to process.
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_rpc_listen_process_slot(struct opsub_rpc_s *rpc_subs, uint32_t slot, sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
     uint32_t i, data_len = 0, valid_subscr_count;
@@ -3993,7 +5005,7 @@ sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ct
     sr_session_ctx_t *ev_sess = NULL;
     struct info_sub_s sub_info;
 
-    multi_sub_shm = (sr_multi_sub_shm_t *)rpc_subs->sub_shm.addr;
+    multi_sub_shm = (sr_multi_sub_shm_t *)rpc_subs->sub_shm[slot].addr;
 
     /* SUB READ UPGR LOCK */
     if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ_UPGR, conn->cid, __func__,
@@ -4003,12 +5015,13 @@ sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ct
 
     for (i = 0; i < rpc_subs->sub_count; ++i) {
         rpc_sub = &rpc_subs->subs[i];
-        if (sr_shmsub_rpc_listen_is_new_event(multi_sub_shm, rpc_sub)) {
+        if (sr_shmsub_rpc_listen_is_new_event(multi_sub_shm, rpc_sub, slot)) {
             /* there is a new event so there is some operation that can be parsed */
             if (!ev_sess) {
                 /* open sub data SHM */
                 module_name = sr_get_first_ns(rpc_subs->path);
-                if ((err_info = sr_shmsub_data_open_remap(module_name, "rpc", sr_str_hash(rpc_subs->path, 0), &shm_data_sub, 0))) {
+                if ((err_info = sr_shmsub_data_open_remap(conn, module_name, "rpc", sr_str_hash(rpc_subs->path, slot),
+                        &shm_data_sub, 0))) {
                     goto cleanup_rdunlock;
                 }
                 shm_data_ptr = shm_data_sub.addr;
@@ -4029,7 +5042,7 @@ sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ct
             assert(input);
 
             /* XPath filtering */
-            if (sr_shmsub_rpc_listen_filter_is_valid(input, rpc_sub->xpath)) {
+            if (sr_shmsub_rpc_listen_filter_is_valid(input, rpc_sub->xpath, &rpc_sub->xpath_snodes, conn)) {
                 break;
             }
         }
@@ -4060,8 +5073,8 @@ sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ct
     goto process_event;
     for ( ; i < rpc_subs->sub_count; ++i) {
         rpc_sub = &rpc_subs->subs[i];
-        if (!sr_shmsub_rpc_listen_is_new_event(multi_sub_shm, rpc_sub) ||
-                !sr_shmsub_rpc_listen_filter_is_valid(input, rpc_sub->xpath)) {
+        if (!sr_shmsub_rpc_listen_is_new_event(multi_sub_shm, rpc_sub, slot) ||
+                !sr_shmsub_rpc_listen_filter_is_valid(input, rpc_sub->xpath, &rpc_sub->xpath_snodes, conn)) {
             continue;
         }
 
@@ -4095,8 +5108,8 @@ process_event:
                 err_code = ret;
 
                 /* remember request ID and "abort" event so that we do not process it */
-                rpc_sub->request_id = multi_sub_shm->request_id;
-                rpc_sub->event = SR_SUB_EV_ABORT;
+                rpc_sub->slots[slot].request_id = multi_sub_shm->request_id;
+                rpc_sub->slots[slot].event = SR_SUB_EV_ABORT;
                 break;
             }
         }
@@ -4105,8 +5118,8 @@ process_event:
         ++valid_subscr_count;
 
         /* remember request ID and event so that we do not process it again */
-        rpc_sub->request_id = multi_sub_shm->request_id;
-        rpc_sub->event = multi_sub_shm->event;
+        rpc_sub->slots[slot].request_id = multi_sub_shm->request_id;
+        rpc_sub->slots[slot].event = multi_sub_shm->event;
     }
 
     /*
@@ -4153,113 +5166,604 @@ cleanup:
     ly_in_free(in, 0);
     lyd_free_all(input);
     lyd_free_all(output);
-    sr_shm_clear(&shm_data_sub);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
     return err_info;
 }
 
 /**
- * @brief Whether a notification is valid (not filtered out) for a notif subscription.
+ * @brief Check whether there is a new event in an RPC/action sub SHM slot for any of the subscriptions.
  *
- * @param[in] input Operation input data tree.
- * @param[in] xpath Full subscription XPath.
- * @return 0 if not, non-zero is it is.
+ * @param[in] rpc_subs RPC/action subscriptions.
+ * @param[in] slot Sub SHM slot to check.
+ * @param[in] conn Connection to use.
+ * @param[out] has_event Whether there is a new event.
+ * @return err_info, NULL on success.
  */
-static int
-sr_shmsub_notif_listen_filter_is_valid(const struct lyd_node *notif, const char *xpath)
+static sr_error_info_t *
+sr_shmsub_rpc_listen_slot_has_event(struct opsub_rpc_s *rpc_subs, uint32_t slot, sr_conn_ctx_t *conn, int *has_event)
 {
     sr_error_info_t *err_info = NULL;
-    ly_bool result;
+    sr_multi_sub_shm_t *multi_sub_shm;
+    uint32_t i;
 
-    if (!xpath) {
-        return 1;
+    *has_event = 0;
+    multi_sub_shm = (sr_multi_sub_shm_t *)rpc_subs->sub_shm[slot].addr;
+
+    /* SUB READ LOCK */
+    if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
+            NULL, NULL))) {
+        return err_info;
     }
 
-    if (lyd_eval_xpath(notif, xpath, &result)) {
-        SR_ERRINFO_INT(&err_info);
-        sr_errinfo_free(&err_info);
-        return 0;
-    } else if (result) {
-        /* valid subscription */
-        return 1;
+    for (i = 0; i < rpc_subs->sub_count; ++i) {
+        if (sr_shmsub_rpc_listen_is_new_event(multi_sub_shm, &rpc_subs->subs[i], slot)) {
+            *has_event = 1;
+            break;
+        }
     }
 
-    return 0;
+    /* SUB READ UNLOCK */
+    sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+    return NULL;
 }
 
-sr_error_info_t *
-sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs, sr_conn_ctx_t *conn)
+/**
+ * @brief Pass subscriptions with a new event to the subscription worker threads.
+ *
+ * @param[in] subscr Subscription structure with the workers.
+ * @param[in] type Type of the subscriptions.
+ * @param[in] path Module name or RPC/action path.
+ * @param[in] ds Datastore of change subscriptions.
+ * @param[in] slot Sub SHM slot with the RPC/action event.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_workers_add_job(sr_subscription_ctx_t *subscr, sr_subscr_job_type_t type, const char *path,
+        sr_datastore_t ds, uint32_t slot)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i, request_id;
-    struct lyd_node *orig_notif = NULL, *notif_dup = NULL, *notif, *notif_op;
-    const struct lyd_node *denied_node;
-    struct ly_in *in = NULL;
-    struct timespec notif_ts;
-    char *shm_data_ptr;
-    sr_multi_sub_shm_t *multi_sub_shm;
-    sr_shm_t shm_data_sub = SR_SHM_INITIALIZER;
-    sr_session_ctx_t *ev_sess = NULL;
-    struct modsub_notifsub_s *sub;
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+    void *mem;
+    char *job_path;
 
-    multi_sub_shm = (sr_multi_sub_shm_t *)notif_subs->sub_shm.addr;
+    job_path = strdup(path);
+    SR_CHECK_MEM_RET(!job_path, err_info);
 
-    /* SUB READ LOCK */
-    if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
-            NULL, NULL))) {
-        goto cleanup;
-    }
+    /* WORKERS LOCK */
+    pthread_mutex_lock(&workers->lock);
 
-    /* no new event */
-    if ((multi_sub_shm->event != SR_SUB_EV_NOTIF) || (multi_sub_shm->request_id == notif_subs->request_id)) {
-        goto cleanup_rdunlock;
-    }
-    request_id = multi_sub_shm->request_id;
+    mem = realloc(workers->jobs, (workers->job_count + 1) * sizeof *workers->jobs);
+    if (!mem) {
+        /* WORKERS UNLOCK */
+        pthread_mutex_unlock(&workers->lock);
 
-    /* open sub data SHM */
-    if ((err_info = sr_shmsub_data_open_remap(notif_subs->module_name, "notif", -1, &shm_data_sub, 0))) {
-        goto cleanup_rdunlock;
+        free(job_path);
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
     }
-    shm_data_ptr = shm_data_sub.addr;
+    workers->jobs = mem;
+    workers->jobs[workers->job_count].type = type;
+    workers->jobs[workers->job_count].path = job_path;
+    workers->jobs[workers->job_count].ds = ds;
+    workers->jobs[workers->job_count].slot = slot;
+    ++workers->job_count;
 
-    /* parse originator name and data (while creating the event session) */
-    if ((err_info = _sr_session_start(conn, SR_DS_OPERATIONAL, SR_SUB_EV_NOTIF, &shm_data_ptr, &ev_sess))) {
-        goto cleanup_rdunlock;
-    }
+    /* wake up a worker */
+    sr_cond_broadcast(&workers->cond);
 
-    /* parse timestamp */
-    memcpy(&notif_ts, shm_data_ptr, sizeof notif_ts);
-    shm_data_ptr += sizeof notif_ts;
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
 
-    /* parse notification */
-    ly_in_new_memory(shm_data_ptr, &in);
-    if (lyd_parse_op(conn->ly_ctx, NULL, in, LYD_LYB, LYD_TYPE_NOTIF_YANG, &orig_notif, NULL)) {
-        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
-        SR_ERRINFO_INT(&err_info);
-        goto cleanup_rdunlock;
-    }
+    return NULL;
+}
 
-    /* SUB READ UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+sr_error_info_t *
+sr_shmsub_workers_add_group_job(sr_subscription_ctx_t *subscr, ATOMIC_T *busy, sr_subscr_job_type_t type,
+        const char *name, sr_datastore_t ds)
+{
+    sr_error_info_t *err_info = NULL;
+    uint_fast32_t exp;
+    int result;
+
+    while (1) {
+        exp = SR_SUBSCR_IDLE;
+        ATOMIC_COMPARE_EXCHANGE_RELAXED(*busy, exp, SR_SUBSCR_BUSY, result);
+        if (result) {
+            /* a new job is needed */
+            break;
+        } else if (exp == SR_SUBSCR_BUSY_AGAIN) {
+            /* the worker will check for new events */
+            return NULL;
+        }
 
-    /* process event */
-    SR_LOG_INF("Processing \"notif\" \"%s\" event with ID %" PRIu32 ".", notif_subs->module_name, request_id);
+        /* a worker is processing the events, make it check for new events once finished */
+        ATOMIC_COMPARE_EXCHANGE_RELAXED(*busy, exp, SR_SUBSCR_BUSY_AGAIN, result);
+        if (result) {
+            return NULL;
+        }
 
-    for (i = 0; i < notif_subs->sub_count; ++i) {
-        sub = &notif_subs->subs[i];
-        denied_node = NULL;
+        /* the worker has finished meanwhile, try again */
+    }
 
-        if (sub->sess->nacm_user && !strcmp(orig_notif->schema->module->name, "ietf-yang-push") &&
-                !strcmp(LYD_NAME(orig_notif), "push-change-update")) {
-            if (i == notif_subs->sub_count) {
-                /* last subscription, we can modify the notification */
-                notif = orig_notif;
-            } else {
-                if (!notif_dup) {
-                    /* create notification duplicate */
-                    if (lyd_dup_single(orig_notif, NULL, LYD_DUP_RECURSIVE, &notif_dup)) {
-                        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
-                        goto cleanup;
-                    }
+    if ((err_info = sr_shmsub_workers_add_job(subscr, type, name, ds, 0))) {
+        ATOMIC_STORE_RELAXED(*busy, SR_SUBSCR_IDLE);
+    }
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_subscription_ctx_t *subscr)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t slot;
+    uint_fast32_t exp;
+    int has_event, result;
+
+    for (slot = 0; slot < SR_RPC_SUB_SLOT_COUNT; ++slot) {
+        if (!subscr->workers.count) {
+            /* process the event directly */
+            if ((err_info = sr_shmsub_rpc_listen_process_slot(rpc_subs, slot, subscr->conn))) {
+                return err_info;
+            }
+            continue;
+        }
+
+        /* a worker is already processing the slot and will check it for new events once finished */
+        if (ATOMIC_LOAD_RELAXED(rpc_subs->slot_busy[slot])) {
+            continue;
+        }
+
+        if ((err_info = sr_shmsub_rpc_listen_slot_has_event(rpc_subs, slot, subscr->conn, &has_event))) {
+            return err_info;
+        }
+        if (!has_event) {
+            continue;
+        }
+
+        /* mark the slot busy and pass it to a worker */
+        exp = 0;
+        ATOMIC_COMPARE_EXCHANGE_RELAXED(rpc_subs->slot_busy[slot], exp, 1, result);
+        if (!result) {
+            continue;
+        }
+        if ((err_info = sr_shmsub_workers_add_job(subscr, SR_SUBSCR_JOB_RPC, rpc_subs->path, 0, slot))) {
+            ATOMIC_STORE_RELAXED(rpc_subs->slot_busy[slot], 0);
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Finish processing the events of a group of subscriptions by a worker thread.
+ *
+ * @param[in] busy Worker thread processing state of the group.
+ * @return Whether the worker is finished, 0 if it should check for new events again.
+ */
+static int
+sr_shmsub_worker_group_finish(ATOMIC_T *busy)
+{
+    uint_fast32_t exp;
+    int result;
+
+    exp = SR_SUBSCR_BUSY;
+    ATOMIC_COMPARE_EXCHANGE_RELAXED(*busy, exp, SR_SUBSCR_IDLE, result);
+    if (result) {
+        return 1;
+    }
+
+    /* new events were announced meanwhile, keep the group busy */
+    ATOMIC_STORE_RELAXED(*busy, SR_SUBSCR_BUSY);
+    return 0;
+}
+
+/**
+ * @brief Process an RPC/action job of a subscription worker thread.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[in] job Job to process.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_worker_process_rpc_job(sr_subscription_ctx_t *subscr, struct sr_subscr_job_s *job)
+{
+    sr_error_info_t *err_info = NULL;
+    struct opsub_rpc_s *rpc_subs = NULL;
+    uint32_t i;
+    uint_fast32_t exp;
+    int has_event, result;
+
+    /* the subscriptions may have been removed meanwhile */
+    for (i = 0; i < subscr->rpc_sub_count; ++i) {
+        if (!strcmp(subscr->rpc_subs[i].path, job->path)) {
+            rpc_subs = &subscr->rpc_subs[i];
+            break;
+        }
+    }
+
+    while (rpc_subs) {
+        err_info = sr_shmsub_rpc_listen_process_slot(rpc_subs, job->slot, subscr->conn);
+        ATOMIC_STORE_RELAXED(rpc_subs->slot_busy[job->slot], 0);
+        if (err_info) {
+            break;
+        }
+
+        /* a new event may have been published while the slot was busy and so ignored by the listener */
+        if ((err_info = sr_shmsub_rpc_listen_slot_has_event(rpc_subs, job->slot, subscr->conn, &has_event))) {
+            break;
+        }
+        if (!has_event) {
+            break;
+        }
+
+        exp = 0;
+        ATOMIC_COMPARE_EXCHANGE_RELAXED(rpc_subs->slot_busy[job->slot], exp, 1, result);
+        if (!result) {
+            /* the listener has already passed it to another worker */
+            break;
+        }
+    }
+
+    return err_info;
+}
+
+/**
+ * @brief Process a change, operational get, or notification job of a subscription worker thread.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[in] job Job to process.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_worker_process_group_job(sr_subscription_ctx_t *subscr, struct sr_subscr_job_s *job)
+{
+    sr_error_info_t *err_info = NULL;
+    struct modsub_change_s *change_subs = NULL;
+    struct modsub_operget_s *oper_get_subs = NULL;
+    struct modsub_notif_s *notif_subs = NULL;
+    ATOMIC_T *busy = NULL;
+    uint32_t i;
+
+    /* the subscriptions may have been removed meanwhile */
+    switch (job->type) {
+    case SR_SUBSCR_JOB_CHANGE:
+        for (i = 0; i < subscr->change_sub_count; ++i) {
+            if (!strcmp(subscr->change_subs[i].module_name, job->path) && (subscr->change_subs[i].ds == job->ds)) {
+                change_subs = &subscr->change_subs[i];
+                busy = &change_subs->busy;
+                break;
+            }
+        }
+        break;
+    case SR_SUBSCR_JOB_OPER_GET:
+        for (i = 0; i < subscr->oper_get_sub_count; ++i) {
+            if (!strcmp(subscr->oper_get_subs[i].module_name, job->path)) {
+                oper_get_subs = &subscr->oper_get_subs[i];
+                busy = &oper_get_subs->busy;
+                break;
+            }
+        }
+        break;
+    case SR_SUBSCR_JOB_NOTIF:
+        for (i = 0; i < subscr->notif_sub_count; ++i) {
+            if (!strcmp(subscr->notif_subs[i].module_name, job->path)) {
+                notif_subs = &subscr->notif_subs[i];
+                busy = &notif_subs->busy;
+                break;
+            }
+        }
+        break;
+    case SR_SUBSCR_JOB_RPC:
+        SR_ERRINFO_INT(&err_info);
+        return err_info;
+    }
+
+    if (!busy) {
+        return NULL;
+    }
+
+    /* process the events of the group in order until there are no new ones */
+    do {
+        if (change_subs) {
+            err_info = sr_shmsub_change_listen_process_module_events(change_subs, subscr->conn);
+        } else if (oper_get_subs) {
+            err_info = sr_shmsub_oper_get_listen_process_module_events(oper_get_subs, subscr->conn);
+        } else {
+            err_info = sr_shmsub_notif_listen_process_module_events(notif_subs, 0, subscr->conn);
+        }
+        if (err_info) {
+            ATOMIC_STORE_RELAXED(*busy, SR_SUBSCR_IDLE);
+            break;
+        }
+    } while (!sr_shmsub_worker_group_finish(busy));
+
+    return err_info;
+}
+
+/**
+ * @brief Process a job of a subscription worker thread.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[in] job Job to process.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_worker_process_job(sr_subscription_ctx_t *subscr, struct sr_subscr_job_s *job)
+{
+    sr_error_info_t *err_info = NULL;
+
+    /* SUBS READ LOCK */
+    if ((err_info = sr_rwlock(&subscr->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscr->conn->cid, __func__,
+            NULL, NULL))) {
+        return err_info;
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(subscr->conn, SR_LOCK_READ, 0, __func__))) {
+        goto cleanup_subs_unlock;
+    }
+
+    if (job->type == SR_SUBSCR_JOB_RPC) {
+        err_info = sr_shmsub_worker_process_rpc_job(subscr, job);
+    } else {
+        err_info = sr_shmsub_worker_process_group_job(subscr, job);
+    }
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(subscr->conn, SR_LOCK_READ, 0, __func__);
+
+cleanup_subs_unlock:
+    /* SUBS READ UNLOCK */
+    sr_rwunlock(&subscr->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscr->conn->cid, __func__);
+    return err_info;
+}
+
+void *
+sr_shmsub_worker_thread(void *arg)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_subscription_ctx_t *subscr = (sr_subscription_ctx_t *)arg;
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+    struct sr_subscr_job_s job;
+
+    /* only processes events, the callbacks must not wait for writers that may be waiting for the event originators */
+    sr_rwlock_ev_thread_set(1);
+
+    while (1) {
+        /* WORKERS LOCK */
+        pthread_mutex_lock(&workers->lock);
+
+        /* wait for a job */
+        while (!workers->stop && !workers->job_count) {
+            sr_cond_wait(&workers->cond, &workers->lock);
+        }
+        if (workers->stop) {
+            /* WORKERS UNLOCK */
+            pthread_mutex_unlock(&workers->lock);
+            break;
+        }
+
+        /* take the oldest job */
+        job = workers->jobs[0];
+        --workers->job_count;
+        memmove(workers->jobs, workers->jobs + 1, workers->job_count * sizeof *workers->jobs);
+
+        /* WORKERS UNLOCK */
+        pthread_mutex_unlock(&workers->lock);
+
+        /* process it */
+        if ((err_info = sr_shmsub_worker_process_job(subscr, &job))) {
+            sr_errinfo_free(&err_info);
+        }
+        free(job.path);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Whether a notification is valid (not filtered out) for a notif subscription.
+ *
+ * @param[in] notif Notification operation.
+ * @param[in] sub Notification subscription.
+ * @param[in] conn Connection to use.
+ * @return 0 if not, non-zero is it is.
+ */
+static int
+sr_shmsub_notif_listen_filter_is_valid(const struct lyd_node *notif, struct modsub_notifsub_s *sub, sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    ly_bool result;
+
+    if (!sub->xpath) {
+        return 1;
+    }
+
+    /* quickly filter based on the notification schema node */
+    switch (sr_xpath_snodes_filter_op(conn, &sub->xpath_snodes, notif->schema)) {
+    case 0:
+        return 0;
+    case 1:
+        return 1;
+    default:
+        break;
+    }
+
+    if (lyd_eval_xpath(notif, sub->xpath, &result)) {
+        SR_ERRINFO_INT(&err_info);
+        sr_errinfo_free(&err_info);
+        return 0;
+    } else if (result) {
+        /* valid subscription */
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Structure for processing all the new notifications of a module at once.
+ */
+struct sr_shmsub_notif_batch_s {
+    sr_session_ctx_t *ev_sess;      /**< Event session used for all the notifications. */
+    struct ly_in *in;               /**< Input handler used for parsing all the notifications. */
+    struct lyd_node **trees;        /**< Parsed notifications referenced by the collected ones. */
+    uint32_t tree_count;            /**< Parsed notification count. */
+
+    struct sr_shmsub_notif_batch_sub_s {
+        sr_notif_batch_item_t items[SR_NOTIF_SUB_SLOT_COUNT];  /**< Collected notifications, not yet delivered. */
+        uint32_t count;             /**< Collected notification count. */
+    } *subs;                        /**< Collected notifications for each subscription, only batched ones use it. */
+
+    struct sr_shmsub_notif_batch_ev_s {
+        uint32_t request_id;        /**< Request ID of the event. */
+        uint32_t valid_count;       /**< Number of subscriptions that processed the event. */
+        uint32_t valid_block_count; /**< Number of blocking subscriptions that processed the event. */
+    } events[SR_NOTIF_SUB_SLOT_COUNT];  /**< Processed events to finish once their notifications are delivered. */
+    uint32_t event_count;           /**< Processed event count. */
+};
+
+/**
+ * @brief Keep a parsed notification until all the notifications collected for batched subscriptions are delivered.
+ *
+ * @param[in] batch Notification batch.
+ * @param[in] tree Notification to keep, is spent.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_notif_listen_batch_keep(struct sr_shmsub_notif_batch_s *batch, struct lyd_node *tree)
+{
+    sr_error_info_t *err_info = NULL;
+    void *mem;
+
+    mem = realloc(batch->trees, (batch->tree_count + 1) * sizeof *batch->trees);
+    if (!mem) {
+        lyd_free_all(tree);
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
+    }
+    batch->trees = mem;
+    batch->trees[batch->tree_count] = tree;
+    ++batch->tree_count;
+
+    return NULL;
+}
+
+/**
+ * @brief Process a notification stored in a notification subscription SHM slot.
+ *
+ * Non-batched subscriptions get the notification right away, for batched ones it is collected in @p batch.
+ *
+ * @param[in] notif_subs Module notification subscriptions.
+ * @param[in] request_id Request ID of the notification.
+ * @param[in,out] batch Notification batch to use.
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_notif_listen_process_event(struct modsub_notif_s *notif_subs, uint32_t request_id,
+        struct sr_shmsub_notif_batch_s *batch, sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i, valid_count = 0, valid_block_count = 0;
+    struct lyd_node *orig_notif = NULL, *notif_dup = NULL, *notif, *notif_op;
+    const struct lyd_node *denied_node;
+    struct timespec notif_ts, publish_ts;
+    char *shm_data_ptr;
+    sr_notif_sub_shm_t *notif_shm;
+    struct sr_notif_sub_slot_s *slot;
+    sr_shm_t shm_data_sub = SR_SHM_INITIALIZER;
+    struct modsub_notifsub_s *sub;
+    struct sr_shmsub_notif_batch_sub_s *batch_sub;
+    struct sr_shmsub_notif_batch_ev_s *ev;
+    int orig_kept = 0;
+
+    notif_shm = (sr_notif_sub_shm_t *)notif_subs->sub_shm.addr;
+    slot = &notif_shm->slots[request_id % SR_NOTIF_SUB_SLOT_COUNT];
+
+    /* SUB READ LOCK */
+    if ((err_info = sr_rwlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
+            NULL, NULL))) {
+        goto cleanup;
+    }
+
+    if (slot->request_id != request_id) {
+        /* the notification was already overwritten by a newer one */
+        for (i = 0; i < notif_subs->sub_count; ++i) {
+            ATOMIC_INC_RELAXED(notif_subs->subs[i].dropped);
+        }
+        SR_LOG_WRN("Notification \"%s\" with ID %" PRIu32 " was dropped because the subscriber is lagging.",
+                notif_subs->module_name, request_id);
+        goto cleanup_rdunlock;
+    }
+    publish_ts = slot->publish_ts;
+
+    /* open sub data SHM of the slot */
+    if ((err_info = sr_shmsub_data_open_remap(conn, notif_subs->module_name, "notif",
+            request_id % SR_NOTIF_SUB_SLOT_COUNT, &shm_data_sub, 0))) {
+        goto cleanup_rdunlock;
+    }
+    shm_data_ptr = shm_data_sub.addr;
+
+    /* parse originator name and data (while creating the event session or into the existing one) */
+    if (!batch->ev_sess) {
+        err_info = _sr_session_start(conn, SR_DS_OPERATIONAL, SR_SUB_EV_NOTIF, &shm_data_ptr, &batch->ev_sess);
+    } else {
+        err_info = sr_session_set_orig_shm(batch->ev_sess, &shm_data_ptr);
+    }
+    if (err_info) {
+        goto cleanup_rdunlock;
+    }
+
+    /* parse timestamp */
+    memcpy(&notif_ts, shm_data_ptr, sizeof notif_ts);
+    shm_data_ptr += sizeof notif_ts;
+
+    /* parse notification */
+    if (!batch->in) {
+        ly_in_new_memory(shm_data_ptr, &batch->in);
+    } else {
+        ly_in_memory(batch->in, shm_data_ptr);
+    }
+    if (lyd_parse_op(conn->ly_ctx, NULL, batch->in, LYD_LYB, LYD_TYPE_NOTIF_YANG, &orig_notif, NULL)) {
+        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+        SR_ERRINFO_INT(&err_info);
+        goto cleanup_rdunlock;
+    }
+
+    /* SUB READ UNLOCK */
+    sr_rwunlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+    /* process event */
+    SR_LOG_INF("Processing \"notif\" \"%s\" event with ID %" PRIu32 ".", notif_subs->module_name, request_id);
+
+    for (i = 0; i < notif_subs->sub_count; ++i) {
+        sub = &notif_subs->subs[i];
+        denied_node = NULL;
+
+        if (sr_time_cmp(&sub->listen_since, &publish_ts) > 0) {
+            /* published before the subscription started listening */
+            continue;
+        }
+        ++valid_count;
+        if (!sub->drop) {
+            ++valid_block_count;
+        }
+
+        if (sub->sess->nacm_user && !strcmp(orig_notif->schema->module->name, "ietf-yang-push") &&
+                !strcmp(LYD_NAME(orig_notif), "push-change-update")) {
+            if ((i == notif_subs->sub_count) && !orig_kept) {
+                /* last subscription, we can modify the notification */
+                notif = orig_notif;
+            } else {
+                if (!notif_dup) {
+                    /* create notification duplicate */
+                    if (lyd_dup_single(orig_notif, NULL, LYD_DUP_RECURSIVE, &notif_dup)) {
+                        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+                        goto cleanup;
+                    }
                 }
                 notif = notif_dup;
             }
@@ -4285,10 +5789,32 @@ sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs,
         }
 
         /* NACM and xpath filter */
-        if (!denied_node && sr_shmsub_notif_listen_filter_is_valid(notif_op, sub->xpath)) {
-            /* call callback */
-            if ((err_info = sr_notif_call_callback(ev_sess, sub->cb, sub->tree_cb, sub->private_data,
-                    SR_EV_NOTIF_REALTIME, sub->sub_id, notif_op, &notif_ts))) {
+        if (!denied_node && sr_shmsub_notif_listen_filter_is_valid(notif_op, sub, conn)) {
+            if (sub->batch_cb) {
+                /* keep the notification until the batch is delivered */
+                if (notif == notif_dup) {
+                    notif_dup = NULL;
+                    if ((err_info = sr_shmsub_notif_listen_batch_keep(batch, notif))) {
+                        goto cleanup;
+                    }
+                } else if (!orig_kept) {
+                    if ((err_info = sr_shmsub_notif_listen_batch_keep(batch, orig_notif))) {
+                        orig_notif = NULL;
+                        goto cleanup;
+                    }
+                    orig_kept = 1;
+                }
+
+                /* collect it */
+                batch_sub = &batch->subs[i];
+                assert(batch_sub->count < SR_NOTIF_SUB_SLOT_COUNT);
+                batch_sub->items[batch_sub->count].notif_type = SR_EV_NOTIF_REALTIME;
+                batch_sub->items[batch_sub->count].notif = notif_op;
+                batch_sub->items[batch_sub->count].timestamp = notif_ts;
+                ++batch_sub->count;
+            } else if ((err_info = sr_notif_call_callback(batch->ev_sess, sub->cb, sub->tree_cb, NULL,
+                    sub->private_data, SR_EV_NOTIF_REALTIME, sub->sub_id, notif_op, &notif_ts))) {
+                /* call callback */
                 goto cleanup;
             }
         } else {
@@ -4303,42 +5829,270 @@ sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs,
         }
     }
 
-    /* remember request ID so that we do not process it again */
-    notif_subs->request_id = request_id;
+    /* remember the event, it is finished once all its notifications are delivered */
+    assert(batch->event_count < SR_NOTIF_SUB_SLOT_COUNT);
+    ev = &batch->events[batch->event_count];
+    ev->request_id = request_id;
+    ev->valid_count = valid_count;
+    ev->valid_block_count = valid_block_count;
+    ++batch->event_count;
+    goto cleanup;
+
+cleanup_rdunlock:
+    /* SUB READ UNLOCK */
+    sr_rwunlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+cleanup:
+    if (!orig_kept) {
+        lyd_free_all(orig_notif);
+    }
+    lyd_free_all(notif_dup);
+    sr_shmsub_cache_release(conn, &shm_data_sub);
+    return err_info;
+}
+
+/**
+ * @brief Finish a processed notification event so that its slot can be reused.
+ *
+ * @param[in] notif_subs Module notification subscriptions.
+ * @param[in] ev Processed event.
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_notif_listen_finish_event(struct modsub_notif_s *notif_subs, const struct sr_shmsub_notif_batch_ev_s *ev,
+        sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_notif_sub_shm_t *notif_shm;
+    struct sr_notif_sub_slot_s *slot;
+
+    notif_shm = (sr_notif_sub_shm_t *)notif_subs->sub_shm.addr;
+    slot = &notif_shm->slots[ev->request_id % SR_NOTIF_SUB_SLOT_COUNT];
 
     /* SUB WRITE LOCK */
-    if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
+    if ((err_info = sr_rwlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
             NULL, NULL))) {
-        goto cleanup;
+        return err_info;
     }
 
-    /* no error/timeout should be possible */
-    if ((multi_sub_shm->event != SR_SUB_EV_NOTIF) || (multi_sub_shm->request_id != notif_subs->request_id)) {
-        SR_ERRINFO_INT(&err_info);
-        goto cleanup_wrunlock;
-    }
+    if (slot->request_id == ev->request_id) {
+        /* finish event, the slot may be reused once all the blocking subscribers processed it */
+        slot->subscriber_count -= (ev->valid_count < slot->subscriber_count) ? ev->valid_count : slot->subscriber_count;
+        slot->block_count -= (ev->valid_block_count < slot->block_count) ? ev->valid_block_count : slot->block_count;
 
-    /* finish event */
-    if ((err_info = sr_shmsub_multi_listen_write_event(multi_sub_shm, notif_subs->sub_count, 0, &shm_data_sub, NULL, 0,
-            "Successful"))) {
-        goto cleanup_wrunlock;
+        SR_LOG_INF("Successful processing of \"notif\" event with ID %" PRIu32 " (remaining %" PRIu32 " subscribers).",
+                ev->request_id, slot->subscriber_count);
     }
 
-cleanup_wrunlock:
     /* SUB WRITE UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
-    goto cleanup;
+    sr_rwunlock(&notif_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
+
+    return NULL;
+}
+
+/**
+ * @brief Deliver all the notifications collected for batched subscriptions and finish the processed events.
+ *
+ * @param[in] notif_subs Module notification subscriptions.
+ * @param[in,out] batch Notification batch to flush.
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_notif_listen_batch_flush(struct modsub_notif_s *notif_subs, struct sr_shmsub_notif_batch_s *batch,
+        sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    struct modsub_notifsub_s *sub;
+    uint32_t i;
+
+    for (i = 0; i < notif_subs->sub_count; ++i) {
+        sub = &notif_subs->subs[i];
+        if (!batch->subs[i].count) {
+            continue;
+        }
+
+        /* call callback */
+        sub->batch_cb(batch->ev_sess, sub->sub_id, batch->subs[i].items, batch->subs[i].count, sub->private_data);
+        batch->subs[i].count = 0;
+    }
+
+    /* the notifications are no longer needed */
+    for (i = 0; i < batch->tree_count; ++i) {
+        lyd_free_all(batch->trees[i]);
+    }
+    batch->tree_count = 0;
+
+    /* finish the events */
+    for (i = 0; i < batch->event_count; ++i) {
+        if ((tmp_err = sr_shmsub_notif_listen_finish_event(notif_subs, &batch->events[i], conn))) {
+            sr_errinfo_merge(&err_info, tmp_err);
+        }
+    }
+    batch->event_count = 0;
+
+    return err_info;
+}
+
+/**
+ * @brief Check whether processing of new notifications can be deferred for their batch to fill. Possible only if
+ * all the subscriptions are batched with a timeout.
+ *
+ * @param[in] notif_subs Module notification subscriptions, the time to process the notifications is set.
+ * @param[in] last_request_id Request ID of the last new notification.
+ * @param[in] conn Connection to use.
+ * @return Whether to defer processing of the notifications.
+ */
+static int
+sr_shmsub_notif_listen_batch_defer(struct modsub_notif_s *notif_subs, uint32_t last_request_id, sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_notif_sub_shm_t *notif_shm;
+    struct sr_notif_sub_slot_s *slot;
+    struct modsub_notifsub_s *sub;
+    struct timespec publish_ts;
+    uint32_t i, batch_size = SR_NOTIF_SUB_SLOT_COUNT, timeout_us = 0;
+    int valid;
+
+    if (last_request_id == notif_subs->request_id) {
+        /* no new notifications */
+        return 0;
+    }
+
+    for (i = 0; i < notif_subs->sub_count; ++i) {
+        sub = &notif_subs->subs[i];
+        if (!sub->batch_cb || !sub->batch_timeout_us) {
+            /* the notifications must be delivered right away */
+            return 0;
+        }
+
+        if (sub->batch_size && (sub->batch_size < batch_size)) {
+            batch_size = sub->batch_size;
+        }
+        if (!timeout_us || (sub->batch_timeout_us < timeout_us)) {
+            timeout_us = sub->batch_timeout_us;
+        }
+    }
+
+    if (last_request_id - notif_subs->request_id >= batch_size) {
+        /* a batch is full (or all the slots are used) */
+        return 0;
+    }
+
+    /* get the publish timestamp of the oldest new notification */
+    notif_shm = (sr_notif_sub_shm_t *)notif_subs->sub_shm.addr;
+    slot = &notif_shm->slots[(notif_subs->request_id + 1) % SR_NOTIF_SUB_SLOT_COUNT];
+
+    /* SUB READ LOCK */
+    if ((err_info = sr_rwlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
+            NULL, NULL))) {
+        sr_errinfo_free(&err_info);
+        return 0;
+    }
+
+    valid = (slot->request_id == notif_subs->request_id + 1);
+    publish_ts = slot->publish_ts;
 
-cleanup_rdunlock:
     /* SUB READ UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+    sr_rwunlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
 
-cleanup:
-    ly_in_free(in, 0);
-    sr_session_stop(ev_sess);
-    lyd_free_all(orig_notif);
-    lyd_free_all(notif_dup);
-    sr_shm_clear(&shm_data_sub);
+    if (!valid || (sr_time_since_us(&publish_ts) >= timeout_us)) {
+        /* overwritten or waited long enough */
+        return 0;
+    }
+
+    /* defer until the oldest notification times out */
+    notif_subs->batch_flush = publish_ts;
+    notif_subs->batch_flush.tv_sec += timeout_us / 1000000;
+    notif_subs->batch_flush.tv_nsec += (timeout_us % 1000000) * 1000;
+    if (notif_subs->batch_flush.tv_nsec >= 1000000000) {
+        ++notif_subs->batch_flush.tv_sec;
+        notif_subs->batch_flush.tv_nsec -= 1000000000;
+    }
+    return 1;
+}
+
+sr_error_info_t *
+sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs, int batch_defer, sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    uint32_t i, last_request_id, missed;
+    sr_notif_sub_shm_t *notif_shm;
+    struct sr_shmsub_notif_batch_s batch;
+    int flush;
+
+    memset(&batch, 0, sizeof batch);
+    notif_shm = (sr_notif_sub_shm_t *)notif_subs->sub_shm.addr;
+
+    /* SUB READ LOCK */
+    if ((err_info = sr_rwlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
+            NULL, NULL))) {
+        return err_info;
+    }
+
+    last_request_id = notif_shm->request_id;
+
+    /* SUB READ UNLOCK */
+    sr_rwunlock(&notif_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+    if (last_request_id - notif_subs->request_id > SR_NOTIF_SUB_SLOT_COUNT) {
+        /* the oldest notifications were already overwritten */
+        missed = last_request_id - notif_subs->request_id - SR_NOTIF_SUB_SLOT_COUNT;
+        for (i = 0; i < notif_subs->sub_count; ++i) {
+            ATOMIC_ADD_RELAXED(notif_subs->subs[i].dropped, missed);
+        }
+        SR_LOG_WRN("%" PRIu32 " \"%s\" notifications were dropped because the subscriber is lagging.", missed,
+                notif_subs->module_name);
+        notif_subs->request_id = last_request_id - SR_NOTIF_SUB_SLOT_COUNT;
+    }
+
+    /* wait for more notifications to deliver them in a batch, if possible */
+    memset(&notif_subs->batch_flush, 0, sizeof notif_subs->batch_flush);
+    if ((notif_subs->request_id == last_request_id) ||
+            (batch_defer && sr_shmsub_notif_listen_batch_defer(notif_subs, last_request_id, conn))) {
+        return NULL;
+    }
+
+    batch.subs = calloc(notif_subs->sub_count, sizeof *batch.subs);
+    SR_CHECK_MEM_RET(!batch.subs, err_info);
+
+    /* process all the new notifications in order */
+    while (notif_subs->request_id != last_request_id) {
+        err_info = sr_shmsub_notif_listen_process_event(notif_subs, notif_subs->request_id + 1, &batch, conn);
+
+        /* remember request ID so that we do not process it again */
+        ++notif_subs->request_id;
+        if (err_info) {
+            break;
+        }
+
+        /* deliver the collected notifications once a batch is full, finish right away if there are none */
+        flush = !batch.tree_count;
+        for (i = 0; i < notif_subs->sub_count; ++i) {
+            if (batch.subs[i].count && (batch.subs[i].count == notif_subs->subs[i].batch_size)) {
+                flush = 1;
+            }
+        }
+        if (flush && (err_info = sr_shmsub_notif_listen_batch_flush(notif_subs, &batch, conn))) {
+            break;
+        }
+    }
+
+    /* deliver the rest */
+    if ((tmp_err = sr_shmsub_notif_listen_batch_flush(notif_subs, &batch, conn))) {
+        sr_errinfo_merge(&err_info, tmp_err);
+    }
+
+    /* publish the progress for monitoring */
+    if ((tmp_err = sr_shmext_notif_sub_progress(conn, notif_subs))) {
+        sr_errinfo_merge(&err_info, tmp_err);
+    }
+
+    ly_in_free(batch.in, 0);
+    sr_session_stop(batch.ev_sess);
+    free(batch.trees);
+    free(batch.subs);
     return err_info;
 }
 
@@ -4362,6 +6116,12 @@ sr_shmsub_notif_listen_module_get_stop_time_in(struct modsub_notif_s *notif_subs
             }
         }
     }
+    if (!SR_TS_IS_ZERO(notif_subs->batch_flush)) {
+        /* deferred batched notifications must be delivered on time, too */
+        if (SR_TS_IS_ZERO(next_stop_time) || (sr_time_cmp(&notif_subs->batch_flush, &next_stop_time) < 0)) {
+            next_stop_time = notif_subs->batch_flush;
+        }
+    }
 
     if (SR_TS_IS_ZERO(next_stop_time)) {
         return;
@@ -4477,7 +6237,7 @@ sr_shmsub_notif_listen_module_replay(struct modsub_notif_s *notif_subs, sr_subsc
             /* we need to perform the requested replay */
             if ((err_info = sr_replay_notify(subscr->conn, notif_subs->module_name, notif_sub->sub_id, notif_sub->xpath,
                     &notif_sub->start_time, &notif_sub->stop_time, &notif_sub->listen_since, notif_sub->cb,
-                    notif_sub->tree_cb, notif_sub->private_data))) {
+                    notif_sub->tree_cb, notif_sub->batch_cb, notif_sub->private_data))) {
                 return err_info;
             }
 
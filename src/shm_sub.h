@@ -62,6 +62,21 @@ sr_error_info_t *sr_shmsub_open_map(const char *name, const char *suffix1, int64
  */
 sr_error_info_t *sr_shmsub_unlink(const char *name, const char *suffix1, int64_t suffix2);
 
+/**
+ * @brief Release a sub or sub data SHM opened using the sub SHM cache of a connection. If not cached, it is cleared.
+ *
+ * @param[in] conn Connection with the cache.
+ * @param[in,out] shm SHM to release, is cleared.
+ */
+void sr_shmsub_cache_release(sr_conn_ctx_t *conn, sr_shm_t *shm);
+
+/**
+ * @brief Unmap and free all the SHMs in the sub SHM cache of a connection.
+ *
+ * @param[in] conn Connection with the cache.
+ */
+void sr_shmsub_cache_flush(sr_conn_ctx_t *conn);
+
 /**
  * @brief Create a subscription data SHM.
  *
@@ -90,6 +105,33 @@ sr_error_info_t *sr_shmsub_data_unlink(const char *name, const char *suffix1, in
  */
 sr_error_info_t *sr_shmsub_notify_evpipe(uint32_t evpipe_num);
 
+/**
+ * @brief Claim all the subscription groups marked in the event pipe ready bitmap of a subscription structure.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[out] claimed Claimed bitmap words, ::SR_EVPIPE_READY_WORD_COUNT of them.
+ * @return Whether any subscription group was claimed.
+ */
+int sr_shmsub_listen_ready_claim(sr_subscription_ctx_t *subscr, uint32_t *claimed);
+
+/**
+ * @brief Return claimed subscription groups back into the event pipe ready bitmap to be processed again.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[in] claimed Claimed bitmap words.
+ */
+void sr_shmsub_listen_ready_unclaim(sr_subscription_ctx_t *subscr, const uint32_t *claimed);
+
+/**
+ * @brief Learn whether a subscription group was claimed and should have its events processed.
+ *
+ * @param[in] claimed Claimed bitmap words, NULL if all the groups should be processed.
+ * @param[in] name Module name or RPC/action path of the subscriptions.
+ * @param[in] type Type of the subscriptions, their sub SHM suffix.
+ * @return Whether the group is claimed.
+ */
+int sr_shmsub_listen_ready_is_set(const uint32_t *claimed, const char *name, const char *type);
+
 /**
  * @brief Notify about (generate) a change "update" event.
  *
@@ -133,10 +175,12 @@ sr_error_info_t *sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info,
  * @param[in] orig_name Event originator name.
  * @param[in] orig_data Event originator data.
  * @param[in] timeout_ms Change callback timeout in milliseconds. Set to 0 if the event should not be waited for.
+ * @param[in] unlock_mods Whether to unlock all the modules in @p mod_info once all the subscriptions are locked for
+ * the event, so that any following events of these modules are generated only after this one.
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *orig_name,
-        const void *orig_data, uint32_t timeout_ms);
+        const void *orig_data, uint32_t timeout_ms, int unlock_mods);
 
 /**
  * @brief Notify about (generate) a change "abort" event.
@@ -269,25 +313,43 @@ sr_error_info_t *sr_shmsub_oper_poll_listen_process_module_events(struct modsub_
         sr_conn_ctx_t *conn, struct timespec *wake_up_in);
 
 /**
- * @brief Process all RPC/action events for one RPC/action, if any.
+ * @brief Pass change, operational get, or notification subscriptions of a module to the subscription worker threads
+ * to process their events. If a worker is already processing them, it only checks for new events once finished.
+ *
+ * @param[in] subscr Subscription structure with the workers.
+ * @param[in] busy Worker thread processing state of the subscriptions.
+ * @param[in] type Type of the subscriptions.
+ * @param[in] name Module name of the subscriptions.
+ * @param[in] ds Datastore of change subscriptions.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_workers_add_group_job(sr_subscription_ctx_t *subscr, ATOMIC_T *busy,
+        sr_subscr_job_type_t type, const char *name, sr_datastore_t ds);
+
+/**
+ * @brief Process all RPC/action events for one RPC/action, if any. If the subscription structure has
+ * worker threads, the events are only passed to them.
  *
  * @param[in] rpc_sub RPC/action subscriptions.
- * @param[in] conn Connection to use.
+ * @param[in] subscr Subscription structure of @p rpc_subs.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ctx_t *conn);
+sr_error_info_t *sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_subscription_ctx_t *subscr);
 
 /**
  * @brief Process all module notification events, if any.
  *
  * @param[in] notif_subs Module notification subscriptions.
+ * @param[in] batch_defer Whether the events of batched subscriptions may be deferred for their batch to fill.
+ * The caller must then wake up in time learned from ::sr_shmsub_notif_listen_module_get_stop_time_in().
  * @param[in] conn Connection to use.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs, sr_conn_ctx_t *conn);
+sr_error_info_t *sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs, int batch_defer,
+        sr_conn_ctx_t *conn);
 
 /**
- * @brief Get nearest stop time of a subscription, if any.
+ * @brief Get nearest stop time of a subscription or deferred batch delivery time, if any.
  *
  * @param[in] notif_subs Module notification subscriptions.
  * @param[in,out] wake_up_in Nearest stop time of a subscription. If none, left unmodified.
@@ -326,4 +388,12 @@ sr_error_info_t *sr_shmsub_notif_listen_module_replay(struct modsub_notif_s *not
  */
 void *sr_shmsub_listen_thread(void *arg);
 
+/**
+ * @brief Worker thread of a subscription structure processing the events passed by the listener.
+ *
+ * @param[in] arg Pointer to the subscription structure.
+ * @return Always NULL.
+ */
+void *sr_shmsub_worker_thread(void *arg);
+
 #endif /* _SHM_SUB_H */
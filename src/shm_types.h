@@ -23,7 +23,7 @@
 #include "common_types.h"
 #include "sysrepo_types.h"
 
-#define SR_SHM_VER 13   /**< Main, mod, and ext SHM version of their expected content structures. */
+#define SR_SHM_VER 26   /**< Main, mod, and ext SHM version of their expected content structures. */
 #define SR_MAIN_SHM_LOCK "sr_main_lock"     /**< Main SHM file lock name. */
 
 /**
@@ -100,19 +100,25 @@ typedef struct {
     uint16_t dep_count;         /**< Number of dependencies. */
 } sr_notif_t;
 
+#define SR_MOD_ENTRY_LOCK_COUNT 16     /**< Number of lock stripes of module top-level list instances. */
+
 /**
  * @brief Mod SHM module.
  */
 typedef struct {
     struct sr_mod_lock_s {
         sr_rwlock_t data_lock;  /**< Process-shared lock for accessing module instance data. */
+        pthread_mutex_t entry_locks[SR_MOD_ENTRY_LOCK_COUNT];   /**< Process-shared locks of top-level list instance
+                                     stripes (by their hash), held while changing the instances. */
 
         pthread_mutex_t ds_lock;    /**< Process-shared lock for accessing DS lock information. */
+        sr_cond_t ds_lock_cond;     /**< Process-shared condition variable signalled when the DS lock is released. */
         uint32_t ds_lock_sid;   /**< SID of the module data datastore lock (NETCONF lock), the data can be modified only
                                      by this session. If 0, the DS lock is not held. */
         struct timespec ds_lock_ts; /**< Timestamp of the datastore lock. */
     } data_lock_info[SR_DS_COUNT];  /**< Module data lock information for each datastore. */
     sr_rwlock_t replay_lock;    /**< Process-shared lock for accessing stored notifications for replay. */
+    ATOMIC_T oper_edit_gen;     /**< Generation of the stored operational edit, increased with every its change. */
 
     off_t name;                 /**< Module name (offset in mod SHM). */
     char rev[11];               /**< Module revision. */
@@ -183,8 +189,28 @@ typedef struct {
     ATOMIC_T new_sr_sid;        /**< SID for a new session. */
     ATOMIC_T new_sub_id;        /**< Subscription ID of a new subscription. */
     ATOMIC_T new_evpipe_num;    /**< Event pipe number for a new subscription. */
+    ATOMIC_T sub_shm_gen;       /**< Generation of sub SHMs, increased whenever any is unlinked. */
+    ATOMIC_T entry_lock_conn_count; /**< Number of connections created with ::SR_CONN_ENTRY_LOCK, top-level list
+                                     instance stripes are locked only if there are any. Counted again on every
+                                     connect and disconnect so that crashed connections are not counted. */
 } sr_main_shm_t;
 
+/**
+ * @brief Ext SHM change subscription event processing latency statistics, updated by the subscriber.
+ */
+typedef struct {
+    ATOMIC64_T event_count;     /**< Number of processed events. */
+    ATOMIC64_T queue_time;      /**< Cumulative time the originators waited for the sub SHM lock to publish the events
+                                     (in us). */
+    ATOMIC64_T wakeup_time;     /**< Cumulative time between publishing the events and the subscriber starting to process
+                                     them (in us). */
+    ATOMIC64_T cb_count;        /**< Number of callback calls. */
+    ATOMIC64_T cb_time;         /**< Cumulative callback run time (in us). */
+    ATOMIC64_T cb_time_max;     /**< Longest callback run time (in us). */
+    ATOMIC64_T result_time;     /**< Cumulative time between the callbacks finishing and the event results being written
+                                     (in us). */
+} sr_sub_latency_t;
+
 /**
  * @brief Ext SHM module change subscriptions.
  */
@@ -196,6 +222,7 @@ typedef struct {
     uint32_t evpipe_num;        /**< Event pipe number. */
     ATOMIC_T suspended;         /**< Whether the subscription is suspended. */
     sr_cid_t cid;               /**< Connection ID. */
+    sr_sub_latency_t latency;   /**< Event processing latency statistics. */
 } sr_mod_change_sub_t;
 
 /**
@@ -251,7 +278,13 @@ typedef struct {
     uint32_t sub_id;            /**< Unique subscription ID. */
     uint32_t evpipe_num;        /**< Event pipe number. */
     ATOMIC_T suspended;         /**< Whether the subscription is suspended. */
+    int drop;                   /**< Whether the subscription never blocks senders and may miss notifications instead. */
     sr_cid_t cid;               /**< Connection ID. */
+
+    struct timespec listen_since;   /**< Timestamp of the subscription starting to listen for notifications. */
+    ATOMIC_T request_id;        /**< Request ID of the last notification processed by the subscriber, updated by it. */
+    ATOMIC_T dropped;           /**< Number of notifications missed by the subscriber because it was lagging, updated
+                                     by it. */
 } sr_mod_notif_sub_t;
 
 /**
@@ -296,9 +329,9 @@ typedef struct {
  */
 
 /*
- * notification subscription SHM (multi)
+ * notification subscription SHM (notif)
  *
- * data SHM contents
+ * data SHM contents, one data SHM for every slot
  *
  * FOR SUBSCRIBERS
  * followed by:
@@ -323,6 +356,9 @@ typedef struct {
 /*
  * RPC subscription SHM (generic)
  *
+ * there are SR_RPC_SUB_SLOT_COUNT sub SHMs with their data SHMs for every RPC/action path, each holding one request,
+ * request IDs of a slot are always congruent with the slot index modulo SR_RPC_SUB_SLOT_COUNT
+ *
  * data SHM contents
  *
  * FOR SUBSCRIBER
@@ -344,6 +380,11 @@ typedef struct {
     sr_cid_t orig_cid;          /**< Event originator CID. */
     uint32_t request_id;        /**< Request ID. */
     sr_sub_event_t event;       /**< Event. */
+
+    struct timespec lock_ts;    /**< Timestamp of the originator starting to wait for the lock to publish a new event,
+                                     zeroed once it is published. */
+    struct timespec publish_ts; /**< Timestamp of publishing the event. */
+    uint32_t queue_time;        /**< Time the originator waited for the lock before publishing the event (in us). */
 } sr_sub_shm_t;
 
 /**
@@ -356,9 +397,60 @@ typedef struct {
     uint32_t request_id;        /**< Request ID. */
     sr_sub_event_t event;       /**< Event. */
 
+    struct timespec lock_ts;    /**< Timestamp of the originator starting to wait for the lock to publish a new event,
+                                     zeroed once it is published. */
+    struct timespec publish_ts; /**< Timestamp of publishing the event. */
+    uint32_t queue_time;        /**< Time the originator waited for the lock before publishing the event (in us). */
+
     /* specific fields */
     uint32_t priority;          /**< Priority of the subscriber. */
     uint32_t subscriber_count;  /**< Number of subscribers to process this event. */
 } sr_multi_sub_shm_t;
 
+/**
+ * @brief Indexed diff written into sub data SHM of change events. It is followed by @p count entries, then by
+ * the names of all the top-level diff nodes and then by the LYB data of each of their subtrees, so that
+ * the subscribers can parse only the subtrees they are interested in.
+ */
+typedef struct {
+    uint32_t size;              /**< Size of the whole indexed diff. */
+    uint32_t count;             /**< Number of the top-level diff subtrees. */
+
+    struct sr_diff_idx_entry_s {
+        uint32_t name;          /**< Offset of the "module:name" string of the top-level node. */
+        uint32_t lyb;           /**< Offset of the LYB data of the subtree. */
+    } entries[];                /**< Entries of the top-level diff subtrees, offsets are from the structure start. */
+} sr_diff_idx_t;
+
+#define SR_NOTIF_SUB_SLOT_COUNT 16  /**< Number of notification slots in notification subscription SHM. */
+
+/**
+ * @brief Notification subscription SHM structure, a ring of notification slots.
+ */
+typedef struct {
+    sr_rwlock_t lock;           /**< Process-shared lock for accessing the SHM structure. */
+    uint32_t request_id;        /**< Request ID of the last written notification, it is in slot
+                                     (request_id % ::SR_NOTIF_SUB_SLOT_COUNT). */
+
+    struct sr_notif_sub_slot_s {
+        uint32_t request_id;        /**< Request ID of the notification in the slot, 0 if empty. */
+        sr_cid_t orig_cid;          /**< Notification originator CID. */
+        struct timespec publish_ts; /**< Timestamp of publishing the notification. */
+        uint32_t subscriber_count;  /**< Number of subscribers yet to process the notification. */
+        uint32_t block_count;       /**< Number of blocking subscribers yet to process the notification, the slot
+                                         cannot be overwritten until it is 0. */
+    } slots[SR_NOTIF_SUB_SLOT_COUNT];   /**< Notification slots. */
+} sr_notif_sub_shm_t;
+
+#define SR_EVPIPE_READY_WORD_COUNT 128  /**< Number of 32-bit words in an event pipe ready bitmap. */
+
+/**
+ * @brief Event pipe ready bitmap SHM structure. Every subscription group (module and type of the subscriptions or
+ * RPC/action path) of a subscription structure is hashed into a bit that is set by the event originator and cleared
+ * by the listener when it processes the events. Only 32 bits of every word are used.
+ */
+typedef struct {
+    ATOMIC_T words[SR_EVPIPE_READY_WORD_COUNT]; /**< Bitmap words. */
+} sr_evpipe_ready_t;
+
 #endif /* _SHM_TYPES_H */
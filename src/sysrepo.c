@@ -55,8 +55,9 @@
 static sr_error_info_t *sr_session_notif_buf_stop(sr_session_ctx_t *session);
 static sr_error_info_t *_sr_session_stop(sr_session_ctx_t *session);
 static sr_error_info_t *sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *session,
-        uint32_t timeout_ms, sr_error_info_t **cb_err_info);
+        uint32_t timeout_ms, sr_error_info_t **cb_err_info, int *notified);
 static sr_error_info_t *_sr_unsubscribe(sr_subscription_ctx_t *subscription);
+static sr_error_info_t *sr_subscr_new(sr_conn_ctx_t *conn, sr_subscr_options_t opts, sr_subscription_ctx_t **subs_p);
 
 /**
  * @brief Allocate a new connection structure.
@@ -111,10 +112,30 @@ sr_conn_new(const sr_conn_options_t opts, sr_conn_ctx_t **conn_p)
     if ((err_info = sr_rwlock_init(&conn->oper_cache_lock, 0))) {
         goto error9;
     }
+    if ((err_info = sr_rwlock_init(&conn->oper_edit_cache_lock, 0))) {
+        goto error10;
+    }
+    if ((err_info = sr_mutex_init(&conn->commit_lock, 0))) {
+        goto error11;
+    }
+    if ((err_info = sr_cond_init(&conn->commit_cond, 0, 0))) {
+        goto error12;
+    }
+    if ((err_info = sr_mutex_init(&conn->sub_shm_cache_lock, 0))) {
+        goto error13;
+    }
 
     *conn_p = conn;
     return NULL;
 
+error13:
+    sr_cond_destroy(&conn->commit_cond);
+error12:
+    pthread_mutex_destroy(&conn->commit_lock);
+error11:
+    sr_rwlock_destroy(&conn->oper_edit_cache_lock);
+error10:
+    sr_rwlock_destroy(&conn->oper_cache_lock);
 error9:
     sr_ntf_handle_free(conn->ntf_handles, conn->ntf_handle_count);
 error8:
@@ -130,7 +151,7 @@ error4:
 error3:
     pthread_mutex_destroy(&conn->ptr_lock);
 error2:
-    ly_ctx_destroy(conn->ly_ctx);
+    sr_ly_ctx_release(conn->ly_ctx);
 error1:
     free(conn);
     return err_info;
@@ -150,15 +171,18 @@ sr_conn_free(sr_conn_ctx_t *conn)
 
     assert(!conn->oper_caches);
 
-    /* flush running cache before context destroy */
+    /* flush caches before context destroy */
     sr_conn_running_cache_flush(conn);
+    sr_conn_oper_cache_flush(conn);
 
-    ly_ctx_destroy(conn->ly_ctx);
+    sr_ly_ctx_release(conn->ly_ctx);
     free(conn->ext_searchdir);
     pthread_mutex_destroy(&conn->ptr_lock);
     if (conn->create_lock > -1) {
         close(conn->create_lock);
     }
+    sr_shmsub_cache_flush(conn);
+    pthread_mutex_destroy(&conn->sub_shm_cache_lock);
     sr_shm_clear(&conn->main_shm);
     sr_rwlock_destroy(&conn->mod_remap_lock);
     sr_shm_clear(&conn->mod_shm);
@@ -168,6 +192,9 @@ sr_conn_free(sr_conn_ctx_t *conn)
     sr_rwlock_destroy(&conn->running_cache_lock);
     sr_ntf_handle_free(conn->ntf_handles, conn->ntf_handle_count);
     sr_rwlock_destroy(&conn->oper_cache_lock);
+    sr_rwlock_destroy(&conn->oper_edit_cache_lock);
+    pthread_mutex_destroy(&conn->commit_lock);
+    sr_cond_destroy(&conn->commit_cond);
 
     free(conn);
 }
@@ -277,10 +304,19 @@ sr_connect(const sr_conn_options_t opts, sr_conn_ctx_t **conn_p)
     }
 
     /* track our connections */
-    if ((err_info = sr_shmmain_conn_list_add(conn->cid))) {
+    if ((err_info = sr_shmmain_conn_list_add(conn->cid, opts & SR_CONN_ENTRY_LOCK ? 1 : 0))) {
         goto cleanup_unlock;
     }
 
+    if ((opts & SR_CONN_ENTRY_LOCK) || ATOMIC_LOAD_RELAXED(main_shm->entry_lock_conn_count)) {
+        /* all the writers must lock the top-level list instance stripes while there are any such connections,
+         * count them again to also forget the connections that crashed */
+        if ((err_info = sr_shmmain_entry_lock_conn_recount(main_shm))) {
+            sr_errinfo_merge(&err_info, sr_shmmain_conn_list_del(conn->cid));
+            goto cleanup_unlock;
+        }
+    }
+
     SR_LOG_INF("Connection %" PRIu32 " created.", conn->cid);
 
 cleanup_unlock:
@@ -355,9 +391,28 @@ sr_disconnect(sr_conn_ctx_t *conn)
         return rc;
     }
 
-    /* stop tracking this connection */
-    if ((err_info = sr_shmmain_conn_list_del(conn->cid))) {
-        return sr_api_ret(NULL, err_info);
+    if ((conn->opts & SR_CONN_ENTRY_LOCK) || ATOMIC_LOAD_RELAXED(SR_CONN_MAIN_SHM(conn)->entry_lock_conn_count)) {
+        /* CREATE LOCK */
+        if ((err_info = sr_shmmain_createlock(conn->create_lock))) {
+            return sr_api_ret(NULL, err_info);
+        }
+
+        /* stop tracking this connection and count the remaining entry-lock connections */
+        if (!(err_info = sr_shmmain_conn_list_del(conn->cid))) {
+            err_info = sr_shmmain_entry_lock_conn_recount(SR_CONN_MAIN_SHM(conn));
+        }
+
+        /* CREATE UNLOCK */
+        sr_shmmain_createunlock(conn->create_lock);
+
+        if (err_info) {
+            return sr_api_ret(NULL, err_info);
+        }
+    } else {
+        /* stop tracking this connection */
+        if ((err_info = sr_shmmain_conn_list_del(conn->cid))) {
+            return sr_api_ret(NULL, err_info);
+        }
     }
 
     /* free attributes */
@@ -433,6 +488,11 @@ sr_set_ext_data_cb(sr_conn_ctx_t *conn, ly_ext_data_clb cb, void *user_data)
         return;
     }
 
+    if (conn->opts & SR_CONN_CTX_SHARED) {
+        SR_LOG_WRN("Setting ext data callback of a connection with a shared context is not supported.");
+        return;
+    }
+
     /* store */
     conn->ext_cb = cb;
     conn->ext_cb_data = user_data;
@@ -448,6 +508,12 @@ sr_set_ext_data_searchdir(sr_conn_ctx_t *conn, const char *searchdir)
 
     SR_CHECK_ARG_APIRET(!conn, NULL, err_info);
 
+    if (conn->opts & SR_CONN_CTX_SHARED) {
+        sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Setting ext data searchdir of a connection with a shared context"
+                " is not supported.");
+        goto cleanup;
+    }
+
     /* store */
     free(conn->ext_searchdir);
     conn->ext_searchdir = NULL;
@@ -579,7 +645,7 @@ sr_discard_oper_changes(sr_conn_ctx_t *conn, sr_session_ctx_t *session, const ch
     }
 
     /* notify all the subscribers and store the changes */
-    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, &cb_err_info);
+    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, &cb_err_info, NULL);
 
 cleanup:
     /* MODULES UNLOCK */
@@ -631,6 +697,87 @@ sr_session_set_orig(sr_session_ctx_t *sess, const char *orig_name, const void *o
     return NULL;
 }
 
+sr_error_info_t *
+sr_session_set_orig_shm(sr_session_ctx_t *sess, char **shm_data_ptr)
+{
+    sr_error_info_t *err_info = NULL;
+
+    /* free any previous originator */
+    free(sess->ev_data.orig_name);
+    sess->ev_data.orig_name = NULL;
+    free(sess->ev_data.orig_data);
+    sess->ev_data.orig_data = NULL;
+
+    if ((err_info = sr_session_set_orig(sess, *shm_data_ptr, (*shm_data_ptr) + sr_strshmlen(*shm_data_ptr)))) {
+        return err_info;
+    }
+    *shm_data_ptr += sr_strshmlen(*shm_data_ptr);
+    *shm_data_ptr += SR_SHM_SIZE(sr_ev_data_size(*shm_data_ptr));
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_session_set_ev_diff_shm(sr_session_ctx_t *sess, const char *shm_data_ptr)
+{
+    sr_error_info_t *err_info = NULL;
+    const sr_diff_idx_t *idx = (const sr_diff_idx_t *)shm_data_ptr;
+
+    /* free any previous diff */
+    lyd_free_all(sess->dt[sess->ds].diff);
+    sess->dt[sess->ds].diff = NULL;
+    free(sess->ev_diff.idx);
+    sess->ev_diff.idx = NULL;
+    free(sess->ev_diff.parsed);
+    sess->ev_diff.parsed = NULL;
+
+    sess->ev_diff.ds = sess->ds;
+    if (!idx->count) {
+        /* empty diff */
+        return NULL;
+    }
+
+    /* copy the indexed diff, the subtrees are parsed only when needed */
+    sess->ev_diff.idx = malloc(idx->size);
+    SR_CHECK_MEM_RET(!sess->ev_diff.idx, err_info);
+    memcpy(sess->ev_diff.idx, shm_data_ptr, idx->size);
+
+    sess->ev_diff.parsed = calloc(idx->count, sizeof *sess->ev_diff.parsed);
+    SR_CHECK_MEM_RET(!sess->ev_diff.parsed, err_info);
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_session_ev_diff_parse(sr_session_ctx_t *sess, const char *module_name, const char *xpath)
+{
+    sr_error_info_t *err_info = NULL;
+    const sr_diff_idx_t *idx;
+    uint32_t i;
+
+    if (!sess->ev_diff.idx) {
+        /* nothing (more) to parse */
+        return NULL;
+    }
+
+    if ((err_info = sr_lyd_parse_lyb_idx(sess->conn->ly_ctx, sess->ev_diff.idx, module_name, xpath,
+            sess->ev_diff.parsed, &sess->dt[sess->ev_diff.ds].diff))) {
+        return err_info;
+    }
+
+    /* free the indexed diff once it is all parsed */
+    idx = (const sr_diff_idx_t *)sess->ev_diff.idx;
+    for (i = 0; (i < idx->count) && sess->ev_diff.parsed[i]; ++i) {}
+    if (i == idx->count) {
+        free(sess->ev_diff.idx);
+        sess->ev_diff.idx = NULL;
+        free(sess->ev_diff.parsed);
+        sess->ev_diff.parsed = NULL;
+    }
+
+    return NULL;
+}
+
 sr_error_info_t *
 _sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_sub_event_t event, char **shm_data_ptr,
         sr_session_ctx_t **session)
@@ -664,12 +811,8 @@ _sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_sub_ev
     (*session)->conn = conn;
     (*session)->ds = datastore;
     (*session)->ev = event;
-    if (shm_data_ptr) {
-        if ((err_info = sr_session_set_orig(*session, *shm_data_ptr, (*shm_data_ptr) + sr_strshmlen(*shm_data_ptr)))) {
-            goto error;
-        }
-        *shm_data_ptr += sr_strshmlen(*shm_data_ptr);
-        *shm_data_ptr += SR_SHM_SIZE(sr_ev_data_size(*shm_data_ptr));
+    if (shm_data_ptr && (err_info = sr_session_set_orig_shm(*session, shm_data_ptr))) {
+        goto error;
     }
     if ((err_info = sr_mutex_init(&(*session)->ptr_lock, 0))) {
         goto error;
@@ -799,6 +942,8 @@ _sr_session_stop(sr_session_ctx_t *session)
     free(session->ev_error.message);
     free(session->ev_error.format);
     free(session->ev_error.data);
+    free(session->ev_diff.idx);
+    free(session->ev_diff.parsed);
     pthread_mutex_destroy(&session->ptr_lock);
     for (ds = 0; ds < SR_DS_COUNT; ++ds) {
         sr_release_data(session->dt[ds].edit);
@@ -1371,6 +1516,11 @@ _sr_install_modules(sr_conn_ctx_t *conn, const char *search_dirs, const char *da
     /* increase content ID */
     conn->content_id = ++SR_CONN_MAIN_SHM(conn)->content_id;
 
+    if (conn->opts & SR_CONN_CTX_SHARED) {
+        /* share the new context with other connections in this process */
+        sr_ly_ctx_shared_add(conn->opts, conn->content_id, &new_ctx);
+    }
+
     /* safely update the context by switching it */
     old_ctx = conn->ly_ctx;
     conn->ly_ctx = new_ctx;
@@ -1380,7 +1530,7 @@ cleanup:
     lyd_free_siblings(old_s_data);
     lyd_free_siblings(old_r_data);
     lyd_free_siblings(old_o_data);
-    ly_ctx_destroy(old_ctx);
+    sr_ly_ctx_release(old_ctx);
 
     lyd_free_siblings(new_s_data);
     lyd_free_siblings(new_r_data);
@@ -1630,6 +1780,11 @@ sr_remove_modules(sr_conn_ctx_t *conn, const char **module_names, int force)
     /* increase content ID */
     conn->content_id = ++SR_CONN_MAIN_SHM(conn)->content_id;
 
+    if (conn->opts & SR_CONN_CTX_SHARED) {
+        /* share the new context with other connections in this process */
+        sr_ly_ctx_shared_add(conn->opts, conn->content_id, &new_ctx);
+    }
+
     /* safely update the context by switching it */
     old_ctx = conn->ly_ctx;
     conn->ly_ctx = new_ctx;
@@ -1641,7 +1796,7 @@ cleanup:
     lyd_free_siblings(old_o_data);
     lyd_free_siblings(sr_mods);
     lyd_free_siblings(sr_del_mods);
-    ly_ctx_destroy(old_ctx);
+    sr_ly_ctx_release(old_ctx);
 
     lyd_free_siblings(new_s_data);
     lyd_free_siblings(new_r_data);
@@ -1898,6 +2053,11 @@ sr_update_modules(sr_conn_ctx_t *conn, const char **schema_paths, const char *se
     /* increase content ID */
     conn->content_id = ++SR_CONN_MAIN_SHM(conn)->content_id;
 
+    if (conn->opts & SR_CONN_CTX_SHARED) {
+        /* share the new context with other connections in this process */
+        sr_ly_ctx_shared_add(conn->opts, conn->content_id, &new_ctx);
+    }
+
     /* safely update the context by switching it */
     old_ctx = conn->ly_ctx;
     conn->ly_ctx = new_ctx;
@@ -1908,7 +2068,7 @@ cleanup:
     lyd_free_siblings(old_r_data);
     lyd_free_siblings(old_o_data);
     lyd_free_siblings(sr_mods);
-    ly_ctx_destroy(old_ctx);
+    sr_ly_ctx_release(old_ctx);
 
     lyd_free_siblings(new_s_data);
     lyd_free_siblings(new_r_data);
@@ -2415,6 +2575,11 @@ sr_change_module_feature(sr_conn_ctx_t *conn, const char *module_name, const cha
     /* increase content ID */
     conn->content_id = ++SR_CONN_MAIN_SHM(conn)->content_id;
 
+    if (conn->opts & SR_CONN_CTX_SHARED) {
+        /* share the new context with other connections in this process */
+        sr_ly_ctx_shared_add(conn->opts, conn->content_id, &new_ctx);
+    }
+
     /* safely update the context by switching it */
     old_ctx = conn->ly_ctx;
     conn->ly_ctx = new_ctx;
@@ -2425,7 +2590,7 @@ cleanup:
     lyd_free_siblings(old_r_data);
     lyd_free_siblings(old_o_data);
     lyd_free_siblings(sr_mods);
-    ly_ctx_destroy(old_ctx);
+    sr_ly_ctx_release(old_ctx);
 
     lyd_free_siblings(new_s_data);
     lyd_free_siblings(new_r_data);
@@ -2818,13 +2983,63 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
+/**
+ * @brief Get a selected subtree with all its parents to be returned.
+ *
+ * @param[in] ly_ctx libyang context.
+ * @param[in] set Set with the selected subtrees.
+ * @param[in] idx Index of the subtree in @p set.
+ * @param[in] dup Whether the subtrees in @p set are duplicated and can be used directly.
+ * @param[in] max_depth Maximum depth of the subtree.
+ * @param[out] root Top-level node of the subtree.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_get_data_subtree(const struct ly_ctx *ly_ctx, struct ly_set *set, uint32_t idx, int dup, uint32_t max_depth,
+        struct lyd_node **root)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+    int dup_opts;
+
+    if (dup) {
+        /* use subtree */
+        node = set->dnodes[idx];
+        set->dnodes[idx] = NULL;
+
+        /* remove nodes exceeding the maximum depth */
+        sr_lyd_trim_depth(node, max_depth);
+    } else {
+        /* duplicate subtree */
+        dup_opts = (max_depth ? 0 : LYD_DUP_RECURSIVE) | LYD_DUP_WITH_PARENTS | LYD_DUP_WITH_FLAGS;
+        if (lyd_dup_single(set->dnodes[idx], NULL, dup_opts, &node)) {
+            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+            return err_info;
+        }
+
+        /* duplicate only to the specified depth */
+        if ((err_info = sr_lyd_dup(set->dnodes[idx], max_depth ? max_depth - 1 : 0, node))) {
+            lyd_free_all(node);
+            return err_info;
+        }
+    }
+
+    /* always find parent */
+    while (node->parent) {
+        node = lyd_parent(node);
+    }
+
+    *root = node;
+    return NULL;
+}
+
 API int
 sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
         const sr_get_options_t opts, sr_data_t **data)
 {
     sr_error_info_t *err_info = NULL;
     uint32_t i;
-    int dup_opts, dup = 0;
+    int dup = 0;
     struct sr_mod_info_s mod_info;
     struct ly_set *set = NULL;
     struct lyd_node *node;
@@ -2867,31 +3082,8 @@ sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, ui
 
     /* duplicate all returned subtrees with their parents and merge into one data tree */
     for (i = 0; i < set->count; ++i) {
-        if (dup) {
-            /* use subtree */
-            node = set->dnodes[i];
-            set->dnodes[i] = NULL;
-
-            /* remove nodes exceeding the maximum depth */
-            sr_lyd_trim_depth(node, max_depth);
-        } else {
-            /* duplicate subtree */
-            dup_opts = (max_depth ? 0 : LYD_DUP_RECURSIVE) | LYD_DUP_WITH_PARENTS | LYD_DUP_WITH_FLAGS;
-            if (lyd_dup_single(set->dnodes[i], NULL, dup_opts, &node)) {
-                sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
-                goto cleanup;
-            }
-
-            /* duplicate only to the specified depth */
-            if ((err_info = sr_lyd_dup(set->dnodes[i], max_depth ? max_depth - 1 : 0, node))) {
-                lyd_free_all(node);
-                goto cleanup;
-            }
-        }
-
-        /* always find parent */
-        while (node->parent) {
-            node = lyd_parent(node);
+        if ((err_info = sr_get_data_subtree(session->conn->ly_ctx, set, i, dup, max_depth, &node))) {
+            goto cleanup;
         }
 
         /* connect to the result */
@@ -2925,6 +3117,107 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
+API int
+sr_get_data_chunks(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t chunk_size,
+        uint32_t timeout_ms, const sr_get_options_t opts, sr_get_chunk_cb callback, void *private_data)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i, chunk_count = 0;
+    int dup = 0, ret;
+    struct sr_mod_info_s mod_info;
+    struct ly_set *set = NULL;
+    struct lyd_node *node, *chunk = NULL, *match;
+
+    SR_CHECK_ARG_APIRET(!session || !xpath || !callback ||
+            ((session->ds != SR_DS_OPERATIONAL) && (opts & SR_OPER_MASK)), session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
+    }
+    if (!chunk_size) {
+        chunk_size = 1;
+    }
+
+    /* for operational, use operational and running datastore */
+    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* collect all required modules */
+    if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, xpath, session->ds, 1, 0, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* add modules into mod_info with deps, locking, and their data */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_READ, session->sid,
+            session->orig_name, session->orig_data, timeout_ms, 0, opts))) {
+        goto cleanup;
+    }
+
+    /* filter the required data */
+    if ((err_info = sr_modinfo_get_filter(&mod_info, (opts & SR_GET_NO_FILTER) ? "/*" : xpath, session, &set, &dup))) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < set->count; ++i) {
+        if ((err_info = sr_get_data_subtree(session->conn->ly_ctx, set, i, dup, max_depth, &node))) {
+            goto cleanup;
+        }
+
+        /* the subtrees are in document order so a top-level tree not in the chunk cannot appear in it later */
+        if ((chunk_count >= chunk_size) && lyd_find_sibling_first(chunk, node, &match)) {
+            /* chunk is full, pass it to the callback */
+            ret = callback(session, chunk, private_data);
+            lyd_free_all(chunk);
+            chunk = NULL;
+            chunk_count = 0;
+            if (ret) {
+                lyd_free_all(node);
+                sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
+                goto cleanup;
+            }
+        }
+
+        /* connect to the chunk */
+        if (!chunk) {
+            chunk = node;
+        } else if (lyd_merge_tree(&chunk, node, LYD_MERGE_DESTRUCT)) {
+            sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
+            lyd_free_tree(node);
+            goto cleanup;
+        }
+        ++chunk_count;
+    }
+
+    if (chunk) {
+        /* last chunk */
+        ret = callback(session, chunk, private_data);
+        if (ret) {
+            sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
+        }
+    }
+
+cleanup:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info);
+
+    lyd_free_all(chunk);
+    if (dup && set) {
+        for (i = 0; i < set->count; ++i) {
+            lyd_free_tree(set->dnodes[i]);
+        }
+    }
+    ly_set_free(set, NULL);
+    sr_modinfo_erase(&mod_info);
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(session->conn, SR_LOCK_READ, 0, __func__);
+    return sr_api_ret(session, err_info);
+}
+
 API int
 sr_get_node(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr_data_t **node)
 {
@@ -3485,11 +3778,13 @@ cleanup:
  * @param[in] session Optional originator session.
  * @param[in] timeout_ms Timeout in milliseconds.
  * @param[out] cb_err_info Callback error information generated by a subscriber, if any.
+ * @param[out] notified Optional, set if the subscribers could have been notified about the changes or the changes
+ * were stored.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *session, uint32_t timeout_ms,
-        sr_error_info_t **cb_err_info)
+        sr_error_info_t **cb_err_info, int *notified)
 {
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *denied_node;
@@ -3575,6 +3870,10 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
     }
     change_sub_lock = SR_LOCK_READ;
 
+    if (notified) {
+        *notified = 1;
+    }
+
     /* first publish "update" event for the diff to be updated */
     if ((err_info = sr_modinfo_change_notify_update(mod_info, session, timeout_ms, &change_sub_lock, cb_err_info)) ||
             *cb_err_info) {
@@ -3586,6 +3885,11 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
         goto store;
     }
 
+    /* the updated diff may change other instances, lock their stripes as well */
+    if (mod_info->entry_locked && (err_info = sr_shmmod_modinfo_entry_relock(mod_info, sid))) {
+        goto cleanup;
+    }
+
     /* publish final diff in a "change" event for any subscribers and wait for them */
     if ((err_info = sr_shmsub_change_notify_change(mod_info, orig_name, orig_data, timeout_ms, cb_err_info))) {
         goto cleanup;
@@ -3602,23 +3906,50 @@ store:
         goto cleanup;
     }
 
-    /* MODULES WRITE LOCK (upgrade) */
-    if ((err_info = sr_shmmod_modinfo_rdlock_upgrade(mod_info, sid, 0))) {
-        goto cleanup;
+    if (mod_info->entry_locked) {
+        /* MODULES WRITE LOCK (relock) */
+        if ((err_info = sr_shmmod_modinfo_entry_wrlock(mod_info, sid))) {
+            if (mod_info->diff) {
+                /* the subscribers were notified about the changes, for example a DS lock could have been acquired */
+                sr_errinfo_merge(&err_info, sr_shmsub_change_notify_change_abort(mod_info, orig_name, orig_data,
+                        timeout_ms));
+            }
+            goto cleanup;
+        }
+
+        /* other instances could have been changed meanwhile, apply the changes on the current data */
+        if ((err_info = sr_modinfo_data_reapply(mod_info))) {
+            if (mod_info->diff) {
+                /* the subscribers were notified about the changes */
+                sr_errinfo_merge(&err_info, sr_shmsub_change_notify_change_abort(mod_info, orig_name, orig_data,
+                        timeout_ms));
+            }
+            goto cleanup;
+        }
+    } else {
+        /* MODULES WRITE LOCK (upgrade) */
+        if ((err_info = sr_shmmod_modinfo_rdlock_upgrade(mod_info, sid, 0))) {
+            goto cleanup;
+        }
     }
 
     /* store updated datastore */
     if ((err_info = sr_modinfo_data_store(mod_info))) {
         goto cleanup;
     }
+    if (notified) {
+        *notified = 1;
+    }
 
     /* MODULES READ LOCK (downgrade) */
     if ((err_info = sr_shmmod_modinfo_wrlock_downgrade(mod_info, sid))) {
         goto cleanup;
     }
 
-    /* publish "done" event, all changes were applied */
-    if ((err_info = sr_shmsub_change_notify_change_done(mod_info, orig_name, orig_data, timeout_ms))) {
+    /* publish "done" event, all changes were applied, and with pipelined commit allow other writers to
+     * access the modules while it is being processed (MODULES UNLOCK) */
+    if ((err_info = sr_shmsub_change_notify_change_done(mod_info, orig_name, orig_data, timeout_ms,
+            mod_info->conn->opts & SR_CONN_PIPELINED_COMMIT))) {
         goto cleanup;
     }
 
@@ -3637,22 +3968,70 @@ cleanup:
     return err_info;
 }
 
-API int
-sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms)
+/**
+ * @brief Learn whether changes of a session can be applied with only the changed top-level list instances
+ * of a module locked exclusively.
+ *
+ * @param[in] session Session with the changes.
+ * @return Whether the instances can be locked instead of the whole module.
+ */
+static int
+sr_apply_changes_entry_lockable(sr_session_ctx_t *session)
 {
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    struct sr_mod_info_s mod_info;
-    int mod_deps;
+    const struct lys_module *ly_mod = NULL;
+    const struct lyd_node *root;
+    sr_mod_t *shm_mod;
 
-    SR_CHECK_ARG_APIRET(!session, session, err_info);
+    if (!(session->conn->opts & SR_CONN_ENTRY_LOCK) || (session->ds == SR_DS_OPERATIONAL)) {
+        return 0;
+    }
 
-    if (!session->dt[session->ds].edit) {
-        return sr_api_ret(session, NULL);
+    /* only top-level list instances of a single module, the position of user-ordered instances depends on others */
+    LY_LIST_FOR(session->dt[session->ds].edit->tree, root) {
+        if (!root->schema || (root->schema->nodetype != LYS_LIST) || lysc_is_userordered(root->schema)) {
+            return 0;
+        } else if (ly_mod && (root->schema->module != ly_mod)) {
+            return 0;
+        } else if (sr_edit_diff_find_oper(root, 1, NULL) == EDIT_PURGE) {
+            /* affects all the instances */
+            return 0;
+        }
+        ly_mod = root->schema->module;
+    }
+    if (!ly_mod) {
+        return 0;
     }
 
-    if (!timeout_ms) {
-        timeout_ms = SR_CHANGE_CB_TIMEOUT;
+    /* no other modules can be locked, which could cause a dead-lock */
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(session->conn), ly_mod->name);
+    if (!shm_mod || shm_mod->dep_count || shm_mod->inv_dep_count) {
+        return 0;
     }
+
+    return 1;
+}
+
+/**
+ * @brief Apply changes made in sessions as a single change.
+ *
+ * @param[in] sessions Sessions with changes of a single datastore, the first one is used as the originator.
+ * @param[in] session_count Count of @p sessions.
+ * @param[in] timeout_ms Change callback timeout in milliseconds.
+ * @param[out] notified Optional, set if the subscribers could have been notified about the changes or the changes
+ * were stored, even if an error occurred afterwards.
+ * @param[out] cb_failed Optional, set if a subscriber callback rejected the changes so they were not stored.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_apply_changes_edits(sr_session_ctx_t **sessions, uint32_t session_count, uint32_t timeout_ms, int *notified,
+        int *cb_failed)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    sr_session_ctx_t *session = sessions[0];
+    struct sr_mod_info_s mod_info;
+    uint32_t i;
+    int mod_deps;
+
     /* even for operational datastore, we do not need any running data */
     SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds);
 
@@ -3664,23 +4043,58 @@ sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms)
     }
 
     /* collect all required modules */
-    if ((err_info = sr_modinfo_collect_edit(session->dt[session->ds].edit->tree, &mod_info))) {
-        goto cleanup;
-    }
-
-    /* add modules into mod_info with deps, locking, and their data */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, mod_deps, SR_LOCK_READ, SR_MI_LOCK_UPGRADEABLE | SR_MI_PERM_NO,
-            session->sid, session->orig_name, session->orig_data, 0, 0, 0))) {
-        goto cleanup;
+    for (i = 0; i < session_count; ++i) {
+        if ((err_info = sr_modinfo_collect_edit(sessions[i]->dt[session->ds].edit->tree, &mod_info))) {
+            goto cleanup;
+        }
     }
 
-    /* create diff */
-    if ((err_info = sr_modinfo_edit_apply(&mod_info, session->dt[session->ds].edit->tree, 1))) {
-        goto cleanup;
-    }
+    if ((session_count == 1) && sr_apply_changes_entry_lockable(session)) {
+        /* add modules into mod_info with deps */
+        if ((err_info = sr_modinfo_consolidate(&mod_info, mod_deps, SR_LOCK_NONE, SR_MI_DATA_NO | SR_MI_PERM_NO,
+                session->sid, session->orig_name, session->orig_data, 0, 0, 0))) {
+            goto cleanup;
+        }
 
-    /* notify all the subscribers and store the changes */
-    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, &cb_err_info);
+        /* MODULES READ LOCK, only the changed instances are locked exclusively */
+        if ((err_info = sr_shmmod_modinfo_entry_rdlock(&mod_info, session->dt[session->ds].edit->tree, session->sid))) {
+            goto cleanup;
+        }
+
+        /* DS locks are not checked by READ lock, fail before any event is published */
+        if ((err_info = sr_shmmod_modinfo_ds_lock_check(&mod_info, session->sid))) {
+            goto cleanup;
+        }
+
+        /* load their data */
+        if ((err_info = sr_modinfo_data_load(&mod_info, 0, session->orig_name, session->orig_data, 0, 0))) {
+            goto cleanup;
+        }
+    } else {
+        /* add modules into mod_info with deps, locking, and their data */
+        if ((err_info = sr_modinfo_consolidate(&mod_info, mod_deps, SR_LOCK_READ, SR_MI_LOCK_UPGRADEABLE | SR_MI_PERM_NO,
+                session->sid, session->orig_name, session->orig_data, 0, 0, 0))) {
+            goto cleanup;
+        }
+
+        /* the DS locks were checked only for the originator, all the other sessions must be allowed as well */
+        for (i = 1; i < session_count; ++i) {
+            if ((sessions[i]->sid != session->sid) &&
+                    (err_info = sr_shmmod_modinfo_ds_lock_check(&mod_info, sessions[i]->sid))) {
+                goto cleanup;
+            }
+        }
+    }
+
+    /* create diff, the edits are applied in order */
+    for (i = 0; i < session_count; ++i) {
+        if ((err_info = sr_modinfo_edit_apply(&mod_info, sessions[i]->dt[session->ds].edit->tree, 1))) {
+            goto cleanup;
+        }
+    }
+
+    /* notify all the subscribers and store the changes */
+    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, &cb_err_info, notified);
 
 cleanup:
     /* MODULES UNLOCK */
@@ -3688,15 +4102,257 @@ cleanup:
     sr_modinfo_erase(&mod_info);
 
     if (!err_info && !cb_err_info) {
-        /* free applied edit */
-        sr_release_data(session->dt[session->ds].edit);
-        session->dt[session->ds].edit = NULL;
+        /* free applied edits */
+        for (i = 0; i < session_count; ++i) {
+            sr_release_data(sessions[i]->dt[session->ds].edit);
+            sessions[i]->dt[session->ds].edit = NULL;
+        }
     }
     if (cb_err_info) {
         /* return callback error if some was generated */
         sr_errinfo_merge(&err_info, cb_err_info);
         sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
+        if (cb_failed) {
+            *cb_failed = 1;
+        }
     }
+    return err_info;
+}
+
+/**
+ * @brief Apply changes made in a session together with the changes of other sessions of the connection
+ * that are waiting for an active commit of the same datastore to finish.
+ *
+ * If the changes cannot be applied together and are not stored, for example because a session is not allowed
+ * to modify a DS-locked module or a subscriber rejected them, they are applied separately.
+ *
+ * @param[in] session Session to use.
+ * @param[in] timeout_ms Change callback timeout in milliseconds.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_apply_changes_group(sr_session_ctx_t *session, uint32_t timeout_ms)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = session->conn;
+    struct sr_commit_group_s *group = &conn->commit_groups[session->ds];
+    struct sr_commit_req_s req = {0}, **batch = NULL, *next;
+    sr_session_ctx_t **sessions = NULL;
+    sr_error_info_err_t *e;
+    uint32_t i, batch_count = 0;
+    int notified, cb_failed;
+    void *mem;
+
+    req.session = session;
+    req.timeout_ms = timeout_ms;
+
+    /* COMMIT LOCK */
+    pthread_mutex_lock(&conn->commit_lock);
+
+    if (group->active) {
+        /* wait for the active commit to finish */
+        mem = realloc(group->reqs, (group->req_count + 1) * sizeof *group->reqs);
+        if (!mem) {
+            /* COMMIT UNLOCK */
+            pthread_mutex_unlock(&conn->commit_lock);
+            SR_ERRINFO_MEM(&err_info);
+            return err_info;
+        }
+        group->reqs = mem;
+        group->reqs[group->req_count] = &req;
+        ++group->req_count;
+
+        do {
+            sr_cond_wait(&conn->commit_cond, &conn->commit_lock);
+        } while (req.state == SR_COMMIT_REQ_WAIT);
+
+        if (req.state == SR_COMMIT_REQ_DONE) {
+            /* committed by another thread */
+
+            /* COMMIT UNLOCK */
+            pthread_mutex_unlock(&conn->commit_lock);
+            return req.err_info;
+        }
+
+        /* commit all the requests waiting with this one */
+        assert(req.state == SR_COMMIT_REQ_LEAD);
+        batch = req.batch;
+        batch_count = req.batch_count;
+    } else {
+        /* commit only this request */
+        group->active = 1;
+        batch = malloc(sizeof *batch);
+        if (batch) {
+            batch[0] = &req;
+            batch_count = 1;
+        }
+    }
+
+    /* COMMIT UNLOCK */
+    pthread_mutex_unlock(&conn->commit_lock);
+
+    sessions = malloc(batch_count * sizeof *sessions);
+    if (!batch || !sessions) {
+        SR_ERRINFO_MEM(&req.err_info);
+        for (i = 0; i < batch_count; ++i) {
+            if (batch[i] != &req) {
+                SR_ERRINFO_MEM(&batch[i]->err_info);
+            }
+        }
+        goto finish;
+    }
+    for (i = 0; i < batch_count; ++i) {
+        sessions[i] = batch[i]->session;
+        if (batch[i]->timeout_ms > timeout_ms) {
+            timeout_ms = batch[i]->timeout_ms;
+        }
+    }
+
+    if (batch_count > 1) {
+        /* apply all the changes at once */
+        notified = 0;
+        cb_failed = 0;
+        if (!(err_info = sr_apply_changes_edits(sessions, batch_count, timeout_ms, &notified, &cb_failed))) {
+            goto finish;
+        } else if (notified && !cb_failed) {
+            /* the changes could have been stored, the error is the same for all the requests */
+            for (i = 0; i < batch_count; ++i) {
+                for (e = err_info->err; e < err_info->err + err_info->err_count; ++e) {
+                    sr_errinfo_add(&batch[i]->err_info, e->err_code, e->error_format, e->error_data, e->message, NULL);
+                }
+                sr_errinfo_new(&batch[i]->err_info, err_info->err[0].err_code,
+                        "Changes of %" PRIu32 " sessions applied together failed.", batch_count);
+            }
+            sr_errinfo_free(&err_info);
+            goto finish;
+        }
+
+        /* the changes were not stored, apply them separately to learn the result of each, a subscriber rejecting
+         * the joint change is notified about each change again */
+        sr_errinfo_free(&err_info);
+    }
+    for (i = 0; i < batch_count; ++i) {
+        batch[i]->err_info = sr_apply_changes_edits(&sessions[i], 1, batch[i]->timeout_ms, NULL, NULL);
+    }
+
+finish:
+    /* COMMIT LOCK */
+    pthread_mutex_lock(&conn->commit_lock);
+
+    /* finish the requests of other threads */
+    for (i = 0; i < batch_count; ++i) {
+        if (batch[i] != &req) {
+            batch[i]->state = SR_COMMIT_REQ_DONE;
+        }
+    }
+
+    if (group->req_count) {
+        /* let the first waiting request commit all the waiting requests */
+        next = group->reqs[0];
+        next->batch = group->reqs;
+        next->batch_count = group->req_count;
+        next->state = SR_COMMIT_REQ_LEAD;
+        group->reqs = NULL;
+        group->req_count = 0;
+    } else {
+        group->active = 0;
+    }
+    sr_cond_broadcast(&conn->commit_cond);
+
+    /* COMMIT UNLOCK */
+    pthread_mutex_unlock(&conn->commit_lock);
+
+    free(batch);
+    free(sessions);
+    return req.err_info;
+}
+
+/**
+ * @brief Apply changes made in a session.
+ *
+ * @param[in] session Session to use.
+ * @param[in] timeout_ms Change callback timeout in milliseconds.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+_sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms)
+{
+    if (!session->dt[session->ds].edit) {
+        return NULL;
+    }
+
+    if (!timeout_ms) {
+        timeout_ms = SR_CHANGE_CB_TIMEOUT;
+    }
+
+    if ((session->conn->opts & SR_CONN_GROUP_COMMIT) && (session->ds != SR_DS_OPERATIONAL) &&
+            !SR_IS_EVENT_SESS(session) && !session->nacm_user && !session->orig_name) {
+        /* commit together with other sessions of the connection */
+        return sr_apply_changes_group(session, timeout_ms);
+    }
+
+    return sr_apply_changes_edits(&session, 1, timeout_ms, NULL, NULL);
+}
+
+API int
+sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session, session, err_info);
+
+    err_info = _sr_apply_changes(session, timeout_ms);
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_apply_changes_async(sr_session_ctx_t *session, uint32_t timeout_ms, sr_apply_changes_cb callback,
+        void *private_data, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_apply_req_s *req;
+    void *mem;
+
+    SR_CHECK_ARG_APIRET(!session || SR_IS_EVENT_SESS(session) || !callback || !subscription, session, err_info);
+
+    if (!*subscription) {
+        /* create a new subscription */
+        if ((err_info = sr_subscr_new(session->conn, opts, subscription))) {
+            return sr_api_ret(session, err_info);
+        }
+    }
+
+    /* add the subscription into session so that the request is failed if the session is stopped meanwhile */
+    if ((err_info = sr_ptr_add(&session->ptr_lock, (void ***)&session->subscriptions, &session->subscription_count,
+            *subscription))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* APPLY LOCK */
+    pthread_mutex_lock(&(*subscription)->apply_lock);
+
+    /* add the request */
+    mem = realloc((*subscription)->apply_reqs, ((*subscription)->apply_req_count + 1) * sizeof *req);
+    if (!mem) {
+        /* APPLY UNLOCK */
+        pthread_mutex_unlock(&(*subscription)->apply_lock);
+
+        SR_ERRINFO_MEM(&err_info);
+        return sr_api_ret(session, err_info);
+    }
+    (*subscription)->apply_reqs = mem;
+    req = &(*subscription)->apply_reqs[(*subscription)->apply_req_count];
+    req->sess = session;
+    req->timeout_ms = timeout_ms;
+    req->cb = callback;
+    req->private_data = private_data;
+    ++(*subscription)->apply_req_count;
+
+    /* APPLY UNLOCK */
+    pthread_mutex_unlock(&(*subscription)->apply_lock);
+
+    /* let the subscription process the request */
+    err_info = sr_shmsub_notify_evpipe((*subscription)->evpipe_num);
     return sr_api_ret(session, err_info);
 }
 
@@ -3776,7 +4432,7 @@ _sr_replace_config(sr_session_ctx_t *session, const struct lys_module *ly_mod, s
     }
 
     /* notify all the subscribers and store the changes */
-    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, &cb_err_info);
+    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, &cb_err_info, NULL);
 
 cleanup:
     /* MODULES UNLOCK */
@@ -3998,6 +4654,9 @@ sr_change_dslock(struct sr_mod_info_s *mod_info, uint32_t sid, int lock)
         } else {
             shm_lock->ds_lock_sid = 0;
             memset(&shm_lock->ds_lock_ts, 0, sizeof shm_lock->ds_lock_ts);
+
+            /* wake up any sessions waiting for the DS lock */
+            sr_cond_broadcast(&shm_lock->ds_lock_cond);
         }
 
         /* DS UNLOCK */
@@ -4026,6 +4685,7 @@ error:
             if (lock) {
                 shm_lock->ds_lock_sid = 0;
                 memset(&shm_lock->ds_lock_ts, 0, sizeof shm_lock->ds_lock_ts);
+                sr_cond_broadcast(&shm_lock->ds_lock_cond);
             } else {
                 shm_lock->ds_lock_sid = sid;
                 sr_time_get(&shm_lock->ds_lock_ts, 0);
@@ -4230,6 +4890,172 @@ cleanup:
     return sr_api_ret(NULL, err_info);
 }
 
+/**
+ * @brief Add a lock time histogram into sysrepo-monitoring data.
+ *
+ * @param[in] hist Lock time histogram.
+ * @param[in] name Name of the histogram container to create.
+ * @param[in] parent Parent lock-site node.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+sr_lock_stats_hist_print(const sr_lock_hist_t *hist, const char *name, struct lyd_node *parent)
+{
+    LY_ERR lyrc;
+    struct lyd_node *cont, *bucket;
+    char num_str[21];
+    uint64_t count;
+    uint32_t i;
+
+    if ((lyrc = lyd_new_inner(parent, NULL, name, 0, &cont))) {
+        return lyrc;
+    }
+
+    /* count */
+    sprintf(num_str, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(hist->count));
+    if ((lyrc = lyd_new_term(cont, NULL, "count", num_str, 0, NULL))) {
+        return lyrc;
+    }
+
+    /* total */
+    sprintf(num_str, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(hist->total));
+    if ((lyrc = lyd_new_term(cont, NULL, "total", num_str, 0, NULL))) {
+        return lyrc;
+    }
+
+    for (i = 0; i < SR_LOCK_HIST_BUCKETS; ++i) {
+        if (!(count = ATOMIC_LOAD_RELAXED(hist->buckets[i]))) {
+            continue;
+        }
+
+        /* bucket with upper-bound */
+        if (i < SR_LOCK_HIST_BUCKETS - 1) {
+            sprintf(num_str, "%" PRIu64, (uint64_t)1 << i);
+        } else {
+            strcpy(num_str, "infinity");
+        }
+        if ((lyrc = lyd_new_list(cont, NULL, "bucket", 0, &bucket, num_str))) {
+            return lyrc;
+        }
+
+        /* count */
+        sprintf(num_str, "%" PRIu64, count);
+        if ((lyrc = lyd_new_term(bucket, NULL, "count", num_str, 0, NULL))) {
+            return lyrc;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/* /sysrepo-monitoring:sysrepo-state/connection/lock-site */
+static int
+sr_lock_stats_oper_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
+        const char *UNUSED(path), const char *UNUSED(request_xpath), uint32_t UNUSED(request_id), struct lyd_node **parent,
+        void *UNUSED(private_data))
+{
+    LY_ERR lyrc;
+    const sr_lock_site_t *sites;
+    const char *func;
+    struct lyd_node *site;
+    uint32_t i;
+
+    assert(*parent);
+
+    sites = sr_lock_stats_sites();
+    for (i = 0; i < SR_LOCK_SITE_MAX; ++i) {
+        if (!(func = ATOMIC_PTR_LOAD_RELAXED(sites[i].func))) {
+            continue;
+        }
+
+        /* lock-site with function */
+        if ((lyrc = lyd_new_list(*parent, NULL, "lock-site", 0, &site, func))) {
+            return SR_ERR_INTERNAL;
+        }
+
+        /* wait-time */
+        if ((lyrc = sr_lock_stats_hist_print(&sites[i].wait, "wait-time", site))) {
+            return SR_ERR_INTERNAL;
+        }
+
+        /* hold-time */
+        if ((lyrc = sr_lock_stats_hist_print(&sites[i].hold, "hold-time", site))) {
+            return SR_ERR_INTERNAL;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+API int
+sr_lock_stats_subscribe(sr_session_ctx_t *session, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription)
+{
+    sr_error_info_t *err_info = NULL;
+    char *xpath;
+    int rc;
+
+    SR_CHECK_ARG_APIRET(!session || !subscription, session, err_info);
+
+    if (asprintf(&xpath, "/sysrepo-monitoring:sysrepo-state/connection[cid='%" PRIu32 "']/lock-site",
+            session->conn->cid) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        return sr_api_ret(session, err_info);
+    }
+
+    /* subscribe */
+    rc = sr_oper_get_subscribe(session, "sysrepo-monitoring", xpath, sr_lock_stats_oper_cb, NULL, opts, subscription);
+    free(xpath);
+    if (rc) {
+        return rc;
+    }
+
+    /* start collecting the statistics */
+    sr_lock_stats_enable();
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Apply or fail all the pending asynchronous apply changes requests of a subscription.
+ *
+ * @param[in] subscription Subscription structure with the requests.
+ * @param[in] apply Whether to apply the changes or only fail the requests.
+ */
+static void
+sr_subscr_apply_changes_process(sr_subscription_ctx_t *subscription, int apply)
+{
+    sr_error_info_t *err_info;
+    struct sr_apply_req_s *reqs;
+    uint32_t i, req_count;
+    int rc;
+
+    /* APPLY LOCK */
+    pthread_mutex_lock(&subscription->apply_lock);
+
+    /* take all the requests, new ones can be added meanwhile */
+    reqs = subscription->apply_reqs;
+    req_count = subscription->apply_req_count;
+    subscription->apply_reqs = NULL;
+    subscription->apply_req_count = 0;
+
+    /* APPLY UNLOCK */
+    pthread_mutex_unlock(&subscription->apply_lock);
+
+    for (i = 0; i < req_count; ++i) {
+        if (apply) {
+            err_info = _sr_apply_changes(reqs[i].sess, reqs[i].timeout_ms);
+        } else {
+            err_info = NULL;
+            sr_errinfo_new(&err_info, SR_ERR_OPERATION_FAILED, "Subscription terminated before the changes were applied.");
+        }
+        rc = sr_api_ret(reqs[i].sess, err_info);
+
+        /* report the result */
+        reqs[i].cb(reqs[i].sess, rc, reqs[i].private_data);
+    }
+    free(reqs);
+}
+
 API int
 sr_get_event_pipe(sr_subscription_ctx_t *subscription, int *event_pipe)
 {
@@ -4241,18 +5067,82 @@ sr_get_event_pipe(sr_subscription_ctx_t *subscription, int *event_pipe)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Resolve the schema nodes of all the subscription XPaths again after a context change.
+ *
+ * @param[in] subscription Subscription structure, its SUBS lock must not be held.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_subscr_xpath_snodes_refresh(sr_subscription_ctx_t *subscription)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = subscription->conn;
+    uint32_t i, j;
+
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
+            NULL, NULL))) {
+        return err_info;
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        goto cleanup_subs_unlock;
+    }
+
+    if ((subscription->snodes_ly_ctx == conn->ly_ctx) && (subscription->snodes_content_id == conn->content_id)) {
+        /* refreshed meanwhile */
+        goto cleanup_unlock;
+    }
+
+    for (i = 0; i < subscription->change_sub_count; ++i) {
+        for (j = 0; j < subscription->change_subs[i].sub_count; ++j) {
+            sr_xpath_snodes_update(conn, subscription->change_subs[i].subs[j].xpath,
+                    &subscription->change_subs[i].subs[j].xpath_snodes);
+        }
+    }
+    for (i = 0; i < subscription->notif_sub_count; ++i) {
+        for (j = 0; j < subscription->notif_subs[i].sub_count; ++j) {
+            sr_xpath_snodes_update(conn, subscription->notif_subs[i].subs[j].xpath,
+                    &subscription->notif_subs[i].subs[j].xpath_snodes);
+        }
+    }
+    for (i = 0; i < subscription->rpc_sub_count; ++i) {
+        for (j = 0; j < subscription->rpc_subs[i].sub_count; ++j) {
+            sr_xpath_snodes_update(conn, subscription->rpc_subs[i].subs[j].xpath,
+                    &subscription->rpc_subs[i].subs[j].xpath_snodes);
+        }
+    }
+
+    subscription->snodes_ly_ctx = conn->ly_ctx;
+    subscription->snodes_content_id = conn->content_id;
+
+cleanup_unlock:
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+cleanup_subs_unlock:
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
+    return err_info;
+}
+
 API int
 sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_ctx_t *session, struct timespec *wake_up_in)
 {
     sr_error_info_t *err_info = NULL;
-    int ret, mod_finished;
+    int ret, mod_finished, snodes_outdated = 0, ev_thread;
     char buf[1];
-    uint32_t i;
+    uint32_t i, claimed[SR_EVPIPE_READY_WORD_COUNT], *ready = NULL;
     sr_lock_mode_t ctx_mode = SR_LOCK_NONE;
 
     /* session does not have to be set */
     SR_CHECK_ARG_APIRET(!subscription, session, err_info);
 
+    /* the callbacks must not wait for writers that may be waiting for the event originators */
+    ev_thread = sr_rwlock_ev_thread_set(1);
+
     if (wake_up_in) {
         memset(wake_up_in, 0, sizeof *wake_up_in);
     }
@@ -4262,6 +5152,7 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
     /* SUBS READ LOCK */
     if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscription->conn->cid,
             __func__, NULL, NULL))) {
+        sr_rwlock_ev_thread_set(ev_thread);
         return sr_api_ret(session, err_info);
     }
 
@@ -4275,22 +5166,54 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
         goto cleanup_unlock;
     }
 
+    /* claim the subscriptions marked by the event originators, if there are none (explicit call, timer, internal
+     * wake up) process all the subscriptions */
+    if (sr_shmsub_listen_ready_claim(subscription, claimed)) {
+        ready = claimed;
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(subscription->conn, SR_LOCK_READ, 0, __func__))) {
         goto cleanup_unlock;
     }
     ctx_mode = SR_LOCK_READ;
 
+    /* the schema nodes of the XPaths are not used until resolved again in the current context */
+    if ((subscription->snodes_ly_ctx != subscription->conn->ly_ctx) ||
+            (subscription->snodes_content_id != subscription->conn->content_id)) {
+        snodes_outdated = 1;
+    }
+
     /* change subscriptions */
     for (i = 0; i < subscription->change_sub_count; ++i) {
-        if ((err_info = sr_shmsub_change_listen_process_module_events(&subscription->change_subs[i], subscription->conn))) {
+        if (!sr_shmsub_listen_ready_is_set(ready, subscription->change_subs[i].module_name,
+                sr_ds2str(subscription->change_subs[i].ds))) {
+            continue;
+        }
+        if (subscription->workers.count) {
+            /* process the events by a worker, in order */
+            err_info = sr_shmsub_workers_add_group_job(subscription, &subscription->change_subs[i].busy,
+                    SR_SUBSCR_JOB_CHANGE, subscription->change_subs[i].module_name, subscription->change_subs[i].ds);
+        } else {
+            err_info = sr_shmsub_change_listen_process_module_events(&subscription->change_subs[i], subscription->conn);
+        }
+        if (err_info) {
             goto cleanup_unlock;
         }
     }
 
     /* operational get subscriptions */
     for (i = 0; i < subscription->oper_get_sub_count; ++i) {
-        if ((err_info = sr_shmsub_oper_get_listen_process_module_events(&subscription->oper_get_subs[i], subscription->conn))) {
+        if (!sr_shmsub_listen_ready_is_set(ready, subscription->oper_get_subs[i].module_name, "oper")) {
+            continue;
+        }
+        if (subscription->workers.count) {
+            err_info = sr_shmsub_workers_add_group_job(subscription, &subscription->oper_get_subs[i].busy,
+                    SR_SUBSCR_JOB_OPER_GET, subscription->oper_get_subs[i].module_name, 0);
+        } else {
+            err_info = sr_shmsub_oper_get_listen_process_module_events(&subscription->oper_get_subs[i], subscription->conn);
+        }
+        if (err_info) {
             goto cleanup_unlock;
         }
     }
@@ -4305,7 +5228,10 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
 
     /* RPC/action subscriptions */
     for (i = 0; i < subscription->rpc_sub_count; ++i) {
-        if ((err_info = sr_shmsub_rpc_listen_process_rpc_events(&subscription->rpc_subs[i], subscription->conn))) {
+        if (!sr_shmsub_listen_ready_is_set(ready, subscription->rpc_subs[i].path, "rpc")) {
+            continue;
+        }
+        if ((err_info = sr_shmsub_rpc_listen_process_rpc_events(&subscription->rpc_subs[i], subscription))) {
             goto cleanup_unlock;
         }
     }
@@ -4331,7 +5257,17 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
         }
 
         /* standard event processing */
-        if ((err_info = sr_shmsub_notif_listen_process_module_events(&subscription->notif_subs[i], subscription->conn))) {
+        if (!sr_shmsub_listen_ready_is_set(ready, subscription->notif_subs[i].module_name, "notif") &&
+                SR_TS_IS_ZERO(subscription->notif_subs[i].batch_flush)) {
+            /* no new or deferred notifications */
+        } else if (subscription->workers.count) {
+            err_info = sr_shmsub_workers_add_group_job(subscription, &subscription->notif_subs[i].busy,
+                    SR_SUBSCR_JOB_NOTIF, subscription->notif_subs[i].module_name, 0);
+        } else {
+            err_info = sr_shmsub_notif_listen_process_module_events(&subscription->notif_subs[i], wake_up_in ? 1 : 0,
+                    subscription->conn);
+        }
+        if (err_info) {
             goto cleanup_unlock;
         }
 
@@ -4348,9 +5284,26 @@ cleanup_unlock:
         sr_lycc_unlock(subscription->conn, ctx_mode, 0, __func__);
     }
 
+    if (err_info && ready) {
+        /* the events were not processed, keep the subscriptions marked */
+        sr_shmsub_listen_ready_unclaim(subscription, ready);
+    }
+
     /* SUBS READ UNLOCK */
     sr_rwunlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscription->conn->cid, __func__);
 
+    sr_rwlock_ev_thread_set(ev_thread);
+
+    if (!err_info && snodes_outdated) {
+        /* for the next events, cannot be done with SUBS READ lock held */
+        err_info = sr_subscr_xpath_snodes_refresh(subscription);
+    }
+
+    if (!err_info) {
+        /* apply changes, without any locks held */
+        sr_subscr_apply_changes_process(subscription, 1);
+    }
+
     return sr_api_ret(session, err_info);
 }
 
@@ -4483,8 +5436,9 @@ _sr_subscription_suspend_change(sr_subscription_ctx_t *subscription, uint32_t su
 
         /* send the special notification */
         sr_time_get(&cur_time, 0);
-        if ((err_info = sr_notif_call_callback(ev_sess, notif_sub->cb, notif_sub->tree_cb, notif_sub->private_data,
-                suspend ? SR_EV_NOTIF_SUSPENDED : SR_EV_NOTIF_RESUMED, sub_id, NULL, &cur_time))) {
+        if ((err_info = sr_notif_call_callback(ev_sess, notif_sub->cb, notif_sub->tree_cb, notif_sub->batch_cb,
+                notif_sub->private_data, suspend ? SR_EV_NOTIF_SUSPENDED : SR_EV_NOTIF_RESUMED, sub_id, NULL,
+                &cur_time))) {
             goto cleanup;
         }
     }
@@ -4638,6 +5592,130 @@ sr_subscription_thread_resume(sr_subscription_ctx_t *subscription)
     return sr_api_ret(NULL, NULL);
 }
 
+/**
+ * @brief Stop all the worker threads of a subscription structure and drop their pending jobs.
+ *
+ * @param[in] subscription Subscription structure.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_subscr_workers_stop(sr_subscription_ctx_t *subscription)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_subscr_workers_s *workers = &subscription->workers;
+    uint32_t i;
+    int ret;
+
+    if (!workers->count) {
+        return NULL;
+    }
+
+    /* WORKERS LOCK */
+    pthread_mutex_lock(&workers->lock);
+
+    /* signal the workers to quit */
+    workers->stop = 1;
+    sr_cond_broadcast(&workers->cond);
+
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
+
+    /* join them */
+    for (i = 0; i < workers->count; ++i) {
+        ret = pthread_join(workers->tids[i], NULL);
+        if (ret) {
+            sr_errinfo_new(&err_info, SR_ERR_SYS, "Joining a subscription worker thread failed (%s).", strerror(ret));
+        }
+    }
+    free(workers->tids);
+    workers->tids = NULL;
+    workers->count = 0;
+    workers->stop = 0;
+
+    /* drop the pending jobs */
+    for (i = 0; i < workers->job_count; ++i) {
+        free(workers->jobs[i].path);
+    }
+    free(workers->jobs);
+    workers->jobs = NULL;
+    workers->job_count = 0;
+
+    return err_info;
+}
+
+API int
+sr_subscription_set_workers(sr_subscription_ctx_t *subscription, uint32_t worker_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_subscr_workers_s *workers;
+    uint32_t i, j;
+    int ret;
+
+    SR_CHECK_ARG_APIRET(!subscription, NULL, err_info);
+
+    workers = &subscription->workers;
+
+    /* stop the current workers */
+    if ((err_info = sr_subscr_workers_stop(subscription))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    /* SUBS READ LOCK */
+    if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscription->conn->cid,
+            __func__, NULL, NULL))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    /* the dropped jobs will never be processed by a worker */
+    for (i = 0; i < subscription->change_sub_count; ++i) {
+        ATOMIC_STORE_RELAXED(subscription->change_subs[i].busy, SR_SUBSCR_IDLE);
+    }
+    for (i = 0; i < subscription->oper_get_sub_count; ++i) {
+        ATOMIC_STORE_RELAXED(subscription->oper_get_subs[i].busy, SR_SUBSCR_IDLE);
+    }
+    for (i = 0; i < subscription->notif_sub_count; ++i) {
+        ATOMIC_STORE_RELAXED(subscription->notif_subs[i].busy, SR_SUBSCR_IDLE);
+    }
+    for (i = 0; i < subscription->rpc_sub_count; ++i) {
+        for (j = 0; j < SR_RPC_SUB_SLOT_COUNT; ++j) {
+            ATOMIC_STORE_RELAXED(subscription->rpc_subs[i].slot_busy[j], 0);
+        }
+    }
+
+    /* SUBS READ UNLOCK */
+    sr_rwunlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscription->conn->cid, __func__);
+
+    if (!worker_count) {
+        return sr_api_ret(NULL, NULL);
+    }
+
+    /* start the new workers */
+    workers->tids = calloc(worker_count, sizeof *workers->tids);
+    SR_CHECK_MEM_GOTO(!workers->tids, err_info, cleanup);
+    for (i = 0; i < worker_count; ++i) {
+        ret = pthread_create(&workers->tids[i], NULL, sr_shmsub_worker_thread, subscription);
+        if (ret) {
+            sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Creating a new thread failed (%s).", strerror(ret));
+            break;
+        }
+        ++workers->count;
+    }
+    if (err_info) {
+        goto cleanup;
+    }
+
+    /* events may have arrived meanwhile */
+    err_info = sr_shmsub_notify_evpipe(subscription->evpipe_num);
+
+cleanup:
+    if (err_info) {
+        sr_errinfo_merge(&err_info, sr_subscr_workers_stop(subscription));
+        free(workers->tids);
+        workers->tids = NULL;
+    }
+    return sr_api_ret(NULL, err_info);
+}
+
 /**
  * @brief Unlocked unsubscribe (free) of all the subscriptions in a subscription structure.
  *
@@ -4686,6 +5764,11 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
         }
     }
 
+    /* stop the workers */
+    if ((tmp_err = sr_subscr_workers_stop(subscription))) {
+        sr_errinfo_merge(&err_info, tmp_err);
+    }
+
     /* unlink event pipe */
     if ((tmp_err = sr_path_evpipe(subscription->evpipe_num, &path))) {
         /* continue */
@@ -4698,9 +5781,28 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
         }
     }
 
+    /* unlink its ready bitmap, mapped sub SHMs cached by connections are no longer valid */
+    if ((tmp_err = sr_path_evpipe_ready(subscription->evpipe_num, &path))) {
+        /* continue */
+        sr_errinfo_merge(&err_info, tmp_err);
+    } else {
+        ret = unlink(path);
+        free(path);
+        if (!ret) {
+            ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(subscription->conn)->sub_shm_gen);
+        }
+    }
+
+    /* fail any changes not yet applied */
+    sr_subscr_apply_changes_process(subscription, 0);
+
     /* free attributes */
     close(subscription->evpipe);
+    sr_shm_clear(&subscription->evpipe_ready);
     sr_rwlock_destroy(&subscription->subs_lock);
+    pthread_mutex_destroy(&subscription->apply_lock);
+    pthread_mutex_destroy(&subscription->workers.lock);
+    sr_cond_destroy(&subscription->workers.cond);
     free(subscription);
     return err_info;
 }
@@ -4840,8 +5942,18 @@ sr_subscr_new(sr_conn_ctx_t *conn, sr_subscr_options_t opts, sr_subscription_ctx
     *subs_p = calloc(1, sizeof **subs_p);
     SR_CHECK_MEM_RET(!*subs_p, err_info);
     sr_rwlock_init(&(*subs_p)->subs_lock, 0);
+    if ((err_info = sr_mutex_init(&(*subs_p)->apply_lock, 0))) {
+        goto error_free;
+    }
+    if ((err_info = sr_mutex_init(&(*subs_p)->workers.lock, 0))) {
+        goto error_apply_lock;
+    }
+    if ((err_info = sr_cond_init(&(*subs_p)->workers.cond, 0, 0))) {
+        goto error_workers_lock;
+    }
     (*subs_p)->conn = conn;
     (*subs_p)->evpipe = -1;
+    (*subs_p)->evpipe_ready.fd = -1;
 
     /* get new event pipe number and increment it */
     (*subs_p)->evpipe_num = ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM((*subs_p)->conn)->new_evpipe_num);
@@ -4864,6 +5976,23 @@ sr_subscr_new(sr_conn_ctx_t *conn, sr_subscr_options_t opts, sr_subscription_ctx
         goto error;
     }
 
+    /* get event pipe ready bitmap name */
+    free(path);
+    path = NULL;
+    if ((err_info = sr_path_evpipe_ready((*subs_p)->evpipe_num, &path))) {
+        goto error;
+    }
+
+    /* create and map the ready bitmap, the event originators mark the subscriptions with new events in it */
+    (*subs_p)->evpipe_ready.fd = sr_open(path, O_RDWR | O_CREAT | O_EXCL, SR_SUB_SHM_PERM);
+    if ((*subs_p)->evpipe_ready.fd == -1) {
+        SR_ERRINFO_SYSERRPATH(&err_info, "open", path);
+        goto error;
+    }
+    if ((err_info = sr_shm_remap(&(*subs_p)->evpipe_ready, sizeof(sr_evpipe_ready_t)))) {
+        goto error;
+    }
+
     if (!(opts & SR_SUBSCR_NO_THREAD)) {
         /* set thread_running to non-zero so that thread does not immediately quit */
         if (opts & SR_SUBSCR_THREAD_SUSPEND) {
@@ -4884,10 +6013,24 @@ sr_subscr_new(sr_conn_ctx_t *conn, sr_subscr_options_t opts, sr_subscription_ctx
     return NULL;
 
 error:
+    if ((*subs_p)->evpipe_ready.fd > -1) {
+        unlink(path);
+    }
     free(path);
     if ((*subs_p)->evpipe > -1) {
         close((*subs_p)->evpipe);
     }
+    sr_shm_clear(&(*subs_p)->evpipe_ready);
+    sr_cond_destroy(&(*subs_p)->workers.cond);
+
+error_workers_lock:
+    pthread_mutex_destroy(&(*subs_p)->workers.lock);
+
+error_apply_lock:
+    pthread_mutex_destroy(&(*subs_p)->apply_lock);
+
+error_free:
+    sr_rwlock_destroy(&(*subs_p)->subs_lock);
     free(*subs_p);
     *subs_p = NULL;
     return err_info;
@@ -5109,9 +6252,11 @@ sr_module_change_sub_modify_xpath(sr_subscription_ctx_t *subscription, uint32_t
     /* update xpath in the subscription */
     free(change_sub->xpath);
     change_sub->xpath = NULL;
+    sr_xpath_snodes_free(&change_sub->xpath_snodes);
     if (xpath) {
         change_sub->xpath = strdup(xpath);
         SR_CHECK_MEM_GOTO(!change_sub->xpath, err_info, cleanup_unlock);
+        sr_xpath_snodes_update(subscription->conn, xpath, &change_sub->xpath_snodes);
     }
 
     /* find the module in SHM */
@@ -5137,7 +6282,13 @@ _sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, int dup, sr_c
 
     SR_CHECK_ARG_APIRET(!session || !SR_IS_EVENT_SESS(session) || !xpath || !iter, session, err_info);
 
-    if ((session->ev != SR_SUB_EV_ENABLED) && (session->ev != SR_SUB_EV_DONE) && !session->dt[session->ds].diff) {
+    /* parse the subtrees of the event diff the changes may be selected from */
+    if ((err_info = sr_session_ev_diff_parse(session, NULL, xpath))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    if ((session->ev != SR_SUB_EV_ENABLED) && (session->ev != SR_SUB_EV_DONE) && !session->dt[session->ds].diff &&
+            !session->ev_diff.idx) {
         sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Session without changes.");
         return sr_api_ret(session, err_info);
     }
@@ -6092,6 +7243,9 @@ cleanup:
  * @param[in] stop_time Optional subscription stop time.
  * @param[in] callback Callback.
  * @param[in] tree_callback Tree callback.
+ * @param[in] batch_callback Batch callback.
+ * @param[in] batch_size Maximum batch size for @p batch_callback.
+ * @param[in] batch_timeout_us Maximum batch delivery deferral for @p batch_callback.
  * @param[in] private_data Arbitrary callback data.
  * @param[in] opts Subscription options.
  * @param[out] subscription Subscription structure.
@@ -6100,7 +7254,8 @@ cleanup:
 static int
 _sr_notif_subscribe(sr_session_ctx_t *session, const char *mod_name, const char *xpath, const struct timespec *start_time,
         const struct timespec *stop_time, sr_event_notif_cb callback, sr_event_notif_tree_cb tree_callback,
-        void *private_data, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription)
+        sr_event_notif_batch_cb batch_callback, uint32_t batch_size, uint32_t batch_timeout_us, void *private_data,
+        sr_subscr_options_t opts, sr_subscription_ctx_t **subscription)
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     struct timespec listen_since, cur_ts;
@@ -6115,7 +7270,7 @@ _sr_notif_subscribe(sr_session_ctx_t *session, const char *mod_name, const char
             (start_time && (sr_time_cmp(start_time, &cur_ts) > 0)) ||
             (stop_time && ((start_time && (sr_time_cmp(stop_time, start_time) < 0)) ||
             (!start_time && (sr_time_cmp(stop_time, &cur_ts) < 0)))) ||
-            (!callback && !tree_callback) || !subscription, session, err_info);
+            (!callback && !tree_callback && !batch_callback) || !subscription, session, err_info);
     conn = session->conn;
 
     /* CONTEXT LOCK */
@@ -6164,7 +7319,8 @@ _sr_notif_subscribe(sr_session_ctx_t *session, const char *mod_name, const char
     }
 
     /* add notification subscription into ext SHM and create separate specific SHM segment */
-    if ((err_info = sr_shmext_notif_sub_add(conn, shm_mod, sub_id, xpath, (*subscription)->evpipe_num, &listen_since))) {
+    if ((err_info = sr_shmext_notif_sub_add(conn, shm_mod, sub_id, xpath, (*subscription)->evpipe_num,
+            (opts & SR_SUBSCR_NOTIF_DROP) ? 1 : 0, &listen_since))) {
         goto cleanup_unlock;
     }
 
@@ -6172,8 +7328,9 @@ _sr_notif_subscribe(sr_session_ctx_t *session, const char *mod_name, const char
      * the evpipe data cannot be read and the event not processed since it is still missing in the subscr structure */
 
     /* add subscription into structure */
-    if ((err_info = sr_subscr_notif_sub_add(*subscription, sub_id, session, ly_mod->name, xpath, &listen_since,
-            start_time, stop_time, callback, tree_callback, private_data, SR_LOCK_WRITE))) {
+    if ((err_info = sr_subscr_notif_sub_add(*subscription, sub_id, session, ly_mod->name, xpath,
+            (opts & SR_SUBSCR_NOTIF_DROP) ? 1 : 0, &listen_since, start_time, stop_time, callback, tree_callback,
+            batch_callback, batch_size, batch_timeout_us, private_data, SR_LOCK_WRITE))) {
         goto error1;
     }
 
@@ -6215,8 +7372,8 @@ sr_notif_subscribe(sr_session_ctx_t *session, const char *module_name, const cha
         const struct timespec *stop_time, sr_event_notif_cb callback, void *private_data, sr_subscr_options_t opts,
         sr_subscription_ctx_t **subscription)
 {
-    return _sr_notif_subscribe(session, module_name, xpath, start_time, stop_time, callback, NULL, private_data, opts,
-            subscription);
+    return _sr_notif_subscribe(session, module_name, xpath, start_time, stop_time, callback, NULL, NULL, 0, 0,
+            private_data, opts, subscription);
 }
 
 API int
@@ -6224,8 +7381,18 @@ sr_notif_subscribe_tree(sr_session_ctx_t *session, const char *module_name, cons
         const struct timespec *start_time, const struct timespec *stop_time, sr_event_notif_tree_cb callback,
         void *private_data, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription)
 {
-    return _sr_notif_subscribe(session, module_name, xpath, start_time, stop_time, NULL, callback, private_data, opts,
-            subscription);
+    return _sr_notif_subscribe(session, module_name, xpath, start_time, stop_time, NULL, callback, NULL, 0, 0,
+            private_data, opts, subscription);
+}
+
+API int
+sr_notif_subscribe_tree_batch(sr_session_ctx_t *session, const char *module_name, const char *xpath,
+        const struct timespec *start_time, const struct timespec *stop_time, uint32_t batch_size,
+        uint32_t batch_timeout_us, sr_event_notif_batch_cb callback, void *private_data, sr_subscr_options_t opts,
+        sr_subscription_ctx_t **subscription)
+{
+    return _sr_notif_subscribe(session, module_name, xpath, start_time, stop_time, NULL, NULL, callback, batch_size,
+            batch_timeout_us, private_data, opts, subscription);
 }
 
 API int
@@ -6488,9 +7655,11 @@ sr_notif_sub_modify_xpath(sr_subscription_ctx_t *subscription, uint32_t sub_id,
     /* update xpath */
     free(notif_sub->xpath);
     notif_sub->xpath = NULL;
+    sr_xpath_snodes_free(&notif_sub->xpath_snodes);
     if (xpath) {
         notif_sub->xpath = strdup(xpath);
         SR_CHECK_MEM_GOTO(!notif_sub->xpath, err_info, cleanup_unlock);
+        sr_xpath_snodes_update(subscription->conn, xpath, &notif_sub->xpath_snodes);
     }
 
     /* create event session */
@@ -6500,8 +7669,8 @@ sr_notif_sub_modify_xpath(sr_subscription_ctx_t *subscription, uint32_t sub_id,
 
     /* send the special notification */
     sr_time_get(&cur_time, 0);
-    if ((err_info = sr_notif_call_callback(ev_sess, notif_sub->cb, notif_sub->tree_cb, notif_sub->private_data,
-            SR_EV_NOTIF_MODIFIED, sub_id, NULL, &cur_time))) {
+    if ((err_info = sr_notif_call_callback(ev_sess, notif_sub->cb, notif_sub->tree_cb, notif_sub->batch_cb,
+            notif_sub->private_data, SR_EV_NOTIF_MODIFIED, sub_id, NULL, &cur_time))) {
         goto cleanup_unlock;
     }
 
@@ -6561,8 +7730,8 @@ sr_notif_sub_modify_stop_time(sr_subscription_ctx_t *subscription, uint32_t sub_
 
     /* send the special notification */
     sr_time_get(&cur_time, 0);
-    if ((err_info = sr_notif_call_callback(ev_sess, notif_sub->cb, notif_sub->tree_cb, notif_sub->private_data,
-            SR_EV_NOTIF_MODIFIED, sub_id, NULL, &cur_time))) {
+    if ((err_info = sr_notif_call_callback(ev_sess, notif_sub->cb, notif_sub->tree_cb, notif_sub->batch_cb,
+            notif_sub->private_data, SR_EV_NOTIF_MODIFIED, sub_id, NULL, &cur_time))) {
         goto cleanup_unlock;
     }
 
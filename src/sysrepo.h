@@ -196,6 +196,7 @@ uint32_t sr_get_content_id(sr_conn_ctx_t *conn);
  * the callback will be used.
  *
  * @note If using schema-mount, to specify directory with the mounted YANG modules, use ::sr_set_ext_data_searchdir().
+ * Not supported for connections with ::SR_CONN_CTX_SHARED.
  *
  * @param[in] conn Connection to use.
  * @param[in] cb Libyang ext data callback.
@@ -205,6 +206,7 @@ void sr_set_ext_data_cb(sr_conn_ctx_t *conn, ly_ext_data_clb cb, void *user_data
 
 /**
  * @brief Set libyang search directory for YANG modules needed for parsing extension instance data (such as schema-mount).
+ * Not supported for connections with ::SR_CONN_CTX_SHARED.
  *
  * @param[in] conn Connection to use.
  * @param[in] searchdir Search directory for YANG modules.
@@ -840,6 +842,39 @@ int sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout
 int sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
         const sr_get_options_t opts, sr_data_t **data);
 
+/**
+ * @brief Retrieve a tree whose root nodes match the provided XPath in chunks passed to a callback.
+ * Data are represented as _libyang_ subtrees.
+ *
+ * Behaves the same as ::sr_get_data() except that the result is never built as a whole. Instead, the selected
+ * subtrees are duplicated into chunks of at least @p chunk_size subtrees that are passed to @p callback
+ * and freed right after. A chunk always consists of complete top-level trees so top-level nodes are never
+ * repeated in several chunks and the chunks can be printed one after another. As a consequence, all the subtrees
+ * selected in a single top-level tree, for example all the instances of a large top-level container, are always
+ * passed in a single chunk.
+ *
+ * Only the copy of the result is split, the data of all the retrieved modules are still loaded (and operational
+ * data retrieved from the subscribers) as a whole before the first chunk, so the memory needed for them is the same
+ * as for ::sr_get_data().
+ *
+ * The retrieved modules remain READ-locked and the context locked while @p callback is being called for all
+ * the chunks, so any writers of the modules and context changes wait until this function returns. The callback
+ * must not modify any data of the retrieved modules and should process the chunks quickly.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] xpath [XPath](@ref paths) selecting root nodes of subtrees to be retrieved.
+ * @param[in] max_depth Maximum depth of the selected subtrees. 0 is unlimited, 1 will not return any
+ * descendant nodes. If a list should be returned, its keys are always returned as well.
+ * @param[in] chunk_size Minimal number of selected subtrees in a chunk, 0 for 1.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[in] callback Callback to be called for each chunk.
+ * @param[in] private_data Private context passed to the callback function, opaque to sysrepo.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_CALLBACK_FAILED if the callback failed).
+ */
+int sr_get_data_chunks(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t chunk_size,
+        uint32_t timeout_ms, const sr_get_options_t opts, sr_get_chunk_cb callback, void *private_data);
+
 /**
  * @brief Retrieve a single value matching the provided XPath.
  * Data are represented as a single _libyang_ node.
@@ -1036,6 +1071,30 @@ int sr_validate(sr_session_ctx_t *session, const char *module_name, uint32_t tim
  */
 int sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms);
 
+/**
+ * @brief Apply changes made in the current session asynchronously. The changes are applied when the events of
+ * @p subscription are processed (by its handler thread or ::sr_subscription_process_events) and @p callback
+ * is called afterwards. Same as with ::sr_apply_changes, the changes remain intact in the session on failure.
+ *
+ * @note The session must not be used until @p callback is called. Several sessions can have their changes
+ * applied at once if each uses a different subscription structure. The subscription structure must not
+ * have any change subscriptions notified about these changes, it would result in a timeout.
+ *
+ * Required WRITE access.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to apply changes of.
+ * @param[in] timeout_ms Change callback timeout in milliseconds. If 0, default is used.
+ * @param[in] callback Callback to be called once the changes were applied or failed to be applied.
+ * @param[in] private_data Private context passed to the callback function, opaque to sysrepo.
+ * @param[in] opts Options overriding default behavior of the subscription, it is supposed to be
+ * a bitwise OR-ed value of any ::sr_subscr_flag_t flags. Used only if a new subscription structure is created.
+ * @param[in,out] subscription Subscription structure that will apply the changes, can be shared with other
+ * subscriptions. Use ::sr_unsubscribe to free it, any changes not yet applied then fail to be applied.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_apply_changes_async(sr_session_ctx_t *session, uint32_t timeout_ms, sr_apply_changes_cb callback,
+        void *private_data, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription);
+
 /**
  * @brief Learn whether there are any prepared non-applied changes in the session.
  *
@@ -1155,6 +1214,22 @@ int sr_unlock(sr_session_ctx_t *session, const char *module_name);
 int sr_get_lock(sr_conn_ctx_t *conn, sr_datastore_t datastore, const char *module_name, int *is_locked, uint32_t *id,
         struct timespec *timestamp);
 
+/**
+ * @brief Start collecting internal lock statistics of this process and subscribe for providing them as
+ * _/sysrepo-monitoring:sysrepo-state/connection/lock-site_ operational data of the session connection.
+ *
+ * Every function acquiring a lock has a histogram of the lock wait and hold times. They are kept in the memory
+ * of this process, shared by all its connections, and include only the locks acquired by this process. Once
+ * collecting is started, it cannot be stopped.
+ *
+ * @param[in] session Session to use.
+ * @param[in] opts Options overriding default behavior of the subscription, it is supposed to be a bitwise OR-ed value
+ * of any ::sr_subscr_flag_t flags.
+ * @param[in,out] subscription Subscription context, is supposed to be released by ::sr_unsubscribe.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_lock_stats_subscribe(sr_session_ctx_t *session, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription);
+
 /** @} lock */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1263,6 +1338,24 @@ int sr_subscription_thread_suspend(sr_subscription_ctx_t *subscription);
  */
 int sr_subscription_thread_resume(sr_subscription_ctx_t *subscription);
 
+/**
+ * @brief Set the number of worker threads of a subscription structure processing its events concurrently.
+ *
+ * The thread processing the events of the subscription structure (the default handler thread or the one calling
+ * ::sr_subscription_process_events()) only passes the events to the workers instead of calling the callbacks itself
+ * so that a slow callback does not delay the events of other subscriptions. Change events of a module in
+ * a datastore, operational get events of a module, and notifications of a module are always processed by a single
+ * worker at a time and in order. Up to 8 requests of the same RPC/action can be processed at the same time.
+ * All the callbacks must be thread-safe. Operational poll subscriptions are always handled by the processing thread.
+ *
+ * Should be called right after the subscription structure is created or with its handler thread suspended.
+ *
+ * @param[in] subscription Subscription context to use.
+ * @param[in] worker_count Number of worker threads, 0 to stop all the workers and process the events directly.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_subscription_set_workers(sr_subscription_ctx_t *subscription, uint32_t worker_count);
+
 /**
  * @brief Unsubscribe all the subscriptions in a subscription structure and free it.
  *
@@ -1553,6 +1646,37 @@ int sr_notif_subscribe_tree(sr_session_ctx_t *session, const char *module_name,
         const struct timespec *start_time, const struct timespec *stop_time, sr_event_notif_tree_cb callback,
         void *private_data, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription);
 
+/**
+ * @brief Subscribes for the delivery of notification(s) in batches. Data are represented as _libyang_ subtrees.
+ *
+ * All the real-time notifications pending when the subscription processes its events are parsed using a single
+ * event session and delivered in one callback call, at most @p batch_size at once. If @p batch_timeout_us is set,
+ * delivery of the pending notifications is deferred until there are @p batch_size of them or the oldest was published
+ * @p batch_timeout_us ago. Deferring is performed only if all the subscriptions of the module in @p subscription are
+ * batched and the events are processed by the subscription thread or ::sr_subscription_process_events() with
+ * a @p wake_up_in parameter. Replayed notifications and the other notification types are delivered one at a time.
+ *
+ * Required WRITE access.
+ *
+ * @param[in] session Session (not [DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] module_name Name of the module whose notifications to subscribe to.
+ * @param[in] xpath Optional [XPath](@ref paths) further filtering received notifications.
+ * @param[in] start_time Optional start time of the subscription. Used for replaying stored notifications.
+ * @param[in] stop_time Optional stop time ending the notification subscription.
+ * @param[in] batch_size Maximum number of notifications delivered at once, 0 for no limit.
+ * @param[in] batch_timeout_us Maximum time a notification may wait for its batch to fill, 0 to never defer delivery.
+ * @param[in] callback Callback to be called when a batch of notifications is delivered.
+ * @param[in] private_data Private context passed to the callback function, opaque to sysrepo.
+ * @param[in] opts Options overriding default behavior of the subscription, it is supposed to be
+ * a bitwise OR-ed value of any ::sr_subscr_flag_t flags.
+ * @param[in,out] subscription Subscription context, zeroed for first subscription, freed by ::sr_unsubscribe.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_notif_subscribe_tree_batch(sr_session_ctx_t *session, const char *module_name, const char *xpath,
+        const struct timespec *start_time, const struct timespec *stop_time, uint32_t batch_size,
+        uint32_t batch_timeout_us, sr_event_notif_batch_cb callback, void *private_data, sr_subscr_options_t opts,
+        sr_subscription_ctx_t **subscription);
+
 /**
  * @brief Send a notification. Data are represented as ::sr_val_t structures. In case there are
  * particularly many notifications send on a session (100 notif/s or more) and all of them
@@ -105,7 +105,47 @@ typedef enum {
     SR_CONN_DEFAULT = 0x0,              /**< No special behaviour. */
     SR_CONN_CACHE_RUNNING = 0x1,        /**< Always cache running datastore data which makes mainly repeated retrieval
                                              of data much faster. Affects all sessions created on this connection. */
-    SR_CONN_CTX_SET_PRIV_PARSED = 0x2   /**< Use LY_CTX_SET_PRIV_PARSED option for the connection libyang context. */
+    SR_CONN_CTX_SET_PRIV_PARSED = 0x2,  /**< Use LY_CTX_SET_PRIV_PARSED option for the connection libyang context. */
+    SR_CONN_CTX_SHARED = 0x4,           /**< Share one read-only libyang context for the current context content ID
+                                             among all the connections with this flag in the process. A new context is
+                                             created only on a context change, by the first connection noticing it.
+                                             Setting ext data callback or searchdir is not supported for such
+                                             connections. The context is never shared with other processes, each
+                                             process still compiles its own. */
+    SR_CONN_CACHE_OPER = 0x8,           /**< Cache stored (pushed) operational data of modules so that they are loaded
+                                             again only after they were changed, which makes repeated retrieval of
+                                             operational data much faster. Affects all sessions created on this
+                                             connection. */
+    SR_CONN_PIPELINED_COMMIT = 0x10,    /**< Release the data locks of modules right after the changes were stored and
+                                             before the "done" change event is processed by the subscribers. Following
+                                             changes of the same modules can then be applied concurrently but all the
+                                             change events are still delivered in the order the changes were stored.
+                                             "Done" callbacks may observe data already modified by a later change.
+                                             Each ::sr_apply_changes call still returns only after its own "done"
+                                             event was processed and the change subscriptions of the modules cannot be
+                                             modified until then. */
+    SR_CONN_GROUP_COMMIT = 0x20,        /**< Changes of sessions on this connection applied while another change of the
+                                             same datastore is being applied are applied together afterwards, stored
+                                             once and notified as a single change. If the joint change fails before it
+                                             is stored, including when a subscriber rejects it, the changes are applied
+                                             again one by one so that each ::sr_apply_changes call gets its own result.
+                                             Only an error after the joint change was stored is returned to all the
+                                             calls, as a group failure. Changes of sessions with a NACM user or
+                                             originator name are applied separately. Changes must not be applied from subscription
+                                             callbacks using such connections. */
+    SR_CONN_ENTRY_LOCK = 0x40,          /**< Changes of sessions on this connection with only top-level list instances,
+                                             not ordered by user, of a single module without any dependencies lock
+                                             exclusively only these instances (their lock stripes) and not the whole
+                                             module. Changes of different instances can then be validated and notified
+                                             to subscribers concurrently and are stored one by one, validated again on
+                                             the current data of the module. While there are no such connections,
+                                             the stripes are not locked at all. */
+    SR_CONN_DATA_LOCK_WRITER_PREF = 0x80 /**< Sessions on this connection waiting to write module data make new readers
+                                             of the data on other connections wait until they are done, which prevents
+                                             the writers from starving. Reads from subscription callbacks, in the thread
+                                             processing the events, never wait this way because the event originator
+                                             may hold the lock the writer waits for. Any other thread a callback waits
+                                             for reading the data may block until the lock timeout and then fail. */
 } sr_conn_flag_t;
 
 /**
@@ -314,6 +354,16 @@ typedef enum {
  */
 typedef uint32_t sr_get_options_t;
 
+/**
+ * @brief Callback to be called for each chunk of data retrieved by ::sr_get_data_chunks.
+ *
+ * @param[in] session Session used for the retrieval.
+ * @param[in] chunk Top-level data trees of the chunk, freed once the callback returns.
+ * @param[in] private_data Private context opaque to sysrepo, as passed to ::sr_get_data_chunks call.
+ * @return User error code (::SR_ERR_OK on success), any other value stops the retrieval.
+ */
+typedef int (*sr_get_chunk_cb)(sr_session_ctx_t *session, const struct lyd_node *chunk, void *private_data);
+
 /** @} getdata */
 
 /**
@@ -432,7 +482,14 @@ typedef enum {
      * @brief On every data retrieval additionally compute diff with the previous data and report the changes to any
      * operational data module change subscriptions. Accepted only for ::sr_oper_poll_subscribe().
      */
-    SR_SUBSCR_OPER_POLL_DIFF = 0x80
+    SR_SUBSCR_OPER_POLL_DIFF = 0x80,
+
+    /**
+     * @brief The subscription never makes the notification senders wait for it to process previous notifications.
+     * Instead, once it falls behind by more notifications than fit into the notification queue, the oldest ones
+     * are dropped for it and it is reported as lagging. Accepted only for notification subscriptions.
+     */
+    SR_SUBSCR_NOTIF_DROP = 0x100
 
 } sr_subscr_flag_t;
 
@@ -521,6 +578,15 @@ typedef struct sr_change_iter_s sr_change_iter_t;
 typedef int (*sr_module_change_cb)(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
         sr_event_t event, uint32_t request_id, void *private_data);
 
+/**
+ * @brief Callback to be called once the changes applied by ::sr_apply_changes_async have been processed.
+ *
+ * @param[in] session Session whose changes were applied, with the error information set if they failed to be applied.
+ * @param[in] err_code Error code the same as ::sr_apply_changes would return (::SR_ERR_OK on success).
+ * @param[in] private_data Private context opaque to sysrepo, as passed to ::sr_apply_changes_async call.
+ */
+typedef void (*sr_apply_changes_cb)(sr_session_ctx_t *session, int err_code, void *private_data);
+
 /** @} datasubs */
 
 /**
@@ -623,6 +689,32 @@ typedef void (*sr_event_notif_cb)(sr_session_ctx_t *session, uint32_t sub_id, co
 typedef void (*sr_event_notif_tree_cb)(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
         const struct lyd_node *notif, struct timespec *timestamp, void *private_data);
 
+/**
+ * @brief Single notification delivered in a batch to the ::sr_event_notif_batch_cb callback.
+ */
+typedef struct {
+    sr_ev_notif_type_t notif_type;  /**< Type of the notification. */
+    const struct lyd_node *notif;   /**< Notification data tree, always points to the __notification__ itself,
+                                         even for nested ones. NULL if not a real notification. */
+    struct timespec timestamp;      /**< Time when the notification was generated. */
+} sr_notif_batch_item_t;
+
+/**
+ * @brief Callback to be called for the delivery of a batch of notifications. Data are represented as _libyang_
+ * subtrees.
+ *
+ * @note Callback must not modify the same module notification subscriptions, it would result in a deadlock.
+ *
+ * @param[in] session Implicit session (do not stop) with information about the event originator session IDs of
+ * the last notification in the batch.
+ * @param[in] sub_id Subscription ID.
+ * @param[in] items Delivered notifications in the order they were generated, valid only in the callback.
+ * @param[in] item_count Count of @p items, never 0.
+ * @param[in] private_data Private context opaque to sysrepo, as passed to ::sr_notif_subscribe_tree_batch call.
+ */
+typedef void (*sr_event_notif_batch_cb)(sr_session_ctx_t *session, uint32_t sub_id, const sr_notif_batch_item_t *items,
+        uint32_t item_count, void *private_data);
+
 /** @} notifsubs */
 
 /**
@@ -921,3 +921,230 @@ cleanup:
     }
     return sr_api_ret(NULL, err_info);
 }
+
+/**
+ * @brief Value iterator.
+ */
+struct sr_val_iter_s {
+    struct ly_set *set;     /**< Set of all the matching nodes. */
+    uint32_t idx;           /**< Index of the next node in set. */
+    sr_val_view_t view;     /**< View of the current node. */
+    char *path;             /**< Reused buffer for the path of the current node. */
+    size_t path_size;       /**< Size of path. */
+};
+
+/**
+ * @brief Fill a value view of a data node.
+ *
+ * @param[in] node Data node.
+ * @param[out] view View to fill.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_val_view_fill(const struct lyd_node *node, sr_val_view_t *view)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lyd_value *val;
+    const struct lyd_node_any *any;
+
+    view->node = node;
+    view->dflt = node->flags & LYD_DEFAULT ? 1 : 0;
+    view->value = NULL;
+    view->value_len = 0;
+
+    switch (node->schema->nodetype) {
+    case LYS_LEAF:
+    case LYS_LEAFLIST:
+        val = &((const struct lyd_node_term *)node)->value;
+        if (val->realtype->basetype == LY_TYPE_UNION) {
+            val = &val->subvalue->value;
+        }
+
+        switch (val->realtype->basetype) {
+        case LY_TYPE_BINARY:
+            view->type = SR_BINARY_T;
+            break;
+        case LY_TYPE_BITS:
+            view->type = SR_BITS_T;
+            break;
+        case LY_TYPE_BOOL:
+            view->type = SR_BOOL_T;
+            break;
+        case LY_TYPE_DEC64:
+            view->type = SR_DECIMAL64_T;
+            break;
+        case LY_TYPE_EMPTY:
+            view->type = SR_LEAF_EMPTY_T;
+            break;
+        case LY_TYPE_ENUM:
+            view->type = SR_ENUM_T;
+            break;
+        case LY_TYPE_IDENT:
+            view->type = SR_IDENTITYREF_T;
+            break;
+        case LY_TYPE_INST:
+            view->type = SR_INSTANCEID_T;
+            break;
+        case LY_TYPE_INT8:
+            view->type = SR_INT8_T;
+            break;
+        case LY_TYPE_INT16:
+            view->type = SR_INT16_T;
+            break;
+        case LY_TYPE_INT32:
+            view->type = SR_INT32_T;
+            break;
+        case LY_TYPE_INT64:
+            view->type = SR_INT64_T;
+            break;
+        case LY_TYPE_STRING:
+            view->type = SR_STRING_T;
+            break;
+        case LY_TYPE_UINT8:
+            view->type = SR_UINT8_T;
+            break;
+        case LY_TYPE_UINT16:
+            view->type = SR_UINT16_T;
+            break;
+        case LY_TYPE_UINT32:
+            view->type = SR_UINT32_T;
+            break;
+        case LY_TYPE_UINT64:
+            view->type = SR_UINT64_T;
+            break;
+        default:
+            SR_ERRINFO_INT(&err_info);
+            return err_info;
+        }
+
+        if (view->type != SR_LEAF_EMPTY_T) {
+            /* canonical value stored in the dictionary */
+            view->value = lyd_get_value(node);
+            view->value_len = strlen(view->value);
+        }
+        break;
+    case LYS_CONTAINER:
+        view->type = (node->schema->flags & LYS_PRESENCE) ? SR_CONTAINER_PRESENCE_T : SR_CONTAINER_T;
+        break;
+    case LYS_LIST:
+        view->type = SR_LIST_T;
+        break;
+    case LYS_NOTIF:
+        view->type = SR_NOTIFICATION_T;
+        break;
+    case LYS_ANYXML:
+    case LYS_ANYDATA:
+        view->type = (node->schema->nodetype == LYS_ANYXML) ? SR_ANYXML_T : SR_ANYDATA_T;
+
+        /* only string values can be borrowed, a data tree would need to be printed */
+        any = (const struct lyd_node_any *)node;
+        if (((any->value_type == LYD_ANYDATA_STRING) || (any->value_type == LYD_ANYDATA_XML) ||
+                (any->value_type == LYD_ANYDATA_JSON)) && any->value.str) {
+            view->value = any->value.str;
+            view->value_len = strlen(view->value);
+        }
+        break;
+    default:
+        SR_ERRINFO_INT(&err_info);
+        return err_info;
+    }
+
+    return NULL;
+}
+
+API int
+sr_tree_iter_values(const struct lyd_node *data, const char *xpath, sr_val_iter_t **iter)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *set = NULL;
+
+    SR_CHECK_ARG_APIRET(!data || !xpath || !iter, NULL, err_info);
+
+    *iter = NULL;
+
+    if (lyd_find_xpath(data, xpath, &set)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(data), NULL);
+        goto cleanup;
+    } else if (!set->count) {
+        /* Not building err_info to avoid error logs when no item found */
+        ly_set_free(set, NULL);
+        return SR_ERR_NOT_FOUND;
+    }
+
+    *iter = calloc(1, sizeof **iter);
+    SR_CHECK_MEM_GOTO(!*iter, err_info, cleanup);
+    (*iter)->set = set;
+    set = NULL;
+
+    /* success */
+cleanup:
+    ly_set_free(set, NULL);
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_val_iter_next(sr_val_iter_t *iter, const sr_val_view_t **view)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lyd_node *node;
+
+    SR_CHECK_ARG_APIRET(!iter || !view, NULL, err_info);
+
+    *view = NULL;
+
+    /* skip RPCs and actions, same as when converting to values */
+    do {
+        if (iter->idx == iter->set->count) {
+            /* no more nodes */
+            iter->view.node = NULL;
+            return SR_ERR_OK;
+        }
+        node = iter->set->dnodes[iter->idx++];
+    } while (node->schema->nodetype & (LYS_RPC | LYS_ACTION));
+
+    if ((err_info = sr_val_view_fill(node, &iter->view))) {
+        iter->view.node = NULL;
+        return sr_api_ret(NULL, err_info);
+    }
+
+    *view = &iter->view;
+    return SR_ERR_OK;
+}
+
+API const char *
+sr_val_iter_xpath(sr_val_iter_t *iter)
+{
+    char *path;
+
+    if (!iter || !iter->view.node) {
+        return NULL;
+    }
+
+    if (iter->path && lyd_path(iter->view.node, LYD_PATH_STD, iter->path, iter->path_size)) {
+        /* fits into the buffer */
+        return iter->path;
+    }
+
+    /* buffer too small, let the path be allocated and keep it as the new buffer */
+    path = lyd_path(iter->view.node, LYD_PATH_STD, NULL, 0);
+    if (!path) {
+        return NULL;
+    }
+
+    free(iter->path);
+    iter->path = path;
+    iter->path_size = strlen(path) + 1;
+    return iter->path;
+}
+
+API void
+sr_val_iter_free(sr_val_iter_t *iter)
+{
+    if (!iter) {
+        return;
+    }
+
+    ly_set_free(iter->set, NULL);
+    free(iter->path);
+    free(iter);
+}
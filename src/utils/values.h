@@ -211,6 +211,64 @@ int sr_tree_to_val(const struct lyd_node *data, const char *path, sr_val_t **val
  */
 int sr_tree_to_values(const struct lyd_node *data, const char *xpath, sr_val_t **values, size_t *value_cnt);
 
+/**
+ * @brief Lightweight view of a single data node, all the members are borrowed from the data tree.
+ *
+ * Valid only until the next ::sr_val_iter_next() call or until the data tree is freed or modified.
+ */
+typedef struct sr_val_view_s {
+    const struct lyd_node *node;    /**< Data node the view describes. */
+    sr_val_type_t type;             /**< Type of the value. */
+    int dflt;                       /**< Whether the node is a default node. */
+    const char *value;              /**< Canonical value of terminal nodes or the string value of anydata/anyxml
+                                         nodes, NULL if there is none. Owned by the data tree. */
+    size_t value_len;               /**< Length of @p value. */
+} sr_val_view_t;
+
+/**
+ * @brief Iterator over data nodes providing ::sr_val_view_t of each of them.
+ */
+typedef struct sr_val_iter_s sr_val_iter_t;
+
+/**
+ * @brief Create an iterator over nodes in a `struct lyd_node` type data tree without converting them to ::sr_val_t.
+ *
+ * Unlike ::sr_tree_to_values, no memory is allocated per node so it is suitable for reading large number
+ * of values from a data tree retrieved by ::sr_get_data.
+ *
+ * @param[in] data Root node of a data tree in which to search for the nodes.
+ * @param[in] xpath [XPath](@ref paths) of the data elements to iterate over.
+ * @param[out] iter Created iterator, free using ::sr_val_iter_free.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND if no nodes match the xpath).
+ */
+int sr_tree_iter_values(const struct lyd_node *data, const char *xpath, sr_val_iter_t **iter);
+
+/**
+ * @brief Move the iterator to the next node.
+ *
+ * @param[in] iter Iterator to use.
+ * @param[out] view View of the next node, NULL if there are no more nodes.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_val_iter_next(sr_val_iter_t *iter, const sr_val_view_t **view);
+
+/**
+ * @brief Get the path of the node of the current view.
+ *
+ * The path is generated only on demand into a buffer reused by the iterator.
+ *
+ * @param[in] iter Iterator to use.
+ * @return Path of the current node valid until the next ::sr_val_iter_next call, NULL on error.
+ */
+const char *sr_val_iter_xpath(sr_val_iter_t *iter);
+
+/**
+ * @brief Free an iterator.
+ *
+ * @param[in] iter Iterator to free.
+ */
+void sr_val_iter_free(sr_val_iter_t *iter);
+
 /**@} values */
 
 #ifdef __cplusplus
@@ -26,6 +26,7 @@
 #include "sysrepo.h"
 #include "config.h"
 #include "tests/test_common.h"
+#include "utils/values.h"
 
 #ifdef SR_HAVE_CALLGRIND
 # include <valgrind/callgrind.h>
@@ -488,6 +489,57 @@ test_get_tree_hash(struct test_state *state, struct timespec *ts_start, struct t
     return SR_ERR_OK;
 }
 
+static int
+test_get_items(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_val_t *vals;
+    size_t val_count;
+
+    TEST_START(ts_start);
+
+    if ((r = sr_get_items(state->sess, "/perf:cont/lst/l", 0, 0, &vals, &val_count))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_free_values(vals, val_count);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_get_items_view(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_data_t *data;
+    sr_val_iter_t *iter;
+    const sr_val_view_t *view;
+    size_t len = 0;
+
+    TEST_START(ts_start);
+
+    if ((r = sr_get_data(state->sess, "/perf:cont/lst/l", 0, 0, 0, &data))) {
+        return r;
+    }
+    if ((r = sr_tree_iter_values(data->tree, "/perf:cont/lst/l", &iter))) {
+        sr_release_data(data);
+        return r;
+    }
+    while (!(r = sr_val_iter_next(iter, &view)) && view) {
+        len += view->value_len;
+    }
+
+    TEST_END(ts_end);
+
+    (void)len;
+    sr_val_iter_free(iter);
+    sr_release_data(data);
+
+    return r;
+}
+
 static int
 test_edit_item_create(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
@@ -582,6 +634,8 @@ struct test tests[] = {
     { "get item", setup_running, test_get_item },
     { "get tree hash", setup_running, test_get_tree_hash },
     { "get tree hash cached", setup_running_cached, test_get_tree_hash },
+    { "get items", setup_running, test_get_items },
+    { "get items view", setup_running, test_get_items_view },
     { "edit item create", setup_subscribe_change_item, test_edit_item_create },
     { "edit batch create", setup_subscribe_change_tree, test_edit_batch_create },
     { "oper get tree", setup_subscribe_oper, test_oper_get_tree },
@@ -6807,6 +6807,959 @@ test_mult_update(void **state)
     sr_session_stop(sess);
 }
 
+/* TEST */
+static int
+module_pipelined_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_val_t *val = NULL;
+    int count, ret;
+
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+    assert_int_equal(event, SR_EV_DONE);
+
+    switch (ATOMIC_LOAD_RELAXED(st->cb_called)) {
+    case 0:
+        /* let the other change be applied */
+        pthread_barrier_wait(&st->barrier);
+
+        /* the module is not locked anymore so it gets stored while this event is still being processed */
+        count = 0;
+        do {
+            sr_free_val(val);
+            usleep(10000);
+            ret = sr_get_item(session, "/test:test-leaf", 0, &val);
+            assert_int_equal(ret, SR_ERR_OK);
+            ++count;
+        } while ((val->data.uint8_val != 2) && (count < 1500));
+        assert_int_equal(val->data.uint8_val, 2);
+        sr_free_val(val);
+
+        /* the second change was stored while the first one is still in progress, its caller waits for this event */
+        assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 0);
+        break;
+    case 1:
+        /* the second "done" event is generated only after the first one was processed */
+        ret = sr_get_item(session, "/test:test-leaf", 0, &val);
+        assert_int_equal(ret, SR_ERR_OK);
+        assert_int_equal(val->data.uint8_val, 2);
+        sr_free_val(val);
+        break;
+    default:
+        fail();
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void *
+apply_pipelined_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/test:test-leaf", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* wait until the first change is being processed */
+    pthread_barrier_wait(&st->barrier);
+
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_pipelined(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess;
+    pthread_t tid;
+    int ret;
+
+    ret = sr_connect(SR_CONN_PIPELINED_COMMIT, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_pipelined_cb, st, 0, SR_SUBSCR_DONE_ONLY, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ATOMIC_STORE_RELAXED(st->cb_called2, 0);
+    pthread_create(&tid, NULL, apply_pipelined_thread, *state);
+
+    /* apply the first change, the second one is applied during its "done" event */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ATOMIC_STORE_RELAXED(st->cb_called2, 1);
+
+    pthread_join(tid, NULL);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    sr_disconnect(conn);
+}
+
+/* TEST */
+static int
+module_apply_async_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+
+    switch (ATOMIC_LOAD_RELAXED(st->cb_called)) {
+    case 0:
+        assert_int_equal(event, SR_EV_CHANGE);
+        break;
+    case 1:
+        assert_int_equal(event, SR_EV_DONE);
+        break;
+    default:
+        fail();
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+apply_async_done_cb(sr_session_ctx_t *session, int err_code, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    assert_int_equal(err_code, SR_ERR_OK);
+    assert_int_equal(sr_has_changes(session), 0);
+
+    ATOMIC_INC_RELAXED(st->cb_called2);
+}
+
+static void
+apply_async_stop_cb(sr_session_ctx_t *session, int err_code, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    assert_int_equal(err_code, SR_ERR_OPERATION_FAILED);
+    assert_int_equal(sr_has_changes(session), 1);
+
+    ATOMIC_INC_RELAXED(st->cb_called2);
+}
+
+static void
+test_apply_async(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL, *apply_subscr = NULL;
+    sr_session_ctx_t *sess, *sess2;
+    sr_val_t *val;
+    int count, ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_apply_async_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* apply the changes in the thread of another subscription structure */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 0, apply_async_done_cb, st, 0, &apply_subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* wait for the completion */
+    count = 0;
+    while ((ATOMIC_LOAD_RELAXED(st->cb_called2) < 1) && (count < 1500)) {
+        usleep(10000);
+        ++count;
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 1);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    /* check the data */
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 5);
+    sr_free_val(val);
+
+    sr_unsubscribe(apply_subscr);
+    apply_subscr = NULL;
+    sr_unsubscribe(subscr);
+
+    /* a request never processed is failed once its session is stopped */
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/test:test-leaf", "6", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess2, 0, apply_async_stop_cb, st, SR_SUBSCR_NO_THREAD, &apply_subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_session_stop(sess2);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+
+    /* the subscription is no longer used by the session and processing it applies nothing */
+    ret = sr_subscription_process_events(apply_subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_unsubscribe(apply_subscr);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+static int
+module_resubscribe_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    ATOMIC_T *cb_called = private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+    if (event == SR_EV_CHANGE) {
+        ATOMIC_INC_RELAXED(*cb_called);
+    }
+
+    return SR_ERR_OK;
+}
+
+static void
+test_resubscribe(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_resubscribe_cb, &st->cb_called, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the sub SHMs of the subscription get cached by the connection */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+    assert_int_not_equal(st->conn->sub_shm_cache_count, 0);
+
+    /* the sub SHMs are unlinked and created again */
+    sr_unsubscribe(subscr);
+    subscr = NULL;
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_resubscribe_cb, &st->cb_called2, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the event must be written into the new sub SHM, not the cached unlinked one */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 1);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+static int
+module_group_commit_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+
+    if (event == SR_EV_CHANGE) {
+        if (!ATOMIC_LOAD_RELAXED(st->cb_called)) {
+            /* keep the first commit active until the other ones are waiting */
+            pthread_barrier_wait(&st->barrier);
+            pthread_barrier_wait(&st->barrier2);
+        }
+        ATOMIC_INC_RELAXED(st->cb_called);
+    } else {
+        assert_int_equal(event, SR_EV_DONE);
+        ATOMIC_INC_RELAXED(st->cb_called2);
+    }
+
+    return SR_ERR_OK;
+}
+
+struct group_commit_arg {
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    const char *key;
+    int ret;
+};
+
+static void *
+apply_group_commit_thread(void *arg)
+{
+    struct group_commit_arg *gc_arg = (struct group_commit_arg *)arg;
+    sr_session_ctx_t *sess;
+    char path[64];
+    int ret;
+
+    if (gc_arg->sess) {
+        sess = gc_arg->sess;
+    } else {
+        ret = sr_session_start(gc_arg->conn, SR_DS_RUNNING, &sess);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    sprintf(path, "/test:l1[k='%s']/v", gc_arg->key);
+    ret = sr_set_item_str(sess, path, "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, gc_arg->ret);
+    if (ret) {
+        ret = sr_discard_changes(sess);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    if (!gc_arg->sess) {
+        sr_session_stop(sess);
+    }
+    return NULL;
+}
+
+static void
+test_group_commit(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct group_commit_arg args[3];
+    sr_conn_ctx_t *conn;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess;
+    sr_val_t *vals;
+    size_t val_count;
+    pthread_t tid[3];
+    const char *keys[] = {"a", "b", "c"};
+    int i, ret;
+
+    ret = sr_connect(SR_CONN_GROUP_COMMIT, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_group_commit_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    for (i = 0; i < 3; ++i) {
+        args[i].conn = conn;
+        args[i].sess = NULL;
+        args[i].key = keys[i];
+        args[i].ret = SR_ERR_OK;
+    }
+
+    /* first commit */
+    pthread_create(&tid[0], NULL, apply_group_commit_thread, &args[0]);
+    pthread_barrier_wait(&st->barrier);
+
+    /* other commits are waiting for the first one */
+    pthread_create(&tid[1], NULL, apply_group_commit_thread, &args[1]);
+    pthread_create(&tid[2], NULL, apply_group_commit_thread, &args[2]);
+    usleep(200000);
+    pthread_barrier_wait(&st->barrier2);
+
+    for (i = 0; i < 3; ++i) {
+        pthread_join(tid[i], NULL);
+    }
+
+    /* the waiting commits were applied together */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+
+    ret = sr_get_items(sess, "/test:l1", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 3);
+    sr_free_values(vals, val_count);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:l1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    sr_disconnect(conn);
+}
+
+/* TEST */
+static int
+module_group_commit_reject_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_val_t *val;
+    int ret;
+
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+
+    if (event != SR_EV_CHANGE) {
+        return SR_ERR_OK;
+    }
+
+    if (!ATOMIC_LOAD_RELAXED(st->cb_called)) {
+        /* keep the first commit active until the other ones are waiting */
+        pthread_barrier_wait(&st->barrier);
+        pthread_barrier_wait(&st->barrier2);
+    }
+    ATOMIC_INC_RELAXED(st->cb_called);
+
+    /* reject only the change of one instance */
+    ret = sr_get_item(session, "/test:l1[k='b']/v", 0, &val);
+    if (ret == SR_ERR_OK) {
+        sr_free_val(val);
+        return SR_ERR_VALIDATION_FAILED;
+    }
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    return SR_ERR_OK;
+}
+
+static void
+test_group_commit_reject(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct group_commit_arg args[3];
+    sr_conn_ctx_t *conn;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess;
+    sr_val_t *vals;
+    size_t val_count;
+    pthread_t tid[3];
+    const char *keys[] = {"a", "b", "c"};
+    int i, ret;
+
+    ret = sr_connect(SR_CONN_GROUP_COMMIT, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_group_commit_reject_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    for (i = 0; i < 3; ++i) {
+        args[i].conn = conn;
+        args[i].sess = NULL;
+        args[i].key = keys[i];
+        args[i].ret = SR_ERR_OK;
+    }
+
+    /* the rejected change fails alone, the change applied together with it is applied again separately */
+    args[1].ret = SR_ERR_CALLBACK_FAILED;
+
+    /* first commit */
+    pthread_create(&tid[0], NULL, apply_group_commit_thread, &args[0]);
+    pthread_barrier_wait(&st->barrier);
+
+    /* other commits are waiting for the first one */
+    pthread_create(&tid[1], NULL, apply_group_commit_thread, &args[1]);
+    pthread_create(&tid[2], NULL, apply_group_commit_thread, &args[2]);
+    usleep(200000);
+    pthread_barrier_wait(&st->barrier2);
+
+    for (i = 0; i < 3; ++i) {
+        pthread_join(tid[i], NULL);
+    }
+
+    /* the first change, the joint change, and then both the changes separately */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 4);
+
+    ret = sr_get_items(sess, "/test:l1", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 2);
+    assert_string_equal(vals[0].xpath, "/test:l1[k='a']");
+    assert_string_equal(vals[1].xpath, "/test:l1[k='c']");
+    sr_free_values(vals, val_count);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:l1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    sr_disconnect(conn);
+}
+
+/* TEST */
+static int
+module_group_commit_ds_lock_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "ietf-interfaces");
+
+    if ((event == SR_EV_CHANGE) && !ATOMIC_LOAD_RELAXED(st->cb_called)) {
+        /* keep the first commit active until the other ones are waiting */
+        pthread_barrier_wait(&st->barrier);
+        pthread_barrier_wait(&st->barrier2);
+    }
+    ATOMIC_INC_RELAXED(st->cb_called);
+
+    return SR_ERR_OK;
+}
+
+static void *
+apply_group_commit_if_thread(void *arg)
+{
+    sr_conn_ctx_t *conn = (sr_conn_ctx_t *)arg;
+    sr_session_ctx_t *sess;
+    int ret;
+
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces/interface[name='eth0']/type", "iana-if-type:ethernetCsmacd",
+            NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_group_commit_ds_lock(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct group_commit_arg args[2];
+    sr_conn_ctx_t *conn;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess, *lock_sess;
+    sr_val_t *vals;
+    size_t val_count;
+    pthread_t tid[3];
+    int i, ret;
+
+    ret = sr_connect(SR_CONN_GROUP_COMMIT, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &lock_sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "ietf-interfaces", NULL, module_group_commit_ds_lock_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* only the locking session may modify the module */
+    ret = sr_lock(lock_sess, "test", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* first commit of another module */
+    pthread_create(&tid[0], NULL, apply_group_commit_if_thread, conn);
+    pthread_barrier_wait(&st->barrier);
+
+    /* the commit of the locking session is waiting first so it is the originator of the group */
+    args[0].conn = conn;
+    args[0].sess = lock_sess;
+    args[0].key = "a";
+    args[0].ret = SR_ERR_OK;
+    pthread_create(&tid[1], NULL, apply_group_commit_thread, &args[0]);
+    usleep(100000);
+
+    /* the other session cannot modify the DS-locked module even when committing together with the locking session */
+    args[1].conn = conn;
+    args[1].sess = NULL;
+    args[1].key = "b";
+    args[1].ret = SR_ERR_LOCKED;
+    pthread_create(&tid[2], NULL, apply_group_commit_thread, &args[1]);
+    usleep(200000);
+    pthread_barrier_wait(&st->barrier2);
+
+    for (i = 0; i < 3; ++i) {
+        pthread_join(tid[i], NULL);
+    }
+
+    ret = sr_get_items(sess, "/test:l1", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    assert_string_equal(vals[0].xpath, "/test:l1[k='a']");
+    sr_free_values(vals, val_count);
+
+    ret = sr_unlock(lock_sess, "test");
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:l1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/ietf-interfaces:interfaces", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(lock_sess);
+    sr_session_stop(sess);
+    sr_disconnect(conn);
+}
+
+/* TEST */
+static int
+module_entry_lock_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+
+    if (event == SR_EV_CHANGE) {
+        if (!ATOMIC_LOAD_RELAXED(st->cb_called)) {
+            /* keep the first change in its callback until the other one is prepared */
+            pthread_barrier_wait(&st->barrier);
+            pthread_barrier_wait(&st->barrier2);
+        }
+        ATOMIC_INC_RELAXED(st->cb_called);
+    } else {
+        assert_int_equal(event, SR_EV_DONE);
+        ATOMIC_INC_RELAXED(st->cb_called2);
+    }
+
+    return SR_ERR_OK;
+}
+
+static void *
+apply_entry_lock_thread(void *arg)
+{
+    struct group_commit_arg *el_arg = (struct group_commit_arg *)arg;
+    sr_session_ctx_t *sess;
+    char path[64];
+    int ret;
+
+    ret = sr_session_start(el_arg->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sprintf(path, "/test:l3[k='%s']", el_arg->key);
+    ret = sr_set_item_str(sess, path, NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static uint32_t
+entry_lock_stripe(sr_conn_ctx_t *conn, const char *key)
+{
+    struct lyd_node *node;
+    char path[64];
+    uint32_t stripe;
+
+    sprintf(path, "/test:l3[k='%s']", key);
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, sr_acquire_context(conn), path, NULL, 0, &node));
+    stripe = node->hash % SR_MOD_ENTRY_LOCK_COUNT;
+    lyd_free_tree(node);
+    sr_release_context(conn);
+
+    return stripe;
+}
+
+static int
+entry_lock_is_read_locked(sr_session_ctx_t *sess, sr_cid_t cid)
+{
+    sr_data_t *data;
+    struct ly_set *set;
+    char xpath[256];
+    int ret, found;
+
+    sprintf(xpath, "/sysrepo-monitoring:sysrepo-state/module[name='test']/data-lock[cid='%" PRIu32 "']"
+            "[datastore='ietf-datastores:running'][mode='read']", cid);
+    ret = sr_get_data(sess, xpath, 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    if (!data) {
+        return 0;
+    }
+
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(data->tree, xpath, &set));
+    found = set->count;
+    ly_set_free(set, NULL);
+    sr_release_data(data);
+
+    return found;
+}
+
+static void
+test_entry_lock(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct group_commit_arg args[2];
+    sr_conn_ctx_t *conn, *conn2;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess;
+    sr_val_t *vals;
+    size_t val_count;
+    pthread_t tid[2];
+    const char *keys[] = {"a", "b", "c", "d", "e", "f", "g", "h"};
+    uint32_t i;
+    int count, ret;
+
+    ret = sr_connect(SR_CONN_ENTRY_LOCK, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_connect(SR_CONN_ENTRY_LOCK, &conn2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_entry_lock_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* instances of a list that is not ordered by user in different lock stripes */
+    for (i = 1; (i < sizeof keys / sizeof *keys) && (entry_lock_stripe(conn, keys[i]) == entry_lock_stripe(conn, keys[0]));
+            ++i) {}
+    assert_true(i < sizeof keys / sizeof *keys);
+
+    args[0].conn = conn;
+    args[0].key = keys[0];
+    args[1].conn = conn2;
+    args[1].key = keys[i];
+
+    /* the first change is in its callback */
+    pthread_create(&tid[0], NULL, apply_entry_lock_thread, &args[0]);
+    pthread_barrier_wait(&st->barrier);
+
+    /* the change of another instance is prepared meanwhile, holding the module READ lock as well */
+    pthread_create(&tid[1], NULL, apply_entry_lock_thread, &args[1]);
+    count = 0;
+    while (!entry_lock_is_read_locked(sess, conn2->cid) && (count < 1500)) {
+        usleep(10000);
+        ++count;
+    }
+    assert_true(entry_lock_is_read_locked(sess, conn2->cid));
+    pthread_barrier_wait(&st->barrier2);
+
+    pthread_join(tid[0], NULL);
+    pthread_join(tid[1], NULL);
+
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+
+    /* both changes were stored */
+    ret = sr_get_items(sess, "/test:l3", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 2);
+    sr_free_values(vals, val_count);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:l3", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    sr_disconnect(conn2);
+    sr_disconnect(conn);
+}
+
+/* TEST */
+static int
+lazy_diff_is_parsed(sr_session_ctx_t *session, const char *path)
+{
+    struct lyd_node *diff = session->dt[SR_DS_RUNNING].diff;
+
+    return diff && !lyd_find_path(diff, path, 0, NULL);
+}
+
+static int
+module_change_lazy_diff_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_change_oper_t op;
+    sr_change_iter_t *iter;
+    const struct lyd_node *node;
+    const char *prev_val, *prev_list;
+    int ret, prev_dflt, count;
+
+    (void)sub_id;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+    assert_string_equal(xpath, "/test:cont");
+    if (event != SR_EV_CHANGE) {
+        return SR_ERR_OK;
+    }
+
+    /* only the subtree of the subscription was parsed */
+    assert_non_null(session->ev_diff.idx);
+    assert_true(lazy_diff_is_parsed(session, "/test:cont"));
+    assert_false(lazy_diff_is_parsed(session, "/test:l1[k='lazy']"));
+
+    if (ATOMIC_LOAD_RELAXED(st->cb_called)) {
+        /* an XPath with an axis may leave the subtree, everything is parsed */
+        ret = sr_get_changes_iter(session, "/test:cont/descendant-or-self::*", &iter);
+        assert_int_equal(ret, SR_ERR_OK);
+        count = 0;
+        while (!sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt)) {
+            assert_int_equal(op, SR_OP_MODIFIED);
+            ++count;
+        }
+        sr_free_change_iter(iter);
+        assert_int_equal(count, 1);
+        assert_null(session->ev_diff.idx);
+        assert_true(lazy_diff_is_parsed(session, "/test:l1[k='lazy']"));
+
+        ATOMIC_INC_RELAXED(st->cb_called);
+        return SR_ERR_OK;
+    }
+
+    /* changes of the subscription */
+    ret = sr_get_changes_iter(session, "/test:cont//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    count = 0;
+    while (!sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt)) {
+        assert_int_equal(op, SR_OP_CREATED);
+        ++count;
+    }
+    sr_free_change_iter(iter);
+    assert_int_equal(count, 3);
+    assert_false(lazy_diff_is_parsed(session, "/test:l1[k='lazy']"));
+
+    /* changes of another subtree are parsed on demand */
+    ret = sr_get_changes_iter(session, "/test:l1//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_true(lazy_diff_is_parsed(session, "/test:l1[k='lazy']"));
+    count = 0;
+    while (!sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt)) {
+        assert_int_equal(op, SR_OP_CREATED);
+        ++count;
+    }
+    sr_free_change_iter(iter);
+    assert_int_equal(count, 3);
+
+    /* changes of a non-existent subtree */
+    ret = sr_get_changes_iter(session, "/test:l3//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    sr_free_change_iter(iter);
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_change_lazy_diff(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess;
+    int ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", "/test:cont", module_change_lazy_diff_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change several top-level subtrees */
+    ret = sr_set_item_str(sess, "/test:l1[k='lazy']/v", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/test:cont/l2[k='lazy']/v", "20", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+
+    /* modify them */
+    ret = sr_set_item_str(sess, "/test:l1[k='lazy']/v", "11", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/test:cont/l2[k='lazy']/v", "21", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:l1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/test:cont", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
 /* MAIN */
 int
 main(void)
@@ -6835,6 +7788,14 @@ main(void)
         cmocka_unit_test_setup_teardown(test_change_enabled, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_schema_mount, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_mult_update, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_pipelined, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_apply_async, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_resubscribe, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_group_commit, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_group_commit_reject, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_group_commit_ds_lock, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_entry_lock, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_lazy_diff, setup_f, teardown_f),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
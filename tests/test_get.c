@@ -30,6 +30,7 @@
 
 #include "sysrepo.h"
 #include "tests/tcommon.h"
+#include "utils/values.h"
 
 struct state {
     sr_conn_ctx_t *conn;
@@ -552,6 +553,162 @@ test_key(void **state)
     sr_apply_changes(st->sess, 0);
 }
 
+/* TEST */
+static void
+test_iter_values(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_val_iter_t *iter;
+    const sr_val_view_t *view;
+    int ret;
+
+    /* set some configuration data */
+    ret = sr_set_item_str(st->sess, "/defaults:l1[k='val']/cont1/ll", "text", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/defaults:l1[k='val2']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(st->sess, "/defaults:l1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* no matching nodes */
+    ret = sr_tree_iter_values(data->tree, "/defaults:l1[k='none']", &iter);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* iterate over all the nodes of the first instance */
+    ret = sr_tree_iter_values(data->tree, "/defaults:l1[k='val']//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_val_iter_next(iter, &view);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(view);
+    assert_int_equal(view->type, SR_LIST_T);
+    assert_null(view->value);
+    assert_string_equal(sr_val_iter_xpath(iter), "/defaults:l1[k='val']");
+
+    ret = sr_val_iter_next(iter, &view);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(view->type, SR_STRING_T);
+    assert_string_equal(view->value, "val");
+    assert_int_equal(view->value_len, 3);
+    assert_int_equal(view->dflt, 0);
+    assert_string_equal(sr_val_iter_xpath(iter), "/defaults:l1[k='val']/k");
+
+    ret = sr_val_iter_next(iter, &view);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(view->type, SR_CONTAINER_T);
+    assert_string_equal(sr_val_iter_xpath(iter), "/defaults:l1[k='val']/cont1");
+
+    ret = sr_val_iter_next(iter, &view);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(view->type, SR_CONTAINER_T);
+    assert_string_equal(sr_val_iter_xpath(iter), "/defaults:l1[k='val']/cont1/cont2");
+
+    ret = sr_val_iter_next(iter, &view);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(view->type, SR_UINT8_T);
+    assert_string_equal(view->value, "10");
+    assert_int_equal(view->dflt, 1);
+    assert_string_equal(sr_val_iter_xpath(iter), "/defaults:l1[k='val']/cont1/cont2/dflt1");
+
+    ret = sr_val_iter_next(iter, &view);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(view->type, SR_STRING_T);
+    assert_string_equal(view->value, "text");
+    assert_string_equal(sr_val_iter_xpath(iter), "/defaults:l1[k='val']/cont1/ll");
+
+    ret = sr_val_iter_next(iter, &view);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(view);
+    assert_null(sr_val_iter_xpath(iter));
+
+    sr_val_iter_free(iter);
+    sr_release_data(data);
+
+    /* cleanup */
+    sr_delete_item(st->sess, "/defaults:l1", 0);
+    sr_apply_changes(st->sess, 0);
+}
+
+static int
+chunk_cb(sr_session_ctx_t *session, const struct lyd_node *chunk, void *private_data)
+{
+    uint32_t *chunk_count = private_data;
+    const struct lyd_node *iter;
+    uint32_t count = 0;
+
+    (void)session;
+
+    /* only complete top-level trees */
+    LY_LIST_FOR(chunk, iter) {
+        assert_null(iter->parent);
+        ++count;
+    }
+    assert_true(count);
+
+    if (*chunk_count == UINT32_MAX) {
+        return SR_ERR_OPERATION_FAILED;
+    }
+
+    *chunk_count += count;
+    return SR_ERR_OK;
+}
+
+/* TEST */
+static void
+test_get_data_chunks(void **state)
+{
+    struct state *st = (struct state *)*state;
+    uint32_t count;
+    int ret;
+
+    /* set some configuration data */
+    ret = sr_set_item_str(st->sess, "/defaults:l1[k='a']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/defaults:l1[k='b']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/defaults:l1[k='c']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* each instance separately */
+    count = 0;
+    ret = sr_get_data_chunks(st->sess, "/defaults:l1", 0, 1, 0, 0, chunk_cb, &count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(count, 3);
+
+    /* several descendants of one top-level tree are in a single chunk */
+    count = 0;
+    ret = sr_get_data_chunks(st->sess, "/defaults:l1[k='a']//.", 0, 1, 0, 0, chunk_cb, &count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(count, 1);
+
+    /* larger chunks */
+    count = 0;
+    ret = sr_get_data_chunks(st->sess, "/defaults:l1", 0, 2, 0, 0, chunk_cb, &count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(count, 3);
+
+    /* no data */
+    count = 0;
+    ret = sr_get_data_chunks(st->sess, "/defaults:l2", 0, 0, 0, 0, chunk_cb, &count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(count, 0);
+
+    /* callback failure */
+    count = UINT32_MAX;
+    ret = sr_get_data_chunks(st->sess, "/defaults:l1", 0, 1, 0, 0, chunk_cb, &count);
+    assert_int_equal(ret, SR_ERR_CALLBACK_FAILED);
+
+    /* cleanup */
+    sr_delete_item(st->sess, "/defaults:l1", 0);
+    sr_apply_changes(st->sess, 0);
+}
+
 int
 main(void)
 {
@@ -565,6 +722,8 @@ main(void)
         cmocka_unit_test_setup_teardown(test_explicit_default, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_union, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_key, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_iter_values, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_get_data_chunks, setup_f, teardown_f),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
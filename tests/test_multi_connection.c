@@ -17,6 +17,7 @@
 #define _GNU_SOURCE
 
 #include <pthread.h>
+#include <sched.h>
 #include <setjmp.h>
 #include <stdarg.h>
 #include <stdlib.h>
@@ -26,6 +27,8 @@
 #include <cmocka.h>
 #include <libyang/libyang.h>
 
+#include "common.h"
+#include "shm_mod.h"
 #include "sysrepo.h"
 #include "tests/tcommon.h"
 
@@ -37,6 +40,7 @@ struct state {
     sr_session_ctx_t *sess2;
     sr_session_ctx_t *sess3;
     pthread_barrier_t barrier;
+    pthread_barrier_t barrier2;
 };
 
 static int
@@ -189,12 +193,310 @@ test_new(void **state)
     pthread_barrier_destroy(&st->barrier);
 }
 
+static void
+test_shared_ctx(void **state)
+{
+    sr_conn_ctx_t *conn1, *conn2;
+    sr_session_ctx_t *sess;
+    const struct ly_ctx *ly_ctx1, *ly_ctx2;
+    sr_data_t *data;
+    int ret;
+
+    (void)state;
+
+    ret = sr_connect(SR_CONN_CTX_SHARED, &conn1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_connect(SR_CONN_CTX_SHARED, &conn2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* both connections use the same context */
+    ly_ctx1 = sr_acquire_context(conn1);
+    sr_release_context(conn1);
+    ly_ctx2 = sr_acquire_context(conn2);
+    sr_release_context(conn2);
+    assert_ptr_equal(ly_ctx1, ly_ctx2);
+
+    /* change the context using one of them */
+    ret = sr_install_module(conn1, TESTS_SRC_DIR "/files/mod1.yang", TESTS_SRC_DIR "/files", NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the other connection must use the new context */
+    ly_ctx1 = sr_acquire_context(conn1);
+    sr_release_context(conn1);
+    ly_ctx2 = sr_acquire_context(conn2);
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx2, "mod1"));
+    sr_release_context(conn2);
+    assert_ptr_equal(ly_ctx1, ly_ctx2);
+
+    /* data can still be worked with */
+    ret = sr_session_start(conn2, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(sess, "/mod1:*", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_release_data(data);
+    sr_session_stop(sess);
+
+    /* ext data searchdir cannot be set */
+    ret = sr_set_ext_data_searchdir(conn2, TESTS_SRC_DIR "/files");
+    assert_int_equal(ret, SR_ERR_UNSUPPORTED);
+
+    ret = sr_remove_module(conn1, "mod1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_disconnect(conn1);
+    sr_disconnect(conn2);
+}
+
+/**
+ * @brief Wait until a writer with writer preference is waiting for the data lock of a module.
+ */
+static void
+writer_pref_wait_pending(sr_conn_ctx_t *conn, const char *module_name, sr_datastore_t ds)
+{
+    sr_mod_t *shm_mod;
+    volatile sr_cid_t *wr_pending = NULL;
+    uint32_t i;
+
+    for (i = 0; i < SR_CONN_MOD_SHM(conn)->mod_count; ++i) {
+        shm_mod = SR_SHM_MOD_IDX(conn->mod_shm.addr, i);
+        if (!strcmp(conn->mod_shm.addr + shm_mod->name, module_name)) {
+            wr_pending = &shm_mod->data_lock_info[ds].data_lock.wr_pending;
+            break;
+        }
+    }
+    assert_non_null(wr_pending);
+
+    while (!*wr_pending) {
+        sched_yield();
+    }
+}
+
+static int
+writer_pref_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    static int called = 0;
+
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+    (void)parent;
+
+    if (!called) {
+        called = 1;
+
+        /* the first reader is holding the data lock, keep holding it until the writer is waiting */
+        pthread_barrier_wait(&st->barrier);
+        pthread_barrier_wait(&st->barrier2);
+    }
+
+    return SR_ERR_OK;
+}
+
+static void *
+writer_pref_read_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    sr_data_t *data;
+    int ret;
+
+    ret = sr_session_start(st->conn2, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read data and hold the data lock while the callback is executing */
+    ret = sr_get_data(sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_release_data(data);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void *
+writer_pref_write_thread(void *arg)
+{
+    sr_session_ctx_t *sess = arg;
+    int ret;
+
+    /* wait for the first reader to release the data lock */
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces-state/interface[name='eth-wp']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    return NULL;
+}
+
+static void *
+writer_pref_new_read_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    sr_data_t *data;
+    int ret;
+
+    ret = sr_session_start(st->conn3, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the writer is already waiting so the new reader must wait for it and read its changes */
+    ret = sr_get_data(sess, "/ietf-interfaces:interfaces-state/interface[name='eth-wp']", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_non_null(data->tree);
+    sr_release_data(data);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_writer_pref(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    pthread_t tid[3];
+    int ret;
+
+    ret = sr_connect(SR_CONN_DATA_LOCK_WRITER_PREF, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    pthread_barrier_init(&st->barrier, NULL, 2);
+    pthread_barrier_init(&st->barrier2, NULL, 2);
+
+    ret = sr_oper_get_subscribe(st->sess1, "ietf-interfaces", "/ietf-interfaces:interfaces-state", writer_pref_oper_cb,
+            st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* first reader holds the data lock */
+    pthread_create(&tid[0], NULL, writer_pref_read_thread, st);
+    pthread_barrier_wait(&st->barrier);
+
+    /* writer with writer preference waits for it */
+    pthread_create(&tid[1], NULL, writer_pref_write_thread, sess);
+    writer_pref_wait_pending(conn, "ietf-interfaces", SR_DS_OPERATIONAL);
+
+    /* new reader, then let the first reader finish */
+    pthread_create(&tid[2], NULL, writer_pref_new_read_thread, st);
+    pthread_barrier_wait(&st->barrier2);
+
+    pthread_join(tid[0], NULL);
+    pthread_join(tid[1], NULL);
+    pthread_join(tid[2], NULL);
+
+    sr_unsubscribe(subscr);
+    pthread_barrier_destroy(&st->barrier);
+    pthread_barrier_destroy(&st->barrier2);
+
+    /* stored operational data are removed */
+    sr_disconnect(conn);
+}
+
+static int
+writer_pref_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_data_t *data;
+    int ret;
+
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    if (event != SR_EV_CHANGE) {
+        return SR_ERR_OK;
+    }
+
+    /* the commit is holding the data lock, wait for the writer */
+    pthread_barrier_wait(&st->barrier);
+    writer_pref_wait_pending(sr_session_get_connection(session), "test", SR_DS_RUNNING);
+
+    /* the callback must be able to read the data even though the writer is waiting for the commit */
+    ret = sr_get_data(session, "/test:test-leaf", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_release_data(data);
+
+    return SR_ERR_OK;
+}
+
+static void *
+writer_pref_commit_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    int ret;
+
+    ret = sr_set_item_str(st->sess1, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    return NULL;
+}
+
+static void
+test_writer_pref_event(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    pthread_t tid;
+    int ret;
+
+    ret = sr_connect(SR_CONN_DATA_LOCK_WRITER_PREF, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    pthread_barrier_init(&st->barrier, NULL, 2);
+
+    ret = sr_module_change_subscribe(st->sess2, "test", NULL, writer_pref_change_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* commit is in its "change" event */
+    pthread_create(&tid, NULL, writer_pref_commit_thread, st);
+    pthread_barrier_wait(&st->barrier);
+
+    /* writer with writer preference waits for the commit, which waits for the callback reading the data */
+    ret = sr_lock(sess, "test", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_unlock(sess, "test");
+    assert_int_equal(ret, SR_ERR_OK);
+
+    pthread_join(tid, NULL);
+
+    sr_unsubscribe(subscr);
+    pthread_barrier_destroy(&st->barrier);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess1, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_disconnect(conn);
+}
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_teardown(test_create1, clear_interfaces),
         cmocka_unit_test(test_new),
+        cmocka_unit_test(test_shared_ctx),
+        cmocka_unit_test(test_writer_pref),
+        cmocka_unit_test(test_writer_pref_event),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
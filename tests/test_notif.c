@@ -1555,6 +1555,197 @@ test_wait(void **state)
     sr_unsubscribe(subscr);
 }
 
+/* TEST */
+static void
+notif_queue_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type, const char *xpath,
+        const sr_val_t *values, const size_t values_cnt, struct timespec *timestamp, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)values;
+    (void)values_cnt;
+    (void)timestamp;
+
+    if (notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        return;
+    }
+
+    assert_int_equal(notif_type, SR_EV_NOTIF_REALTIME);
+    assert_string_equal(xpath, "/ops:notif4");
+
+    /* slow subscriber */
+    usleep(5000);
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+}
+
+static void
+test_queue(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* blocking subscriber, all the notifications must be delivered */
+    ret = sr_notif_subscribe(st->sess, "ops", NULL, NULL, NULL, notif_queue_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* send more notifications than there are slots without waiting */
+    for (i = 0; i < 40; ++i) {
+        ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    /* wait for all of them to be processed */
+    for (i = 0; (i < 100) && (ATOMIC_LOAD_RELAXED(st->cb_called) < 40); ++i) {
+        usleep(10000);
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 40);
+
+    sr_unsubscribe(subscr);
+    subscr = NULL;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* dropping subscriber, the sender never waits for it */
+    ret = sr_notif_subscribe(st->sess, "ops", NULL, NULL, NULL, notif_queue_cb, st, SR_SUBSCR_NOTIF_DROP, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    for (i = 0; i < 40; ++i) {
+        ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    /* some notifications may have been dropped, but at least the last ones are processed */
+    for (i = 0; (i < 100) && (ATOMIC_LOAD_RELAXED(st->cb_called) < SR_NOTIF_SUB_SLOT_COUNT); ++i) {
+        usleep(10000);
+    }
+    assert_true(ATOMIC_LOAD_RELAXED(st->cb_called) >= SR_NOTIF_SUB_SLOT_COUNT);
+    assert_true(ATOMIC_LOAD_RELAXED(st->cb_called) <= 40);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static void
+notif_batch_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_notif_batch_item_t *items, uint32_t item_count,
+        void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    uint32_t i;
+
+    (void)session;
+    (void)sub_id;
+
+    if (items[0].notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        assert_int_equal(item_count, 1);
+        return;
+    }
+
+    /* never more than the batch size */
+    assert_true(item_count <= 4);
+    for (i = 0; i < item_count; ++i) {
+        assert_int_equal(items[i].notif_type, SR_EV_NOTIF_REALTIME);
+        assert_string_equal(LYD_NAME(items[i].notif), "notif4");
+        if (i) {
+            assert_true((items[i - 1].timestamp.tv_sec < items[i].timestamp.tv_sec) ||
+                    ((items[i - 1].timestamp.tv_sec == items[i].timestamp.tv_sec) &&
+                    (items[i - 1].timestamp.tv_nsec <= items[i].timestamp.tv_nsec)));
+        }
+    }
+
+    ATOMIC_ADD_RELAXED(st->cb_called, item_count);
+}
+
+static void
+test_batch(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* batches of at most 4 notifications, each delivered in 100 ms at the latest */
+    ret = sr_notif_subscribe_tree_batch(st->sess, "ops", NULL, NULL, NULL, 4, 100000, notif_batch_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* send notifications without waiting */
+    for (i = 0; i < 10; ++i) {
+        ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    /* wait for all of them to be delivered, the last batch is not full */
+    for (i = 0; (i < 100) && (ATOMIC_LOAD_RELAXED(st->cb_called) < 10); ++i) {
+        usleep(10000);
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 10);
+
+    /* waiting for a notification to be delivered works, too */
+    ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 11);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static void
+test_backlog(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess;
+    sr_data_t *data;
+    int i, ret;
+
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_notif_subscribe(st->sess, "ops", NULL, NULL, NULL, notif_dummy_cb, NULL, SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* send notifications that are not processed */
+    for (i = 0; i < 3; ++i) {
+        ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    /* all of them are in the backlog */
+    ret = sr_get_node(sess, "/sysrepo-monitoring:sysrepo-state/module[name='ops']/subscriptions/notification-sub/"
+            "backlog/queue-depth", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "3");
+    sr_release_data(data);
+
+    /* process them */
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* backlog empty */
+    ret = sr_get_node(sess, "/sysrepo-monitoring:sysrepo-state/module[name='ops']/subscriptions/notification-sub/"
+            "backlog/queue-depth", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "0");
+    sr_release_data(data);
+
+    ret = sr_get_node(sess, "/sysrepo-monitoring:sysrepo-state/module[name='ops']/subscriptions/notification-sub/"
+            "backlog/lag", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "0");
+    sr_release_data(data);
+
+    sr_unsubscribe(subscr);
+    sr_session_stop(sess);
+}
+
 /* TEST */
 static LY_ERR
 ly_ext_data_cb(const struct lysc_ext_instance *ext, void *user_data, void **ext_data, ly_bool *ext_data_free)
@@ -1798,6 +1989,91 @@ test_schema_mount(void **state)
     sr_unsubscribe(sub);
 }
 
+/* TEST */
+static void
+notif_xpath_snodes_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
+        const struct lyd_node *notif, struct timespec *timestamp, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)timestamp;
+
+    if (notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        return;
+    }
+
+    assert_int_equal(notif_type, SR_EV_NOTIF_REALTIME);
+    assert_string_equal(notif->schema->name, "notif4");
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+}
+
+static void
+test_xpath_snodes(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct lyd_node *notif;
+    const char *module_name, *xpath;
+    struct timespec start, stop;
+    uint32_t sub_id[3], filtered_out;
+    int ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* another notification, filtered out only based on the schema nodes */
+    ret = sr_notif_subscribe_tree(st->sess, "ops", "/ops:notif3", NULL, NULL, notif_xpath_snodes_cb, st,
+            SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    sub_id[0] = sr_subscription_get_last_sub_id(subscr);
+
+    /* no predicates, always matches based on the schema nodes */
+    ret = sr_notif_subscribe_tree(st->sess, "ops", "/ops:notif3 | /ops:notif4", NULL, NULL, notif_xpath_snodes_cb, st,
+            SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    sub_id[1] = sr_subscription_get_last_sub_id(subscr);
+
+    /* a union with a predicate, always evaluated */
+    ret = sr_notif_subscribe_tree(st->sess, "ops", "/ops:notif3 | /ops:notif4[l='a']", NULL, NULL,
+            notif_xpath_snodes_cb, st, SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    sub_id[2] = sr_subscription_get_last_sub_id(subscr);
+
+    /* send and process a notification matching only the second subscription */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:notif4/l", "b", 0, &notif));
+    ret = sr_notif_send_tree(st->sess, notif, 0, 0);
+    lyd_free_tree(notif);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+
+    /* send and process a notification matching the second and the third subscription */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:notif4/l", "a", 0, &notif));
+    ret = sr_notif_send_tree(st->sess, notif, 0, 0);
+    lyd_free_tree(notif);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 3);
+
+    /* check the filtered notifications */
+    ret = sr_notif_sub_get_info(subscr, sub_id[0], &module_name, &xpath, &start, &stop, &filtered_out);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(filtered_out, 2);
+    ret = sr_notif_sub_get_info(subscr, sub_id[1], &module_name, &xpath, &start, &stop, &filtered_out);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(filtered_out, 0);
+    ret = sr_notif_sub_get_info(subscr, sub_id[2], &module_name, &xpath, &start, &stop, &filtered_out);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(filtered_out, 1);
+
+    sr_unsubscribe(subscr);
+}
+
 /* MAIN */
 int
 main(void)
@@ -1815,7 +2091,11 @@ main(void)
         cmocka_unit_test(test_params),
         cmocka_unit_test(test_dup_inst),
         cmocka_unit_test(test_wait),
+        cmocka_unit_test(test_queue),
+        cmocka_unit_test(test_batch),
+        cmocka_unit_test(test_backlog),
         cmocka_unit_test(test_schema_mount),
+        cmocka_unit_test(test_xpath_snodes),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
@@ -228,6 +228,42 @@ sr_str_del(char *input, const char *open, const char *close)
     free(resp);
 }
 
+/**
+ * @brief Check and remove all the lock statistics and subscription latencies from sysrepo-monitoring data,
+ * their values are not deterministic.
+ *
+ * @param[in] tree sysrepo-monitoring data.
+ */
+static void
+sr_srmon_stats_del(struct lyd_node *tree)
+{
+    struct ly_set *set;
+    uint32_t i;
+    int ret;
+
+    /* this module is being read so it must have been read-locked */
+    ret = lyd_find_xpath(tree, "/sysrepo-monitoring:sysrepo-state/module[name='sysrepo-monitoring']/"
+            "data-lock-stats[datastore='ietf-datastores:operational']/read-count", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_equal(set->count, 1);
+    assert_int_not_equal(strtoull(lyd_get_value(set->dnodes[0]), NULL, 10), 0);
+    ly_set_free(set, NULL);
+
+    ret = lyd_find_xpath(tree, "/sysrepo-monitoring:sysrepo-state/module/data-lock-stats | "
+            "/sysrepo-monitoring:sysrepo-state/module/change-sub-lock-stats | "
+            "/sysrepo-monitoring:sysrepo-state/module/oper-get-sub-lock-stats | "
+            "/sysrepo-monitoring:sysrepo-state/module/oper-poll-sub-lock-stats | "
+            "/sysrepo-monitoring:sysrepo-state/module/notif-sub-lock-stats | "
+            "/sysrepo-monitoring:sysrepo-state/module/subscriptions/change-sub/latency | "
+            "/sysrepo-monitoring:sysrepo-state/module/subscriptions/notification-sub/backlog | "
+            "/sysrepo-monitoring:sysrepo-state/rpc/sub-lock-stats", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    for (i = 0; i < set->count; ++i) {
+        lyd_free_tree(set->dnodes[i]);
+    }
+    ly_set_free(set, NULL);
+}
+
 /* TEST */
 static int
 yang_lib_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
@@ -377,6 +413,7 @@ test_sr_mon(void **state)
     assert_int_equal(ret, SR_ERR_OK);
 
     /* check their content */
+    sr_srmon_stats_del(data->tree);
     ret = lyd_print_mem(&str1, data->tree, LYD_XML, LYD_PRINT_SHRINK);
     assert_int_equal(ret, 0);
     sr_release_data(data);
@@ -621,6 +658,7 @@ test_sr_mon(void **state)
     assert_int_equal(ret, SR_ERR_OK);
 
     /* check their content */
+    sr_srmon_stats_del(data->tree);
     ret = lyd_print_mem(&str1, data->tree, LYD_XML, LYD_PRINT_SHRINK);
     assert_int_equal(ret, 0);
     sr_release_data(data);
@@ -959,6 +997,157 @@ test_sr_mon(void **state)
     free(str2);
 }
 
+/* TEST */
+static void
+test_lock_stats(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_data_t *data;
+    struct ly_set *set;
+    char *xpath;
+    int ret;
+
+    ret = sr_lock_stats_subscribe(st->sess, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read some data so that the module is locked */
+    ret = sr_get_data(st->sess, "/ietf-interfaces:*", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_release_data(data);
+
+    /* get the statistics */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = asprintf(&xpath, "/sysrepo-monitoring:sysrepo-state/connection[cid='%" PRIu32 "']/lock-site", st->conn->cid);
+    assert_int_not_equal(ret, -1);
+    ret = sr_get_data(st->sess, xpath, 0, 0, 0, &data);
+    free(xpath);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* module data lock was both waited for and held */
+    ret = lyd_find_xpath(data->tree, "/sysrepo-monitoring:sysrepo-state/connection/lock-site[function='sr_shmmod_lock']/"
+            "wait-time/bucket | /sysrepo-monitoring:sysrepo-state/connection/lock-site[function='sr_shmmod_lock']/"
+            "hold-time/bucket", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_not_equal(set->count, 0);
+    ly_set_free(set, NULL);
+    sr_release_data(data);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static int
+latency_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+    (void)private_data;
+
+    if (event == SR_EV_CHANGE) {
+        /* take some time */
+        usleep(20000);
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Get a change subscription latency statistic from sysrepo-monitoring data.
+ *
+ * @param[in] sess Session to use.
+ * @param[in] name Name of the latency leaf.
+ * @return Value of the leaf.
+ */
+static uint64_t
+latency_get(sr_session_ctx_t *sess, const char *name)
+{
+    sr_data_t *data;
+    struct ly_set *set;
+    char *xpath;
+    uint64_t value;
+    int ret;
+
+    ret = asprintf(&xpath, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions/"
+            "change-sub[priority='77']/latency/%s", name);
+    assert_int_not_equal(ret, -1);
+    ret = sr_get_data(sess, xpath, 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+
+    ret = lyd_find_xpath(data->tree, xpath, &set);
+    free(xpath);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_equal(set->count, 1);
+    value = strtoull(lyd_get_value(set->dnodes[0]), NULL, 10);
+    ly_set_free(set, NULL);
+    sr_release_data(data);
+
+    return value;
+}
+
+static void
+test_change_latency(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    int ret;
+
+    ret = sr_module_change_subscribe(st->sess, "ietf-interfaces", NULL, latency_change_cb, NULL, 77, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* no events processed yet */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(latency_get(st->sess, "event-count"), 0);
+    assert_int_equal(latency_get(st->sess, "callback-count"), 0);
+    assert_int_equal(latency_get(st->sess, "callback-time"), 0);
+    assert_int_equal(latency_get(st->sess, "max-callback-time"), 0);
+
+    /* generate "change" and "done" events */
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth-lat']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* both events were processed and the callback time measured */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(latency_get(st->sess, "event-count"), 2);
+    assert_int_equal(latency_get(st->sess, "callback-count"), 2);
+    assert_true(latency_get(st->sess, "callback-time") >= 20000);
+    assert_true(latency_get(st->sess, "max-callback-time") >= 20000);
+    assert_true(latency_get(st->sess, "max-callback-time") <= latency_get(st->sess, "callback-time"));
+
+    /* another change */
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(st->sess, "/ietf-interfaces:interfaces/interface[name='eth-lat']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(latency_get(st->sess, "event-count"), 4);
+    assert_int_equal(latency_get(st->sess, "callback-count"), 4);
+    assert_true(latency_get(st->sess, "callback-time") >= 40000);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_unsubscribe(subscr);
+}
+
 /* TEST */
 static int
 enabled_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath, sr_event_t event,
@@ -3111,6 +3300,92 @@ test_same_xpath_parallel(void **state)
     sr_unsubscribe(subscr5);
 }
 
+/* TEST */
+static int
+workers_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+    (void)parent;
+
+    /* block until the change is applied by the main thread */
+    ATOMIC_INC_RELAXED(st->cb_called);
+    pthread_barrier_wait(&st->barrier2);
+
+    return SR_ERR_OK;
+}
+
+static void *
+workers_get_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    sr_data_t *data;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_release_data(data);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_workers(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    pthread_t tid;
+    int ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* a slow state data provider and a change subscription in one subscription structure */
+    ret = sr_oper_get_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", workers_oper_cb,
+            st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(st->sess, "test", NULL, dummy_change_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_set_workers(subscr, 2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* get the state data and wait until the provider callback is blocked */
+    pthread_create(&tid, NULL, workers_get_thread, st);
+    while (!ATOMIC_LOAD_RELAXED(st->cb_called)) {
+        usleep(1000);
+    }
+
+    /* the change is processed by another worker meanwhile */
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "25", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 2000);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* unblock the provider */
+    pthread_barrier_wait(&st->barrier2);
+    pthread_join(tid, NULL);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 /* TEST */
 static int
 same_xpath_fail_successful_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
@@ -3698,12 +3973,193 @@ test_cache_diff(void **state)
     assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 6);
 }
 
+/* TEST */
+static void
+cache_diff_nested_data(const struct ly_ctx *ly_ctx, int phase, struct lyd_node **parent)
+{
+    struct lyd_node *list;
+    const char *l1[2] = {"x", "y"};
+    int i;
+
+    /* nested leaf changes in phase 1 */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, ly_ctx, "/mixed-config:test-state/test-case[name='a']/result",
+            phase ? "10" : "1", 0, parent));
+
+    /* created and deleted leaves under an unchanged list instance in phase 1 */
+    if (!phase) {
+        assert_int_equal(LY_SUCCESS, lyd_new_path(*parent, NULL, "/mixed-config:test-state/test-case[name='b']/result",
+                "2", 0, NULL));
+    } else {
+        assert_int_equal(LY_SUCCESS, lyd_new_path(*parent, NULL, "/mixed-config:test-state/test-case[name='b']/x",
+                "1.5", 0, NULL));
+    }
+
+    /* reordered state list instances in phase 2 */
+    if (phase > 1) {
+        l1[0] = "y";
+        l1[1] = "x";
+    }
+    for (i = 0; i < 2; ++i) {
+        assert_int_equal(LY_SUCCESS, lyd_new_inner(*parent, NULL, "l", 0, &list));
+        assert_int_equal(LY_SUCCESS, lyd_new_term(list, NULL, "l1", l1[i], 0, NULL));
+    }
+
+    /* unchanged state leaf-list */
+    assert_int_equal(LY_SUCCESS, lyd_new_term(*parent, NULL, "ll", "a", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_new_term(*parent, NULL, "ll", "b", 0, NULL));
+}
+
+static int
+cache_diff_nested_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = private_data;
+    const struct ly_ctx *ly_ctx;
+
+    (void)sub_id;
+    (void)request_xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "mixed-config");
+    assert_string_equal(xpath, "/mixed-config:test-state");
+    assert_non_null(parent);
+    assert_null(*parent);
+
+    ly_ctx = sr_acquire_context(sr_session_get_connection(session));
+    switch (ATOMIC_LOAD_RELAXED(st->cb_called)) {
+    case 0:
+        cache_diff_nested_data(ly_ctx, 0, parent);
+        break;
+    case 2:
+        cache_diff_nested_data(ly_ctx, 1, parent);
+        break;
+    case 4:
+    case 6:
+        cache_diff_nested_data(ly_ctx, 2, parent);
+        break;
+    default:
+        fail();
+    }
+    sr_release_context(sr_session_get_connection(session));
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static int
+cache_diff_nested_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_change_oper_t op;
+    sr_change_iter_t *iter;
+    sr_val_t *old_val, *new_val;
+    const char *path;
+    int ret, count = 0, found[3] = {0};
+
+    (void)sub_id;
+    (void)request_id;
+
+    assert_string_equal(module_name, "mixed-config");
+    assert_null(xpath);
+    assert_int_equal(event, SR_EV_DONE);
+
+    ret = sr_get_changes_iter(session, "/mixed-config:*//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    while (!sr_get_change_next(session, iter, &op, &old_val, &new_val)) {
+        path = new_val ? new_val->xpath : old_val->xpath;
+
+        switch (ATOMIC_LOAD_RELAXED(st->cb_called)) {
+        case 1:
+            /* all created */
+            assert_int_equal(op, SR_OP_CREATED);
+            break;
+        case 3:
+            /* only the changed leaves */
+            if ((op == SR_OP_MODIFIED) && !strcmp(path, "/mixed-config:test-state/test-case[name='a']/result")) {
+                assert_int_equal(old_val->data.uint32_val, 1);
+                ++found[0];
+            } else if ((op == SR_OP_CREATED) && !strcmp(path, "/mixed-config:test-state/test-case[name='b']/x")) {
+                ++found[1];
+            } else if ((op == SR_OP_DELETED) && !strcmp(path, "/mixed-config:test-state/test-case[name='b']/result")) {
+                ++found[2];
+            } else {
+                fail_msg("Unexpected change of \"%s\".", path);
+            }
+            break;
+        case 5:
+            /* only the reordered list instances */
+            assert_int_equal(strncmp(path, "/mixed-config:test-state/l[", 27), 0);
+            break;
+        default:
+            fail();
+        }
+
+        sr_free_val(old_val);
+        sr_free_val(new_val);
+        ++count;
+    }
+    sr_free_change_iter(iter);
+
+    assert_int_not_equal(count, 0);
+    if (ATOMIC_LOAD_RELAXED(st->cb_called) == 3) {
+        assert_int_equal(count, 3);
+        assert_int_equal(found[0], 1);
+        assert_int_equal(found[1], 1);
+        assert_int_equal(found[2], 1);
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_cache_diff_nested(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr1 = NULL, *subscr2 = NULL;
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* subscribe as state data provider */
+    ret = sr_oper_get_subscribe(st->sess, "mixed-config", "/mixed-config:test-state", cache_diff_nested_oper_cb,
+            st, 0, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* subscribe for oper data changes */
+    sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    ret = sr_module_change_subscribe(st->sess, "mixed-config", NULL, cache_diff_nested_change_cb, st, 0,
+            SR_SUBSCR_DONE_ONLY, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* subscribe for oper poll with diff, no thread */
+    ret = sr_oper_poll_subscribe(st->sess, "mixed-config", "/mixed-config:test-state", 1,
+            SR_SUBSCR_NO_THREAD | SR_SUBSCR_OPER_POLL_DIFF, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* update cache, the last time without any changes */
+    for (i = 0; i < 4; ++i) {
+        usleep(1000);
+        ret = sr_subscription_process_events(subscr2, NULL, NULL);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    sr_unsubscribe(subscr1);
+    sr_unsubscribe(subscr2);
+
+    /* no change callback for the last update */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 7);
+}
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_yang_lib),
         cmocka_unit_test(test_sr_mon),
+        cmocka_unit_test(test_lock_stats),
+        cmocka_unit_test(test_change_latency),
         cmocka_unit_test_teardown(test_enabled_partial, clear_up),
         cmocka_unit_test_teardown(test_simple, clear_up),
         cmocka_unit_test_teardown(test_fail, clear_up),
@@ -3724,10 +4180,12 @@ main(void)
         cmocka_unit_test_teardown(test_state_default_merge, clear_up),
         cmocka_unit_test_teardown(test_same_xpath, clear_up),
         cmocka_unit_test_teardown(test_same_xpath_parallel, clear_up),
+        cmocka_unit_test_teardown(test_workers, clear_up),
         cmocka_unit_test_teardown(test_same_xpath_fail, clear_up),
         cmocka_unit_test_teardown(test_cache, clear_up),
         cmocka_unit_test_teardown(test_cache_no_sub, clear_up),
         cmocka_unit_test_teardown(test_cache_diff, clear_up),
+        cmocka_unit_test_teardown(test_cache_diff_nested, clear_up),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
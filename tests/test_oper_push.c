@@ -228,6 +228,68 @@ test_conn_owner1(void **state)
     sr_release_data(data);
 }
 
+/* TEST */
+static void
+test_cached(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_conn_ctx_t *conn, *cache_conn;
+    sr_session_ctx_t *sess, *cache_sess;
+    struct lyd_node *node;
+    int ret;
+
+    /* create a caching connection and another connection to set the data */
+    ret = sr_connect(SR_CONN_CACHE_OPER, &cache_conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(cache_conn, SR_DS_OPERATIONAL, &cache_sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_connect(0, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* set some operational data */
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data twice, the second time they are cached */
+    ret = sr_get_node(cache_sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "iana-if-type:ethernetCsmacd");
+    sr_release_data(data);
+    ret = sr_get_node(cache_sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "iana-if-type:ethernetCsmacd");
+    sr_release_data(data);
+
+    /* change the data, the cache must be invalidated */
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:softwareLoopback", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_node(cache_sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "iana-if-type:softwareLoopback");
+    sr_release_data(data);
+
+    /* disconnect, cached operational data of the connection must not be returned */
+    sr_disconnect(conn);
+
+    ret = sr_get_data(cache_sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth1']", 0, &node);
+    assert_int_equal(ret, LY_ENOTFOUND);
+    sr_release_data(data);
+
+    sr_disconnect(cache_conn);
+}
+
 /* TEST */
 static void
 test_conn_owner2(void **state)
@@ -2367,6 +2429,7 @@ main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_teardown(test_conn_owner1, clear_up),
+        cmocka_unit_test_teardown(test_cached, clear_up),
         cmocka_unit_test_teardown(test_conn_owner2, clear_up),
         cmocka_unit_test_teardown(test_conn_owner_same_data, clear_up),
         cmocka_unit_test_teardown(test_state, clear_up),
@@ -553,6 +553,139 @@ dummy_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_n
     return SR_ERR_OK;
 }
 
+/* TEST */
+static int
+oper_multi_conn_push(sr_conn_ctx_t *conn, const char *name)
+{
+    sr_session_ctx_t *sess;
+    char path[128];
+    int ret;
+
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+
+    sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='%s']/type", name);
+    ret = sr_set_item_str(sess, path, "iana-if-type:ethernetCsmacd", NULL, 0);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+    sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='%s']/speed", name);
+    ret = sr_set_item_str(sess, path, "1024", NULL, 0);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+
+    /* the stored data are owned by the connection */
+    sr_session_stop(sess);
+    return 0;
+}
+
+static int
+oper_multi_conn_check(sr_session_ctx_t *sess, const char **names, uint32_t name_count)
+{
+    sr_data_t *data;
+    struct ly_set *set;
+    char path[128];
+    uint32_t i;
+    int ret;
+
+    ret = sr_get_data(sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+
+    /* only the expected interfaces */
+    ret = lyd_find_xpath(data->tree, "/ietf-interfaces:interfaces-state/interface", &set);
+    sr_assert_int_equal(ret, LY_SUCCESS);
+    sr_assert_int_equal(set->count, name_count);
+    ly_set_free(set, NULL);
+
+    for (i = 0; i < name_count; ++i) {
+        sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='%s']/speed", names[i]);
+        ret = lyd_find_path(data->tree, path, 0, NULL);
+        sr_assert_int_equal(ret, LY_SUCCESS);
+    }
+
+    sr_release_data(data);
+    return 0;
+}
+
+static int
+test_oper_multi_conn1(int rp, int wp)
+{
+    sr_conn_ctx_t *conn1, *conn2;
+    sr_session_ctx_t *sess;
+    const char *all_names[] = {"eth0", "eth1", "eth2", "eth3"};
+    const char *alive_names[] = {"eth0", "eth1"};
+    int ret;
+
+    /* store data using 2 connections */
+    ret = sr_connect(0, &conn1);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_connect(0, &conn2);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+    if (oper_multi_conn_push(conn1, "eth0") || oper_multi_conn_push(conn2, "eth1")) {
+        return 1;
+    }
+    ret = sr_session_start(conn1, SR_DS_OPERATIONAL, &sess);
+    sr_assert_int_equal(ret, SR_ERR_OK);
+
+    barrier(rp, wp);
+
+    /* wait for the other process to store its data */
+    barrier(rp, wp);
+
+    /* data of all the 4 connections are loaded */
+    if (oper_multi_conn_check(sess, all_names, 4)) {
+        return 1;
+    }
+
+    /* let the other process crash */
+    barrier(rp, wp);
+    sleep(1);
+
+    /* data of the 2 dead connections are removed, the rest is kept */
+    if (oper_multi_conn_check(sess, alive_names, 2)) {
+        return 1;
+    }
+
+    /* still the same when loaded again */
+    if (oper_multi_conn_check(sess, alive_names, 2)) {
+        return 1;
+    }
+
+    sr_disconnect(conn1);
+    sr_disconnect(conn2);
+    return 0;
+}
+
+static int
+test_oper_multi_conn2(int rp, int wp)
+{
+    sr_conn_ctx_t *conn1, *conn2;
+
+    /* wait for the other process to store its data */
+    barrier(rp, wp);
+
+    /* store data using 2 connections */
+    sr_assert_int_equal(sr_connect(0, &conn1), SR_ERR_OK);
+    sr_assert_int_equal(sr_connect(0, &conn2), SR_ERR_OK);
+    if (oper_multi_conn_push(conn1, "eth2") || oper_multi_conn_push(conn2, "eth3")) {
+        return 1;
+    }
+
+    barrier(rp, wp);
+
+    /* wait for the other process to read the data */
+    barrier(rp, wp);
+
+    /* avoid leaks (valgrind probably cannot keep track of leafref attributes because they are shared) */
+    ly_ctx_destroy((struct ly_ctx *)sr_acquire_context(conn1));
+    sr_release_context(conn1);
+
+    /* crash */
+    exit(0);
+
+    /* unreachable */
+    return 1;
+}
+
 static int
 test_notif_instid1(int rp, int wp)
 {
@@ -1042,6 +1175,7 @@ main(void)
         {"rpc sub", test_rpc_sub1, test_rpc_sub2, setup, teardown},
         {"rpc crash", test_rpc_crash1, test_rpc_crash2, setup, teardown},
         {"oper crash", test_oper_crash_set2, test_oper_crash_set1, setup, teardown},
+        {"oper multi conn", test_oper_multi_conn1, test_oper_multi_conn2, setup, teardown},
         {"notif instid", test_notif_instid1, test_notif_instid2, setup, teardown},
         {"pull push oper data", test_pull_push_oper1, test_pull_push_oper2, setup, teardown},
         {"context change", test_context_change, test_context_change_sub, setup, teardown},
@@ -1292,6 +1292,200 @@ test_rpc_shelve(void **state)
     pthread_join(tid[1], NULL);
 }
 
+/* TEST */
+static ATOMIC_T workers_active;
+static ATOMIC_T workers_max_active;
+
+static int
+rpc_workers_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *op_path, const struct lyd_node *input,
+        sr_event_t event, uint32_t request_id, struct lyd_node *output, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    uint32_t active;
+
+    (void)session;
+    (void)sub_id;
+    (void)op_path;
+    (void)input;
+    (void)event;
+    (void)request_id;
+
+    /* remember how many callbacks run concurrently */
+    active = ATOMIC_INC_RELAXED(workers_active) + 1;
+    if (active > ATOMIC_LOAD_RELAXED(workers_max_active)) {
+        ATOMIC_STORE_RELAXED(workers_max_active, active);
+    }
+    usleep(200000);
+    ATOMIC_DEC_RELAXED(workers_active);
+
+    /* create output data */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(output, NULL, "l5", "256", LYD_NEW_PATH_OUTPUT, NULL));
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void *
+send_rpc_workers_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    struct lyd_node *input_op;
+    sr_data_t *output_op;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* create the RPC */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:rpc3/l4", "vall", 0, &input_op));
+
+    /* send the RPC */
+    ret = sr_rpc_send_tree(sess, input_op, 0, &output_op);
+    lyd_free_all(input_op);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* check output */
+    assert_string_equal(lyd_get_value(lyd_child(output_op->tree)), "256");
+
+    sr_release_data(output_op);
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_rpc_workers(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    pthread_t tid[4];
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+    ATOMIC_STORE_RELAXED(workers_active, 0);
+    ATOMIC_STORE_RELAXED(workers_max_active, 0);
+
+    /* subscribe and process the requests with workers */
+    ret = sr_rpc_subscribe_tree(st->sess, "/ops:rpc3", rpc_workers_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_set_workers(subscr, 4);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* send the same RPC from several threads at once */
+    for (i = 0; i < 4; ++i) {
+        pthread_create(&tid[i], NULL, send_rpc_workers_thread, st);
+    }
+    for (i = 0; i < 4; ++i) {
+        pthread_join(tid[i], NULL);
+    }
+
+    /* all the requests were processed, some of them concurrently */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 4);
+    assert_true(ATOMIC_LOAD_RELAXED(workers_max_active) > 1);
+
+    /* without workers, the requests are still processed */
+    ret = sr_subscription_set_workers(subscr, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    send_rpc_workers_thread(st);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 5);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static ATOMIC_T ready_rpc2_called;
+static ATOMIC_T ready_rpc3_called;
+static ATOMIC_T ready_change_called;
+
+static int
+rpc_ready_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *op_path, const struct lyd_node *input,
+        sr_event_t event, uint32_t request_id, struct lyd_node *output, void *private_data)
+{
+    (void)session;
+    (void)sub_id;
+    (void)input;
+    (void)event;
+    (void)request_id;
+    (void)output;
+    (void)private_data;
+
+    if (!strcmp(op_path, "/ops:rpc2")) {
+        ATOMIC_INC_RELAXED(ready_rpc2_called);
+    } else {
+        assert_string_equal(op_path, "/ops:rpc3");
+        ATOMIC_INC_RELAXED(ready_rpc3_called);
+    }
+    return SR_ERR_OK;
+}
+
+static int
+module_change_ready_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+    (void)private_data;
+
+    assert_string_equal(module_name, "ops");
+    if (event == SR_EV_CHANGE) {
+        ATOMIC_INC_RELAXED(ready_change_called);
+    }
+    return SR_ERR_OK;
+}
+
+static void
+test_rpc_ready(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct lyd_node *input_op;
+    sr_data_t *output_op;
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(ready_rpc2_called, 0);
+    ATOMIC_STORE_RELAXED(ready_rpc3_called, 0);
+    ATOMIC_STORE_RELAXED(ready_change_called, 0);
+
+    /* several kinds of subscriptions in a single subscription structure */
+    ret = sr_rpc_subscribe_tree(st->sess, "/ops:rpc2", rpc_ready_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_rpc_subscribe_tree(st->sess, "/ops:rpc3", rpc_ready_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(st->sess, "ops", NULL, module_change_ready_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* only the subscriptions with an event are processed, each of them must be found */
+    for (i = 0; i < 3; ++i) {
+        assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:rpc3/l4", "vall", 0, &input_op));
+        ret = sr_rpc_send_tree(st->sess, input_op, 0, &output_op);
+        lyd_free_all(input_op);
+        assert_int_equal(ret, SR_ERR_OK);
+        sr_release_data(output_op);
+    }
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:rpc2", NULL, 0, &input_op));
+    ret = sr_rpc_send_tree(st->sess, input_op, 0, &output_op);
+    lyd_free_all(input_op);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_release_data(output_op);
+
+    ret = sr_set_item_str(st->sess, "/ops:cont/list1[k='key']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    assert_int_equal(ATOMIC_LOAD_RELAXED(ready_rpc2_called), 1);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(ready_rpc3_called), 3);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(ready_change_called), 1);
+
+    /* explicit processing without any event does not fail */
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_unsubscribe(subscr);
+}
+
 /* TEST */
 static int
 rpc_dummy_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *xpath, const sr_val_t *input, const size_t input_cnt,
@@ -1784,6 +1978,8 @@ main(void)
         cmocka_unit_test(test_action_deps),
         cmocka_unit_test_teardown(test_action_change_config, clear_ops),
         cmocka_unit_test(test_rpc_shelve),
+        cmocka_unit_test(test_rpc_workers),
+        cmocka_unit_test_teardown(test_rpc_ready, clear_ops),
         cmocka_unit_test(test_input_parameters),
         cmocka_unit_test(test_rpc_action_with_no_thread),
         cmocka_unit_test(test_rpc_oper),
@@ -0,0 +1,49 @@
+#!/bin/sh
+
+# params - path to sysrepoctl, path to sysrepocfg, path to the test files directory
+SRCTL="$1"
+SRCFG="$2"
+FILES="$3"
+TMP=`mktemp -d`
+COUNT=2500
+
+fail () {
+	echo "$1"
+	rm -rf "$TMP"
+	exit 1
+}
+
+"$SRCTL" -i "$FILES/test.yang" || fail "Failed to install \"test\" module"
+
+# generate data with more subtrees than printed in a single progress chunk
+{
+	echo "<l3 xmlns=\"urn:test\"><k>k0</k></l3>"
+	i=1
+	while [ $i -lt $COUNT ]; do
+		echo "<l3 xmlns=\"urn:test\"><k>k$i</k></l3>"
+		i=$((i+1))
+	done
+} > "$TMP/data.xml"
+
+# file input, progress printed only with verbosity
+"$SRCFG" --import="$TMP/data.xml" -d running -m test --stream 2> "$TMP/err" || fail "Stream import from a file failed"
+grep -q "parsed" "$TMP/err" && fail "Progress printed without verbosity"
+"$SRCFG" --import="$TMP/data.xml" -d running -m test --stream -v3 2> "$TMP/err" || fail "Verbose stream import failed"
+grep -q "parsed $COUNT subtrees" "$TMP/err" || fail "Progress not printed with verbosity"
+[ `"$SRCFG" -X -d running -m test -f xml | grep -c "<k>"` -eq $COUNT ] || fail "Unexpected imported data from a file"
+
+# STDIN input, replaces the previous data
+head -n 10 "$TMP/data.xml" | "$SRCFG" --import -d running -m test -f xml --stream || fail "Stream import from STDIN failed"
+[ `"$SRCFG" -X -d running -m test -f xml | grep -c "<k>"` -eq 10 ] || fail "Unexpected imported data from STDIN"
+
+# empty STDIN input
+"$SRCFG" --import -d running -m test -f xml --stream < /dev/null || fail "Empty stream import from STDIN failed"
+"$SRCFG" -X -d running -m test -f xml | grep -q "<k>" && fail "Unexpected data after an empty import"
+
+# invalid data are not stored
+echo "<l3 xmlns=\"urn:test\"><k>k0</k><unknown/></l3>" | "$SRCFG" --import -d running -m test -f xml --stream 2> /dev/null \
+	&& fail "Invalid stream import succeeded"
+
+"$SRCTL" -u test || fail "Failed to uninstall \"test\" module"
+rm -rf "$TMP"
+exit 0
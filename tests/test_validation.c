@@ -146,6 +146,20 @@ test_leafref(void **state)
     assert_string_equal(data->tree->next->next->schema->name, "cont");
 
     sr_release_data(data);
+
+    /* unrelated change in the referenced module */
+    ret = sr_set_item_str(st->sess, "/test:ll1", "-3000", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* remove the referenced node */
+    ret = sr_delete_item(st->sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
 }
 
 static void